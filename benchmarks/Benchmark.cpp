@@ -0,0 +1,263 @@
+// ----------------------------------------------------------------
+// Benchmark harness implementation and entry point
+// ----------------------------------------------------------------
+
+#include "Benchmark.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+    struct Case
+    {
+        std::string name;
+        BenchmarkFunction function;
+        int64_t arg;
+    };
+
+    struct Result
+    {
+        std::string name;
+        uint64_t iterations;
+        double nanosecondsPerIteration;
+        double itemsPerSecond;
+        std::string error;
+    };
+
+    // Function-local so registrations from any translation unit are safe
+    std::vector<Case>& GetCases()
+    {
+        static std::vector<Case> cases;
+        return cases;
+    }
+
+    const uint64_t MAX_ITERATIONS = 1000000000ULL;
+
+    Result RunCase(const Case& benchmark, double minTime)
+    {
+        Result result{ benchmark.name, 0, 0.0, 0.0, "" };
+        uint64_t iterations = 1;
+        while (true)
+        {
+            BenchmarkState state(benchmark.arg, iterations);
+            benchmark.function(state);
+            if (!state.GetError().empty())
+            {
+                result.error = state.GetError();
+                return result;
+            }
+
+            double elapsed = state.GetElapsedSeconds();
+            if (elapsed >= minTime || iterations >= MAX_ITERATIONS)
+            {
+                result.iterations = iterations;
+                result.nanosecondsPerIteration = elapsed * 1e9 / iterations;
+                if (state.GetItemsPerIteration() > 0 && elapsed > 0.0)
+                {
+                    result.itemsPerSecond = static_cast<double>(state.GetItemsPerIteration()) * iterations / elapsed;
+                }
+                return result;
+            }
+
+            // Aim a little past the minimum time, growing at most 10x per round
+            double scale = elapsed > 0.0 ? minTime * 1.4 / elapsed : 10.0;
+            scale = scale > 10.0 ? 10.0 : (scale < 2.0 ? 2.0 : scale);
+            iterations = static_cast<uint64_t>(iterations * scale);
+        }
+    }
+
+    std::string EscapeJson(const std::string& text)
+    {
+        std::string escaped;
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    bool WriteJson(const std::string& path, const std::vector<Result>& results)
+    {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file)
+        {
+            return false;
+        }
+
+        char date[64];
+        std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+
+        file << "{\n  \"context\": {\n";
+        file << "    \"date\": \"" << date << "\",\n";
+        file << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+        file << "    \"library_build_type\": \"release\"\n";
+#else
+        file << "    \"library_build_type\": \"debug\"\n";
+#endif
+        file << "  },\n  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const Result& result = results[i];
+            file << "    {\n      \"name\": \"" << EscapeJson(result.name) << "\",\n";
+            if (!result.error.empty())
+            {
+                file << "      \"error_occurred\": true,\n";
+                file << "      \"error_message\": \"" << EscapeJson(result.error) << "\"\n";
+            }
+            else
+            {
+                file << "      \"iterations\": " << result.iterations << ",\n";
+                file << "      \"real_time\": " << result.nanosecondsPerIteration << ",\n";
+                file << "      \"cpu_time\": " << result.nanosecondsPerIteration << ",\n";
+                file << "      \"time_unit\": \"ns\"";
+                if (result.itemsPerSecond > 0.0)
+                {
+                    file << ",\n      \"items_per_second\": " << result.itemsPerSecond;
+                }
+                file << "\n";
+            }
+            file << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        file << "  ]\n}\n";
+        return static_cast<bool>(file);
+    }
+}
+
+BenchmarkState::BenchmarkState(int64_t arg, uint64_t iterations)
+    : mArg(arg)
+    , mIterations(iterations)
+    , mRemaining(iterations)
+    , mStarted(false)
+    , mRunning(false)
+    , mItemsPerIteration(0)
+    , mElapsed(0.0)
+{
+}
+
+bool BenchmarkState::KeepRunning()
+{
+    if (!mStarted)
+    {
+        mStarted = true;
+        ResumeTiming();
+    }
+    if (mRemaining > 0)
+    {
+        mRemaining--;
+        return true;
+    }
+    PauseTiming();
+    return false;
+}
+
+void BenchmarkState::PauseTiming()
+{
+    if (mRunning)
+    {
+        mElapsed += Clock::now() - mStart;
+        mRunning = false;
+    }
+}
+
+void BenchmarkState::ResumeTiming()
+{
+    if (!mRunning)
+    {
+        mStart = Clock::now();
+        mRunning = true;
+    }
+}
+
+BenchmarkRegistration::BenchmarkRegistration(const char* name, BenchmarkFunction function,
+                                             std::initializer_list<int64_t> args)
+{
+    if (args.size() == 0)
+    {
+        GetCases().push_back(Case{ name, function, 0 });
+        return;
+    }
+    for (int64_t arg : args)
+    {
+        GetCases().push_back(Case{ std::string(name) + "/" + std::to_string(arg), function, arg });
+    }
+}
+
+int RunBenchmarks(int argc, char** argv)
+{
+    std::string filter;
+    std::string jsonPath = "benchmark_results.json";
+    double minTime = 0.2;
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--filter") == 0 && hasValue)
+        {
+            filter = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--min-time") == 0 && hasValue)
+        {
+            minTime = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--json") == 0 && hasValue)
+        {
+            jsonPath = argv[++i];
+        }
+        else
+        {
+            std::cout << "Usage: " << argv[0] << " [--filter substring] [--min-time seconds] [--json path]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+    std::printf("%-40s %16s %14s %16s\n", "Benchmark", "Time (ns)", "Iterations", "Items/s");
+    for (const Case& benchmark : GetCases())
+    {
+        if (!filter.empty() && benchmark.name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        Result result = RunCase(benchmark, minTime);
+        if (!result.error.empty())
+        {
+            std::printf("%-40s SKIPPED: %s\n", result.name.c_str(), result.error.c_str());
+        }
+        else
+        {
+            std::printf("%-40s %16.1f %14llu", result.name.c_str(), result.nanosecondsPerIteration,
+                        static_cast<unsigned long long>(result.iterations));
+            if (result.itemsPerSecond > 0.0)
+            {
+                std::printf(" %16.0f", result.itemsPerSecond);
+            }
+            std::printf("\n");
+        }
+        std::fflush(stdout);
+        results.push_back(result);
+    }
+
+    if (!WriteJson(jsonPath, results))
+    {
+        std::cout << "ERROR::BENCHMARK: Could not write " << jsonPath << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << results.size() << " results to " << jsonPath << std::endl;
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    return RunBenchmarks(argc, argv);
+}
@@ -0,0 +1,95 @@
+// ----------------------------------------------------------------
+// Benchmark: minimal self-contained microbenchmark harness
+//
+// Modeled on Google Benchmark so cases can move over unchanged in
+// spirit: a case is a function taking a BenchmarkState and looping
+// while KeepRunning() returns true. The runner grows the iteration
+// count until a case runs for at least the minimum time, then reports
+// nanoseconds per iteration. Results are written as JSON in Google
+// Benchmark's layout so its compare tooling can diff two runs.
+//
+//   static void BM_Something(BenchmarkState& state)
+//   {
+//       Setup(state.GetArg());
+//       while (state.KeepRunning())
+//       {
+//           DoNotOptimize(Work());
+//       }
+//   }
+//   REGISTER_BENCHMARK(BM_Something, 1000, 100000);
+// ----------------------------------------------------------------
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+class BenchmarkState
+{
+public:
+    BenchmarkState(int64_t arg, uint64_t iterations);
+
+    // True until the requested number of iterations has run; the timer
+    // starts on the first call and stops on the last
+    bool KeepRunning();
+
+    // Exclude per-iteration setup from the measurement
+    void PauseTiming();
+    void ResumeTiming();
+
+    int64_t GetArg() const { return mArg; }
+    uint64_t GetIterations() const { return mIterations; }
+    // Work units per iteration, reported as items per second
+    void SetItemsPerIteration(int64_t items) { mItemsPerIteration = items; }
+    int64_t GetItemsPerIteration() const { return mItemsPerIteration; }
+    double GetElapsedSeconds() const { return mElapsed.count(); }
+
+    // Mark a case as not runnable here (e.g. no GL context)
+    void SkipWithError(const std::string& message) { mError = message; mRemaining = 0; }
+    const std::string& GetError() const { return mError; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    int64_t mArg;
+    uint64_t mIterations;
+    uint64_t mRemaining;
+    bool mStarted;
+    bool mRunning;
+    int64_t mItemsPerIteration;
+    Clock::time_point mStart;
+    std::chrono::duration<double> mElapsed;
+    std::string mError;
+};
+
+using BenchmarkFunction = void (*)(BenchmarkState&);
+
+class BenchmarkRegistration
+{
+public:
+    // Registers one case per argument (or a single case without an argument)
+    BenchmarkRegistration(const char* name, BenchmarkFunction function, std::initializer_list<int64_t> args);
+};
+
+// Run every registered case matching the command line and write JSON.
+// Options: --filter <substring>, --min-time <seconds>, --json <path>
+int RunBenchmarks(int argc, char** argv);
+
+// Keep the compiler from discarding a value or the work producing it
+template <typename T>
+inline void DoNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void ClobberMemory()
+{
+    asm volatile("" : : : "memory");
+}
+
+#define BENCHMARK_CONCAT_INNER(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_INNER(a, b)
+#define REGISTER_BENCHMARK(function, ...) \
+    static BenchmarkRegistration BENCHMARK_CONCAT(sRegistration, __LINE__)(#function, function, { __VA_ARGS__ })
@@ -0,0 +1,411 @@
+// ----------------------------------------------------------------
+// Microbenchmarks for per-frame hot paths
+//
+// Arguments are problem sizes (actors, components, string length,
+// recipes). Expensive fixtures are built once per size and shared
+// across the runner's calibration rounds.
+// ----------------------------------------------------------------
+
+#include "Benchmark.hpp"
+#include "Math.h"
+#include "Actor/Actor.hpp"
+#include "Actor/TextActor.hpp"
+#include "Component/Component/Component.hpp"
+#include "Core/OverlapSolver/OverlapSolver.hpp"
+#include "Core/TextRenderer/TextRenderer.hpp"
+#include "Core/TweenSystem/TweenSystem.hpp"
+#include "Game/Game.hpp"
+#include "Recipe/RecipeBook.hpp"
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    Matrix4 MakeTransform(float angle)
+    {
+        return Matrix4::CreateScale(1.5f, 0.75f, 1.0f) * Matrix4::CreateRotationZ(angle) *
+               Matrix4::CreateTranslation(Vector3(120.0f, -40.0f, 0.0f));
+    }
+
+    Matrix3x2 MakeTransform2D(float angle)
+    {
+        return Matrix3x2::CreateTransform(Vector2(1.5f, 0.75f), angle, Vector2(120.0f, -40.0f));
+    }
+
+    // Hidden window + GL context so the font can create its glyph textures
+    struct GlContext
+    {
+        SDL_Window* window = nullptr;
+        SDL_GLContext context = nullptr;
+        std::unique_ptr<TextRenderer> textRenderer;
+        std::string error;
+
+        GlContext()
+        {
+            if (SDL_Init(SDL_INIT_VIDEO) != 0)
+            {
+                error = "SDL video unavailable";
+                return;
+            }
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+            window = SDL_CreateWindow("benchmarks", 0, 0, 64, 64, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+            context = window ? SDL_GL_CreateContext(window) : nullptr;
+            if (!context || glewInit() != GLEW_OK)
+            {
+                error = "no OpenGL context";
+                return;
+            }
+            textRenderer = std::make_unique<TextRenderer>();
+            if (!textRenderer->Initialize())
+            {
+                textRenderer.reset();
+                error = "no usable font";
+            }
+        }
+
+        ~GlContext()
+        {
+            textRenderer.reset();
+            if (context)
+            {
+                SDL_GL_DeleteContext(context);
+            }
+            if (window)
+            {
+                SDL_DestroyWindow(window);
+            }
+            SDL_Quit();
+        }
+    };
+
+    GlContext& GetGlContext()
+    {
+        static GlContext context;
+        return context;
+    }
+
+    std::string MakeLabel(int64_t length)
+    {
+        const char* words[] = { "Steam", "Lava", "Obsidian", "Cloud", "Mud", "Plant", "Glass", "Dust" };
+        std::string label;
+        for (size_t i = 0; label.size() < static_cast<size_t>(length); i++)
+        {
+            label += words[i % 8];
+            label += ' ';
+        }
+        label.resize(length);
+        return label;
+    }
+
+    struct RecipeFixture
+    {
+        RecipeBook book;
+        std::vector<ElementId> elements;
+    };
+
+    // Elements e0..eN with recipe (e[i], e[i+1]) = e[(i * 7) % N]
+    RecipeFixture& GetRecipeFixture(int64_t recipes)
+    {
+        static std::map<int64_t, std::unique_ptr<RecipeFixture>> fixtures;
+        std::unique_ptr<RecipeFixture>& fixture = fixtures[recipes];
+        if (!fixture)
+        {
+            fixture = std::make_unique<RecipeFixture>();
+            for (int64_t i = 0; i <= recipes; i++)
+            {
+                fixture->elements.push_back(RecipeBook::Intern("bench element " + std::to_string(i)));
+            }
+            fixture->book.Reserve(recipes);
+            for (int64_t i = 0; i < recipes; i++)
+            {
+                fixture->book.AddRecipe(fixture->elements[i], fixture->elements[i + 1],
+                                        fixture->elements[(i * 7) % recipes]);
+            }
+        }
+        return *fixture;
+    }
+}
+
+static void BM_Matrix4Multiply(BenchmarkState& state)
+{
+    Matrix4 result = Matrix4::Identity;
+    Matrix4 step = MakeTransform(0.01f);
+    while (state.KeepRunning())
+    {
+        result = result * step;
+        DoNotOptimize(result);
+    }
+}
+REGISTER_BENCHMARK(BM_Matrix4Multiply);
+
+static void BM_Matrix4Invert(BenchmarkState& state)
+{
+    Matrix4 source = MakeTransform(0.3f);
+    while (state.KeepRunning())
+    {
+        Matrix4 inverse = source;
+        inverse.Invert();
+        DoNotOptimize(inverse);
+    }
+}
+REGISTER_BENCHMARK(BM_Matrix4Invert);
+
+static void BM_Matrix3x2Multiply(BenchmarkState& state)
+{
+    Matrix3x2 result = Matrix3x2::Identity;
+    Matrix3x2 step = MakeTransform2D(0.01f);
+    while (state.KeepRunning())
+    {
+        result = result * step;
+        DoNotOptimize(result);
+    }
+}
+REGISTER_BENCHMARK(BM_Matrix3x2Multiply);
+
+static void BM_Matrix3x2Invert(BenchmarkState& state)
+{
+    Matrix3x2 source = MakeTransform2D(0.3f);
+    while (state.KeepRunning())
+    {
+        Matrix3x2 inverse = source;
+        inverse.Invert();
+        DoNotOptimize(inverse);
+    }
+}
+REGISTER_BENCHMARK(BM_Matrix3x2Invert);
+
+// Transforming GetArg() points through one matrix
+static void BM_Matrix3x2TransformPoints(BenchmarkState& state)
+{
+    Matrix3x2 transform = MakeTransform2D(0.3f);
+    std::vector<Vector2> points(state.GetArg());
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        points[i] = Vector2(static_cast<float>(i), static_cast<float>(i % 7));
+    }
+    std::vector<Vector2> out(points.size());
+    state.SetItemsPerIteration(state.GetArg());
+    while (state.KeepRunning())
+    {
+        transform.TransformPoints(points.data(), out.data(), points.size());
+        ClobberMemory();
+    }
+}
+REGISTER_BENCHMARK(BM_Matrix3x2TransformPoints, 64, 4096);
+
+static void BM_ActorGetModelMatrix(BenchmarkState& state)
+{
+    Game game;
+    Actor actor(&game);
+    actor.SetPosition(Vector2(10.0f, 20.0f));
+    actor.SetScale(Vector2(2.0f, 2.0f));
+    float angle = 0.0f;
+    while (state.KeepRunning())
+    {
+        angle += 0.001f;
+        actor.SetRotation(angle);
+        Matrix3x2 model = actor.GetModelMatrix();
+        DoNotOptimize(model);
+    }
+}
+REGISTER_BENCHMARK(BM_ActorGetModelMatrix);
+
+// Adding GetArg() components (random update orders) to a fresh actor
+static void BM_ActorAddComponent(BenchmarkState& state)
+{
+    Game game;
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> order(0, 200);
+    state.SetItemsPerIteration(state.GetArg());
+    while (state.KeepRunning())
+    {
+        state.PauseTiming();
+        auto actor = std::make_unique<Actor>(&game);
+        state.ResumeTiming();
+
+        for (int64_t i = 0; i < state.GetArg(); i++)
+        {
+            actor->AddComponent<Component>(order(rng));
+        }
+
+        state.PauseTiming();
+        actor.reset();
+        state.ResumeTiming();
+    }
+}
+REGISTER_BENCHMARK(BM_ActorAddComponent, 4, 16, 64);
+
+// Removing a random actor from a game holding GetArg() actors
+static void BM_GameRemoveActor(BenchmarkState& state)
+{
+    Game game;
+    std::vector<Actor*> actors;
+    auto spawn = [&game, &actors](int64_t i)
+    {
+        auto actor = std::make_unique<Actor>(&game);
+        actor->SetPosition(Vector2(static_cast<float>(i % 1000) * 50.0f, static_cast<float>(i / 1000) * 50.0f));
+        actors.push_back(actor.get());
+        game.AddActor(std::move(actor));
+    };
+    for (int64_t i = 0; i < state.GetArg(); i++)
+    {
+        spawn(i);
+    }
+
+    std::mt19937 rng(42);
+    while (state.KeepRunning())
+    {
+        state.PauseTiming();
+        size_t index = rng() % actors.size();
+        Actor* victim = actors[index];
+        actors[index] = actors.back();
+        actors.pop_back();
+        state.ResumeTiming();
+
+        game.RemoveActor(victim);
+
+        // Keep the population constant
+        state.PauseTiming();
+        spawn(static_cast<int64_t>(rng() % state.GetArg()));
+        state.ResumeTiming();
+    }
+}
+REGISTER_BENCHMARK(BM_GameRemoveActor, 1000, 10000, 100000);
+
+// One frame of GetArg() simultaneous scale tweens (merge shrinks)
+static void BM_TweenUpdate(BenchmarkState& state)
+{
+    Game game;
+    TweenSystem* tweens = game.GetTweens();
+    std::vector<Actor*> actors;
+    for (int64_t i = 0; i < state.GetArg(); i++)
+    {
+        auto actor = std::make_unique<Actor>(&game);
+        actor->SetPosition(Vector2(static_cast<float>(i % 100) * 50.0f, static_cast<float>(i / 100) * 50.0f));
+        actors.push_back(actor.get());
+        game.AddActor(std::move(actor));
+    }
+    // Long enough that no tween finishes while measuring
+    for (Actor* actor : actors)
+    {
+        tweens->Start(actor, TweenProperty::Scale, Vector2::Zero, 1.0e6f, Easing::InBack);
+    }
+
+    state.SetItemsPerIteration(state.GetArg());
+    while (state.KeepRunning())
+    {
+        tweens->Update(1.0f / 60.0f);
+    }
+}
+REGISTER_BENCHMARK(BM_TweenUpdate, 256, 4096);
+
+// Checking GetArg() freshly dropped tiles on a packed, already separated board
+static void BM_OverlapSolverSettled(BenchmarkState& state)
+{
+    Game game;
+    // Headless tiles get approximate extents without a font
+    game.SetHeadless(true);
+    OverlapSolver* solver = game.GetOverlapSolver();
+    std::vector<Actor*> actors;
+    for (int64_t i = 0; i < state.GetArg(); i++)
+    {
+        auto actor = std::make_unique<TextActor>(&game, "Water");
+        actor->SetPosition(Vector2(static_cast<float>(i % 100) * 70.0f, static_cast<float>(i / 100) * 30.0f));
+        actors.push_back(actor.get());
+        game.AddActor(std::move(actor));
+    }
+
+    state.SetItemsPerIteration(state.GetArg());
+    while (state.KeepRunning())
+    {
+        for (Actor* actor : actors)
+        {
+            solver->Enqueue(actor);
+        }
+        bool moved = solver->Step(0.0, 0);
+        DoNotOptimize(moved);
+    }
+}
+REGISTER_BENCHMARK(BM_OverlapSolverSettled, 256, 4096);
+
+// Glyph layout of a GetArg()-byte label (no drawing)
+static void BM_FontMeasureText(BenchmarkState& state)
+{
+    GlContext& gl = GetGlContext();
+    if (!gl.textRenderer)
+    {
+        state.SkipWithError(gl.error);
+        return;
+    }
+    std::string label = MakeLabel(state.GetArg());
+    state.SetItemsPerIteration(state.GetArg());
+    while (state.KeepRunning())
+    {
+        Rect bounds = gl.textRenderer->MeasureText(label);
+        DoNotOptimize(bounds);
+    }
+}
+REGISTER_BENCHMARK(BM_FontMeasureText, 8, 64, 512);
+
+static void BM_FontFitText(BenchmarkState& state)
+{
+    GlContext& gl = GetGlContext();
+    if (!gl.textRenderer)
+    {
+        state.SkipWithError(gl.error);
+        return;
+    }
+    std::string label = MakeLabel(state.GetArg());
+    while (state.KeepRunning())
+    {
+        size_t fit = gl.textRenderer->FitText(label, 196.0f);
+        DoNotOptimize(fit);
+    }
+}
+REGISTER_BENCHMARK(BM_FontFitText, 8, 64, 512);
+
+static void BM_RecipeBookCombineHit(BenchmarkState& state)
+{
+    RecipeFixture& fixture = GetRecipeFixture(state.GetArg());
+    std::mt19937 rng(42);
+    std::vector<uint32_t> probes(4096);
+    for (uint32_t& probe : probes)
+    {
+        probe = static_cast<uint32_t>(rng() % state.GetArg());
+    }
+
+    size_t next = 0;
+    while (state.KeepRunning())
+    {
+        uint32_t i = probes[next++ & 4095];
+        ElementId result = fixture.book.Combine(fixture.elements[i + 1], fixture.elements[i]);
+        DoNotOptimize(result);
+    }
+}
+REGISTER_BENCHMARK(BM_RecipeBookCombineHit, 1000, 100000, 1000000);
+
+static void BM_RecipeBookCombineMiss(BenchmarkState& state)
+{
+    RecipeFixture& fixture = GetRecipeFixture(state.GetArg());
+    std::mt19937 rng(42);
+    std::vector<uint32_t> probes(4096);
+    for (uint32_t& probe : probes)
+    {
+        probe = static_cast<uint32_t>(rng() % state.GetArg());
+    }
+
+    size_t next = 0;
+    while (state.KeepRunning())
+    {
+        // (e[i], e[i]) is never a recipe
+        uint32_t i = probes[next++ & 4095];
+        ElementId result = fixture.book.Combine(fixture.elements[i], fixture.elements[i]);
+        DoNotOptimize(result);
+    }
+}
+REGISTER_BENCHMARK(BM_RecipeBookCombineMiss, 1000, 100000, 1000000);
@@ -14,6 +14,13 @@ Actor::Actor(Game* game)
     , mScale(Vector2(1.0f, 1.0f))
     , mRotation(0.0f)
     , mGame(game)
+    , mSpatialHandle(-1)
+    , mAwakeIndex(-1)
+    , mWakeTime(-1.0f)
+    , mTweenSlot(-1)
+    , mSolverIndex(-1)
+    , mDrawnLive(false)
+    , mStackOrder(0)
 {
     // Game now manages Actor lifetime through smart pointers
 }
@@ -22,47 +29,136 @@ Actor::~Actor()
 {
     // Smart pointers will automatically clean up components
     mComponents.clear();
+
+    if (mSpatialHandle >= 0)
+    {
+        SpatialGrid* grid = mGame->GetSpatialGrid();
+        mGame->InvalidateArea(this, grid->GetBounds(this));
+        grid->Remove(this);
+    }
+    if (mAwakeIndex >= 0)
+    {
+        mGame->SleepActor(this);
+    }
+    if (mWakeTime >= 0.0f)
+    {
+        mGame->CancelWakeTimer(this);
+    }
+    if (mTweenSlot >= 0)
+    {
+        mGame->GetTweens()->CancelAll(this);
+    }
+    if (mSolverIndex >= 0)
+    {
+        mGame->GetOverlapSolver()->Remove(this);
+    }
 }
 
-void Actor::Update(float deltaTime)
+void Actor::SetState(ActorState state)
 {
-    if (mState == ActorState::Active)
+    if (state != mState)
     {
-        // Update all components first
-        for (auto& comp : mComponents)
+        // Only active actors are drawn
+        MarkDamaged();
+    }
+    mState = state;
+    if (state == ActorState::Active)
+    {
+        Wake();
+    }
+}
+
+void Actor::Wake()
+{
+    if (mAwakeIndex < 0 && mGame)
+    {
+        mGame->WakeActor(this);
+    }
+}
+
+void Actor::WakeAfter(float seconds)
+{
+    if (mGame)
+    {
+        mGame->WakeActorAfter(this, seconds);
+    }
+}
+
+bool Actor::IsIdle() const
+{
+    if (mState != ActorState::Active)
+    {
+        return true;
+    }
+    for (const auto& comp : mComponents)
+    {
+        if (!comp->IsIdle())
         {
-            comp->Update(deltaTime);
+            return false;
         }
-        // Then call the actor's own update
-        OnUpdate(deltaTime);
     }
+    return true;
 }
 
-void Actor::OnUpdate(float deltaTime)
+void Actor::SetPosition(const Vector2& pos)
 {
-    // Base implementation does nothing
+    mPosition = pos;
+    UpdateSpatialIndex();
+}
+
+void Actor::SetScale(const Vector2& scale)
+{
+    mScale = scale;
+    UpdateSpatialIndex();
+}
+
+void Actor::SetRotation(float rotation)
+{
+    mRotation = rotation;
+    MarkDamaged();
+}
+
+void Actor::UpdateSpatialIndex()
+{
+    if (mSpatialHandle >= 0)
+    {
+        SpatialGrid* grid = mGame->GetSpatialGrid();
+        Rect bounds = GetBounds();
+        // Both where the actor was drawn and where it will be
+        mGame->InvalidateArea(this, grid->GetBounds(this));
+        mGame->InvalidateArea(this, bounds);
+        grid->Update(this, bounds);
+    }
+}
+
+void Actor::MarkDamaged()
+{
+    if (mSpatialHandle >= 0)
+    {
+        mGame->InvalidateArea(this, GetBounds());
+    }
 }
 
-void Actor::ProcessInput(const uint8_t* keyState)
+void Actor::Update(float deltaTime)
 {
     if (mState == ActorState::Active)
     {
-        // Process input for all components first
+        // Update all components first
         for (auto& comp : mComponents)
         {
-            comp->ProcessInput(keyState);
+            comp->Update(deltaTime);
         }
-        // Then call the actor's own process input
-        OnProcessInput(keyState);
+        // Then call the actor's own update
+        OnUpdate(deltaTime);
     }
 }
 
-void Actor::OnProcessInput(const uint8_t* keyState)
+void Actor::OnUpdate(float deltaTime)
 {
     // Base implementation does nothing
 }
 
-void Actor::OnDraw(class TextRenderer* textRenderer)
+void Actor::OnDraw(class DrawList* drawList)
 {
     // Base implementation does nothing
 }
@@ -74,14 +170,19 @@ void Actor::AddComponent(std::unique_ptr<Component> c)
         [](const std::unique_ptr<Component>& a, const std::unique_ptr<Component>& b) {
             return a->GetUpdateOrder() < b->GetUpdateOrder();
         });
+    // The new component may have work to do
+    Wake();
+}
+
+Matrix3x2 Actor::GetModelMatrix() const
+{
+    return Matrix3x2::CreateTransform(mScale, mRotation, mPosition);
 }
 
-Matrix4 Actor::GetModelMatrix() const
+Rect Actor::GetBounds() const
 {
-    Matrix4 scaleMat = Matrix4::CreateScale(mScale.x, mScale.y, 1.0f);
-    Matrix4 rotMat = Matrix4::CreateRotationZ(mRotation);
-    Matrix4 transMat = Matrix4::CreateTranslation(Vector3(mPosition.x, mPosition.y, 0.0f));
-    return scaleMat * rotMat * transMat;
+    // Base actors have no visual extent
+    return Rect(mPosition, mPosition);
 }
 
 // Ordering function for components by update order
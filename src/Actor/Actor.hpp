@@ -29,24 +29,32 @@ public:
 
     // Update function called from Game (not overridable)
     void Update(float deltaTime);
-    // ProcessInput function called from Game (not overridable)
-    void ProcessInput(const uint8_t* keyState);
 
     // Position getter/setter
     const Vector2& GetPosition() const { return mPosition; }
-    void SetPosition(const Vector2& pos) { mPosition = pos; }
+    void SetPosition(const Vector2& pos);
 
     // Scale getter/setter
     const Vector2& GetScale() const { return mScale; }
-    void SetScale(const Vector2& scale) { mScale = scale; }
+    void SetScale(const Vector2& scale);
 
     // Rotation getter/setter
     float GetRotation() const { return mRotation; }
-    void SetRotation(float rotation) { mRotation = rotation; }
+    void SetRotation(float rotation);
 
-    // State getter/setter
+    // State getter/setter (becoming Active wakes the actor)
     ActorState GetState() const { return mState; }
-    void SetState(ActorState state) { mState = state; }
+    void SetState(ActorState state);
+
+    // Sleep tiers: only awake actors are updated. After each update, idle
+    // actors drop into the dormant set until something wakes them.
+    void Wake();
+    // Wake after a delay in seconds (an earlier pending wake-up is kept)
+    void WakeAfter(float seconds);
+    bool IsAwake() const { return mAwakeIndex >= 0; }
+    // True when an update would do nothing: the actor isn't active or all its
+    // components are idle. Override if OnUpdate has work of its own.
+    virtual bool IsIdle() const;
 
     // Get Forward vector
     Vector2 GetForward() const
@@ -54,8 +62,10 @@ public:
         return Vector2(Math::Sin(mRotation), -Math::Cos(mRotation));
     }
 
-    // Model matrix
-    Matrix4 GetModelMatrix() const;
+    // Model matrix (scale, rotate, then translate)
+    Matrix3x2 GetModelMatrix() const;
+    // World-space bounds used for visibility culling (overridable)
+    virtual Rect GetBounds() const;
     // Game getter
     class Game* GetGame() { return mGame; }
 
@@ -88,16 +98,21 @@ public:
         return ptr;
     }
 
-    // Drawing method for rendering
-    virtual void OnDraw(class TextRenderer* textRenderer);
+    // Describe how the actor looks this frame (runs on the simulation
+    // thread; the render thread draws the list later)
+    virtual void OnDraw(class DrawList* drawList);
 
 protected:
     class Game* mGame;
 
     // Any actor-specific update code (overridable)
     virtual void OnUpdate(float deltaTime);
-    // Any actor-specific update code (overridable)
-    virtual void OnProcessInput(const uint8_t* keyState);
+
+    // Refresh this actor's entry in the game's spatial index after its bounds
+    // change (also marks the old and new area for redraw)
+    void UpdateSpatialIndex();
+    // Redraw this actor's area next frame (call when its look changes)
+    void MarkDamaged();
 
     // Actor's state
     ActorState mState;
@@ -112,6 +127,25 @@ protected:
 
 private:
     friend class Component;
+    friend class SpatialGrid;
+    friend class Game;
+    friend class TweenSystem;
+    friend class OverlapSolver;
+
+    // Slot in the game's spatial grid (-1 when not indexed)
+    int mSpatialHandle;
+    // Slot in the game's update list (-1 while dormant)
+    int mAwakeIndex;
+    // Game time of the scheduled wake-up (negative when none)
+    float mWakeTime;
+    // Slot in the game's tween system (-1 when not animated)
+    int mTweenSlot;
+    // Slot in the overlap solver's restless list (-1 when at rest)
+    int mSolverIndex;
+    // Drawn on top of the static layer instead of cached in it (set by Game)
+    bool mDrawnLive;
+    // Stacking position: higher is drawn above and picked first (set by Game)
+    uint64_t mStackOrder;
 
     // Adds component to Actor (this is automatically called
     // in the component constructor)
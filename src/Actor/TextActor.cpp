@@ -1,18 +1,89 @@
 #include "TextActor.hpp"
 #include "../Core/TextRenderer/TextRenderer.hpp"
+#include "../Core/RenderThread/FrameSnapshot.hpp"
 #include "../Game/Game.hpp"
+#include "../Component/DragComponent/DragComponent.hpp"
 
 TextActor::TextActor(class Game* game, const std::string& text)
+    : TextActor(game, StringTable::Get().Intern(text))
+{
+}
+
+TextActor::TextActor(class Game* game, NameId name)
     : Actor(game)
-    , mText(text)
+    , mName(name)
+    , mIsPending(false)
+    , mIsRetiring(false)
+{
+    AddComponent<DragComponent>();
+    UpdateExtents();
+}
+
+void TextActor::SetText(const std::string& text)
 {
+    SetName(StringTable::Get().Intern(text));
 }
 
-void TextActor::OnDraw(class TextRenderer* textRenderer)
+void TextActor::SetName(NameId name)
 {
+    mName = name;
+    UpdateExtents();
+}
+
+void TextActor::SetPending(bool pending)
+{
+    if (pending != mIsPending)
+    {
+        // Drawn dimmed while pending
+        mIsPending = pending;
+        MarkDamaged();
+    }
+}
+
+Rect TextActor::GetBounds() const
+{
+    // Scaled about the text's center so tiles grow and shrink in place
+    Vector2 center = GetPosition() + mExtents.GetCenter();
+    Vector2 halfSize = mExtents.GetSize() * 0.5f * GetScale();
+    return Rect(center - halfSize, center + halfSize);
+}
+
+Rect TextActor::GetLayoutBounds() const
+{
+    Vector2 pos = GetPosition();
+    return Rect(pos + mExtents.min, pos + mExtents.max);
+}
+
+void TextActor::UpdateExtents()
+{
+    TextRenderer* textRenderer = mGame ? mGame->GetTextRenderer() : nullptr;
     if (textRenderer)
     {
-        Vector2 pos = GetPosition();
-        textRenderer->RenderText(mText, pos.x, pos.y, 1.0f);
+        mExtents = textRenderer->MeasureText(GetText());
+    }
+    else if (mGame && mGame->IsHeadless())
+    {
+        // No font without a GL context; approximate a monospace line so
+        // headless tiles can still be picked and dropped onto each other
+        float width = HEADLESS_CHAR_WIDTH * static_cast<float>(GetText().size());
+        mExtents = Rect(Vector2(0.0f, -HEADLESS_DESCENT), Vector2(width, HEADLESS_LINE_HEIGHT - HEADLESS_DESCENT));
+    }
+    else
+    {
+        mExtents = Rect(Vector2::Zero, Vector2::Zero);
+    }
+    UpdateSpatialIndex();
+}
+
+void TextActor::OnDraw(class DrawList* drawList)
+{
+    if (drawList)
+    {
+        // Move the pen so the text scales about its center
+        float scale = GetScale().x;
+        Vector2 pos = GetPosition() + mExtents.GetCenter() * (1.0f - scale);
+        // Pending tiles are dimmed until their combination resolves
+        Vector3 color = mIsPending ? Vector3(0.5f, 0.5f, 0.5f) : Vector3(1.0f, 1.0f, 1.0f);
+        drawList->AddLabel(mName, mExtents, pos, scale, color);
     }
 }
\ No newline at end of file
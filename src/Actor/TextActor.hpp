@@ -1,18 +1,46 @@
 #pragma once
 #include "../Actor/Actor.hpp"
+#include "../Core/StringTable/StringTable.hpp"
 #include <string>
+#include <string_view>
 
 class TextActor : public Actor
 {
 public:
     TextActor(class Game* game, const std::string& text);
+    TextActor(class Game* game, NameId name);
     
-    void SetText(const std::string& text) { mText = text; }
-    const std::string& GetText() const { return mText; }
+    // Text is stored as an interned name ID; equal texts share one copy
+    void SetText(const std::string& text);
+    void SetName(NameId name);
+    NameId GetName() const { return mName; }
+    std::string_view GetText() const { return StringTable::Get().GetString(mName); }
+
+    // Pending tiles are waiting for a combination result and can't be picked up
+    void SetPending(bool pending);
+    bool IsPending() const { return mIsPending; }
+    // Merged away and shrinking out; destroyed when the animation ends
+    void SetRetiring(bool retiring) { mIsRetiring = retiring; }
+    bool IsRetiring() const { return mIsRetiring; }
+
+    Rect GetBounds() const override;
+    // Bounds at scale 1, used for layout so animations don't shove neighbors
+    Rect GetLayoutBounds() const;
     
 protected:
-    void OnDraw(class TextRenderer* textRenderer) override;
+    void OnDraw(class DrawList* drawList) override;
     
 private:
-    std::string mText;
-};
\ No newline at end of file
+    void UpdateExtents();
+
+    // Stand-in glyph metrics for headless runs
+    static constexpr float HEADLESS_CHAR_WIDTH = 12.0f;
+    static constexpr float HEADLESS_LINE_HEIGHT = 24.0f;
+    static constexpr float HEADLESS_DESCENT = 6.0f;
+
+    NameId mName;
+    bool mIsPending;
+    bool mIsRetiring;
+    // Text extents relative to the pen origin, cached on text change
+    Rect mExtents;
+};
@@ -20,10 +20,6 @@ void Component::Update(float deltaTime)
 {
 }
 
-void Component::ProcessInput(const uint8_t* keyState)
-{
-}
-
 class Game* Component::GetGame() const
 {
     return mOwner->GetGame();
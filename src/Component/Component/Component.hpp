@@ -15,8 +15,9 @@ public:
     virtual ~Component();
     // Update this component by delta time
     virtual void Update(float deltaTime);
-    // Process input for this component (if needed)
-    virtual void ProcessInput(const uint8_t* keyState);
+    // Components that override Update return false while it has work to do;
+    // an actor whose components are all idle stops being updated
+    virtual bool IsIdle() const { return true; }
 
     int GetUpdateOrder() const { return mUpdateOrder; }
     class Actor* GetOwner() const { return mOwner; }
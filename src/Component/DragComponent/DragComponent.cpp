@@ -0,0 +1,67 @@
+// ----------------------------------------------------------------
+// DragComponent implementation
+// ----------------------------------------------------------------
+
+#include "DragComponent.hpp"
+#include "../../Actor/Actor.hpp"
+#include "../../Core/EventBus/Events.hpp"
+#include "../../Game/Game.hpp"
+
+DragComponent::DragComponent(Actor* owner, int updateOrder)
+    : Component(owner, updateOrder)
+    , mIsDragging(false)
+    , mGrabOffset(Vector2::Zero)
+    , mMoveSubscription(EventBus::INVALID_SUBSCRIPTION)
+    , mUpSubscription(EventBus::INVALID_SUBSCRIPTION)
+{
+}
+
+DragComponent::~DragComponent()
+{
+    EndDrag();
+}
+
+void DragComponent::BeginDrag(const Vector2& grabPoint)
+{
+    mGrabOffset = grabPoint - mOwner->GetPosition();
+    if (mIsDragging)
+    {
+        return;
+    }
+    mIsDragging = true;
+    mOwner->Wake();
+    // A picked-up tile is carried above the rest and stays there when dropped
+    GetGame()->RaiseActor(mOwner);
+
+    EventBus* bus = GetGame()->GetEventBus();
+    mMoveSubscription = bus->Subscribe<MouseMoveEvent>([this](const MouseMoveEvent& event)
+    {
+        mOwner->SetPosition(event.worldPosition - mGrabOffset);
+        GetGame()->OnActorDragged(mOwner);
+    });
+    mUpSubscription = bus->Subscribe<MouseUpEvent>([this](const MouseUpEvent& event)
+    {
+        if (event.button != SDL_BUTTON_LEFT)
+        {
+            return;
+        }
+        mOwner->SetPosition(event.worldPosition - mGrabOffset);
+        EndDrag();
+        GetGame()->GetEventBus()->Publish(DropEvent{ mOwner });
+    });
+}
+
+void DragComponent::EndDrag()
+{
+    if (!mIsDragging)
+    {
+        return;
+    }
+    mIsDragging = false;
+
+    EventBus* bus = GetGame()->GetEventBus();
+    bus->Unsubscribe(mMoveSubscription);
+    bus->Unsubscribe(mUpSubscription);
+    mMoveSubscription = EventBus::INVALID_SUBSCRIPTION;
+    mUpSubscription = EventBus::INVALID_SUBSCRIPTION;
+}
@@ -0,0 +1,33 @@
+// ----------------------------------------------------------------
+// DragComponent: lets the mouse pick up and move its owner actor
+//
+// Listens for mouse events only while a drag is in progress, so idle
+// tiles cost nothing per frame. The owner stays awake for the drag, so it
+// is drawn live instead of rebaking the static layer under it each move.
+// ----------------------------------------------------------------
+
+#pragma once
+#include "../Component/Component.hpp"
+#include "../../Core/EventBus/EventBus.hpp"
+#include "../../Math.h"
+
+class DragComponent : public Component
+{
+public:
+    DragComponent(class Actor* owner, int updateOrder = 10);
+    ~DragComponent();
+
+    // Start following the mouse; grabPoint is the world point that was clicked
+    void BeginDrag(const Vector2& grabPoint);
+    bool IsDragging() const { return mIsDragging; }
+    bool IsIdle() const override { return !mIsDragging; }
+
+private:
+    void EndDrag();
+
+    bool mIsDragging;
+    // Offset from the owner's position to the grabbed point
+    Vector2 mGrabOffset;
+    EventBus::SubscriptionId mMoveSubscription;
+    EventBus::SubscriptionId mUpSubscription;
+};
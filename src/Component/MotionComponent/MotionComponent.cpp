@@ -0,0 +1,40 @@
+// ----------------------------------------------------------------
+// MotionComponent implementation
+// ----------------------------------------------------------------
+
+#include "MotionComponent.hpp"
+#include "../../Actor/Actor.hpp"
+
+MotionComponent::MotionComponent(Actor* owner, const Vector2& velocity, const Rect& bounds, int updateOrder)
+    : Component(owner, updateOrder)
+    , mVelocity(velocity)
+    , mBounds(bounds)
+{
+}
+
+void MotionComponent::SetVelocity(const Vector2& velocity)
+{
+    mVelocity = velocity;
+    if (!IsIdle())
+    {
+        mOwner->Wake();
+    }
+}
+
+void MotionComponent::Update(float deltaTime)
+{
+    Vector2 position = mOwner->GetPosition() + mVelocity * deltaTime;
+
+    // Reflect off the edges so the population stays inside the area
+    if (position.x < mBounds.min.x || position.x > mBounds.max.x)
+    {
+        mVelocity.x = -mVelocity.x;
+        position.x = Math::Clamp(position.x, mBounds.min.x, mBounds.max.x);
+    }
+    if (position.y < mBounds.min.y || position.y > mBounds.max.y)
+    {
+        mVelocity.y = -mVelocity.y;
+        position.y = Math::Clamp(position.y, mBounds.min.y, mBounds.max.y);
+    }
+    mOwner->SetPosition(position);
+}
@@ -0,0 +1,26 @@
+// ----------------------------------------------------------------
+// MotionComponent: constant-velocity drift inside a bounding area
+// ----------------------------------------------------------------
+
+#pragma once
+#include "../Component/Component.hpp"
+#include "../../Math.h"
+
+class MotionComponent : public Component
+{
+public:
+    // Runs before drawing but after dragging (updateOrder 10) has moved the owner
+    MotionComponent(class Actor* owner, const Vector2& velocity, const Rect& bounds, int updateOrder = 50);
+
+    void Update(float deltaTime) override;
+    bool IsIdle() const override { return mVelocity.x == 0.0f && mVelocity.y == 0.0f; }
+
+    const Vector2& GetVelocity() const { return mVelocity; }
+    // Wakes the owner when it starts moving
+    void SetVelocity(const Vector2& velocity);
+
+private:
+    Vector2 mVelocity;
+    // The owner bounces off the edges of this area
+    Rect mBounds;
+};
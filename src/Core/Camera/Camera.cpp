@@ -0,0 +1,84 @@
+// ----------------------------------------------------------------
+// Camera implementation
+// ----------------------------------------------------------------
+
+#include "Camera.hpp"
+
+Camera::Camera()
+    : mViewportWidth(1)
+    , mViewportHeight(1)
+    , mPosition(Vector2::Zero)
+    , mZoom(1.0f)
+{
+    RecomputeMatrices();
+}
+
+void Camera::SetViewportSize(int width, int height)
+{
+    mViewportWidth = Math::Max(width, 1);
+    mViewportHeight = Math::Max(height, 1);
+    RecomputeMatrices();
+}
+
+void Camera::SetPosition(const Vector2& pos)
+{
+    mPosition = pos;
+    RecomputeMatrices();
+}
+
+void Camera::SetZoom(float zoom)
+{
+    mZoom = Math::Clamp(zoom, MIN_ZOOM, MAX_ZOOM);
+    RecomputeMatrices();
+}
+
+void Camera::Pan(const Vector2& screenDelta)
+{
+    // Screen y grows downwards, world y grows upwards
+    mPosition.x -= screenDelta.x / mZoom;
+    mPosition.y += screenDelta.y / mZoom;
+    RecomputeMatrices();
+}
+
+void Camera::ZoomAt(const Vector2& screenPoint, float factor)
+{
+    Vector2 before = ScreenToWorld(screenPoint);
+    mZoom = Math::Clamp(mZoom * factor, MIN_ZOOM, MAX_ZOOM);
+    RecomputeMatrices();
+
+    // Shift so that the same world point stays under the cursor
+    Vector2 after = ScreenToWorld(screenPoint);
+    mPosition += before - after;
+    RecomputeMatrices();
+}
+
+Vector2 Camera::ScreenToWorld(const Vector2& screenPoint) const
+{
+    return Vector2(
+        mPosition.x + (screenPoint.x - mViewportWidth * 0.5f) / mZoom,
+        mPosition.y + (mViewportHeight * 0.5f - screenPoint.y) / mZoom);
+}
+
+Vector2 Camera::WorldToScreen(const Vector2& worldPoint) const
+{
+    return Vector2(
+        (worldPoint.x - mPosition.x) * mZoom + mViewportWidth * 0.5f,
+        mViewportHeight * 0.5f - (worldPoint.y - mPosition.y) * mZoom);
+}
+
+void Camera::RecomputeMatrices()
+{
+    float width = static_cast<float>(mViewportWidth);
+    float height = static_cast<float>(mViewportHeight);
+
+    Vector2 halfExtents(width * 0.5f / mZoom, height * 0.5f / mZoom);
+    mVisibleRect = Rect(mPosition - halfExtents, mPosition + halfExtents);
+
+    // Row-vector convention: translate to camera, zoom, then project
+    mViewProjection = Matrix3x2::CreateTranslation(Vector2(-mPosition.x, -mPosition.y)) *
+                      Matrix3x2::CreateScale(mZoom) *
+                      Matrix3x2::CreateOrtho(width, height);
+
+    mScreenProjection = Matrix3x2::CreateTranslation(Vector2(-width * 0.5f, -height * 0.5f)) *
+                        Matrix3x2::CreateOrtho(width, height);
+}
@@ -0,0 +1,57 @@
+// ----------------------------------------------------------------
+// 2D camera: pannable/zoomable orthographic view over the board
+// ----------------------------------------------------------------
+
+#pragma once
+#include "../../Math.h"
+
+class Camera
+{
+public:
+    Camera();
+
+    // Viewport (window drawable) size in pixels
+    void SetViewportSize(int width, int height);
+    int GetViewportWidth() const { return mViewportWidth; }
+    int GetViewportHeight() const { return mViewportHeight; }
+
+    // World point shown at the center of the viewport
+    const Vector2& GetPosition() const { return mPosition; }
+    void SetPosition(const Vector2& pos);
+
+    // Zoom factor (screen pixels per world unit)
+    float GetZoom() const { return mZoom; }
+    void SetZoom(float zoom);
+
+    // Move the view by a delta given in screen pixels
+    void Pan(const Vector2& screenDelta);
+    // Multiply zoom by factor, keeping the world point under screenPoint fixed
+    void ZoomAt(const Vector2& screenPoint, float factor);
+
+    // Convert between SDL window coordinates (y down) and world coordinates (y up)
+    Vector2 ScreenToWorld(const Vector2& screenPoint) const;
+    Vector2 WorldToScreen(const Vector2& worldPoint) const;
+
+    // World-space rectangle currently visible
+    const Rect& GetVisibleRect() const { return mVisibleRect; }
+
+    // Combined view-projection matrix (world -> clip space)
+    const Matrix3x2& GetViewProjection() const { return mViewProjection; }
+    // Projection for screen-space UI (pixels, origin at bottom-left)
+    const Matrix3x2& GetScreenProjection() const { return mScreenProjection; }
+
+    static constexpr float MIN_ZOOM = 0.05f;
+    static constexpr float MAX_ZOOM = 8.0f;
+
+private:
+    void RecomputeMatrices();
+
+    int mViewportWidth;
+    int mViewportHeight;
+    Vector2 mPosition;
+    float mZoom;
+
+    Rect mVisibleRect;
+    Matrix3x2 mViewProjection;
+    Matrix3x2 mScreenProjection;
+};
@@ -0,0 +1,43 @@
+// ----------------------------------------------------------------
+// DamageTracker implementation
+// ----------------------------------------------------------------
+
+#include "DamageTracker.hpp"
+
+DamageTracker::DamageTracker()
+    : mView(Vector2::Zero, Vector2::Zero)
+    , mHasView(false)
+    , mDamaged(true)
+{
+}
+
+void DamageTracker::SetView(const Rect& visibleWorld)
+{
+    bool changed = !mHasView || visibleWorld.min.x != mView.min.x || visibleWorld.min.y != mView.min.y ||
+                   visibleWorld.max.x != mView.max.x || visibleWorld.max.y != mView.max.y;
+    if (changed)
+    {
+        mView = visibleWorld;
+        mHasView = true;
+        InvalidateAll();
+    }
+}
+
+void DamageTracker::AddWorld(const Rect& bounds)
+{
+    // Off-screen changes don't show; if the view moves, the frame is redrawn anyway
+    if (!mHasView || bounds.Intersects(mView))
+    {
+        mDamaged = true;
+    }
+}
+
+void DamageTracker::InvalidateAll()
+{
+    mDamaged = true;
+}
+
+void DamageTracker::Clear()
+{
+    mDamaged = false;
+}
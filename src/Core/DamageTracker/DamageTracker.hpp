@@ -0,0 +1,39 @@
+// ----------------------------------------------------------------
+// DamageTracker: whether anything on screen changed since the last
+// drawn frame
+//
+// Actors report the world-space bounds they were and will be drawn
+// at when they move, resize, appear, disappear or change look; UI
+// invalidates the frame directly. Board changes outside the view of
+// the last frame are ignored, and a changed view damages the frame.
+//
+// A frame with no damage looks exactly like the previous one, so the
+// game skips drawing it. Damaged frames are redrawn in full.
+// ----------------------------------------------------------------
+
+#pragma once
+#include "../../Math.h"
+
+class DamageTracker
+{
+public:
+    DamageTracker();
+
+    // Board area shown by the frame about to be drawn
+    void SetView(const Rect& visibleWorld);
+
+    // Board contents changed inside these world bounds
+    void AddWorld(const Rect& bounds);
+    // Redraw (UI changed, window resized or exposed)
+    void InvalidateAll();
+
+    bool IsDamaged() const { return mDamaged; }
+
+    // The frame was redrawn
+    void Clear();
+
+private:
+    Rect mView;
+    bool mHasView;
+    bool mDamaged;
+};
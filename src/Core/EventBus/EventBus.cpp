@@ -0,0 +1,63 @@
+// ----------------------------------------------------------------
+// EventBus implementation
+// ----------------------------------------------------------------
+
+#include "EventBus.hpp"
+#include <iostream>
+
+EventBus::EventBus()
+    : mNextHandlerId(0)
+    , mDispatching(false)
+{
+}
+
+EventBus::~EventBus()
+{
+}
+
+uint32_t EventBus::NextTypeIndex()
+{
+    static uint32_t next = 0;
+    return next++;
+}
+
+void EventBus::Unsubscribe(SubscriptionId subscription)
+{
+    uint32_t type = static_cast<uint32_t>(subscription >> 32);
+    if (type == 0 || type > mChannels.size() || !mChannels[type - 1])
+    {
+        return;
+    }
+    mChannels[type - 1]->Remove(static_cast<uint32_t>(subscription));
+}
+
+void EventBus::Dispatch()
+{
+    // A handler calling Dispatch() again would deliver events out of order
+    if (mDispatching)
+    {
+        return;
+    }
+    mDispatching = true;
+
+    // mOrder may grow while handlers run, so index rather than iterate
+    size_t count = 0;
+    for (; count < mOrder.size() && count < MAX_EVENTS_PER_DISPATCH; count++)
+    {
+        mOrder[count]->DeliverNext();
+    }
+    if (count < mOrder.size())
+    {
+        std::cout << "ERROR::EVENTBUS: Dropped " << mOrder.size() - count << " events (publish loop?)" << std::endl;
+    }
+
+    mOrder.clear();
+    for (std::unique_ptr<ChannelBase>& channel : mChannels)
+    {
+        if (channel)
+        {
+            channel->Reset();
+        }
+    }
+    mDispatching = false;
+}
@@ -0,0 +1,187 @@
+// ----------------------------------------------------------------
+// EventBus: typed, batched event dispatch
+//
+// Events are plain structs (see Events.hpp). Publish() only queues the
+// event, and only if its type has subscribers; Dispatch() then
+// delivers the frame's events in publish order, each to the handlers
+// subscribed to its type. Input cost follows the number of interested
+// listeners instead of the number of actors on the board.
+//
+// Handlers may publish, subscribe and unsubscribe (themselves
+// included) while being dispatched. Events they publish are delivered
+// in the same Dispatch() call, and new subscribers see every event
+// after the one being delivered. Main thread only.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class EventBus
+{
+public:
+    using SubscriptionId = uint64_t;
+    static constexpr SubscriptionId INVALID_SUBSCRIPTION = 0;
+
+    EventBus();
+    ~EventBus();
+
+    template <typename T>
+    SubscriptionId Subscribe(std::function<void(const T&)> handler)
+    {
+        Channel<T>& channel = GetChannel<T>();
+        uint32_t id = ++mNextHandlerId;
+        if (channel.delivering)
+        {
+            channel.added.push_back(Handler<T>{ id, true, std::move(handler) });
+        }
+        else
+        {
+            channel.handlers.push_back(Handler<T>{ id, true, std::move(handler) });
+        }
+        channel.subscriberCount++;
+        return (static_cast<SubscriptionId>(GetTypeIndex<T>() + 1) << 32) | id;
+    }
+
+    // Safe to call from inside a handler; unknown ids are ignored
+    void Unsubscribe(SubscriptionId subscription);
+
+    template <typename T>
+    void Publish(const T& event)
+    {
+        uint32_t type = GetTypeIndex<T>();
+        if (type >= mChannels.size() || !mChannels[type] || mChannels[type]->subscriberCount == 0)
+        {
+            return;
+        }
+        Channel<T>& channel = static_cast<Channel<T>&>(*mChannels[type]);
+        channel.queue.push_back(event);
+        mOrder.push_back(&channel);
+    }
+
+    template <typename T>
+    bool HasSubscribers() const
+    {
+        uint32_t type = GetTypeIndex<T>();
+        return type < mChannels.size() && mChannels[type] && mChannels[type]->subscriberCount > 0;
+    }
+
+    // Deliver everything queued so far (and anything published meanwhile)
+    void Dispatch();
+
+    // Upper bound on events delivered by one Dispatch(), so handlers that
+    // keep publishing each other's events can't hang the frame
+    static constexpr size_t MAX_EVENTS_PER_DISPATCH = 1 << 16;
+
+private:
+    struct ChannelBase
+    {
+        virtual ~ChannelBase() = default;
+        virtual void DeliverNext() = 0;
+        virtual bool Remove(uint32_t id) = 0;
+        // Drop delivered events and removed handlers
+        virtual void Reset() = 0;
+
+        size_t subscriberCount = 0;
+        bool delivering = false;
+    };
+
+    template <typename T>
+    struct Handler
+    {
+        uint32_t id;
+        bool active;
+        std::function<void(const T&)> function;
+    };
+
+    template <typename T>
+    struct Channel : ChannelBase
+    {
+        std::vector<T> queue;
+        size_t next = 0;
+        std::vector<Handler<T>> handlers;
+        // Subscribed while delivering; merged after the current event
+        std::vector<Handler<T>> added;
+
+        void DeliverNext() override
+        {
+            // Copied out: handlers may publish more T and grow the queue
+            T event = queue[next++];
+            delivering = true;
+            for (Handler<T>& handler : handlers)
+            {
+                if (handler.active)
+                {
+                    handler.function(event);
+                }
+            }
+            delivering = false;
+            for (Handler<T>& handler : added)
+            {
+                handlers.push_back(std::move(handler));
+            }
+            added.clear();
+        }
+
+        bool Remove(uint32_t id) override
+        {
+            for (std::vector<Handler<T>>* list : { &handlers, &added })
+            {
+                for (Handler<T>& handler : *list)
+                {
+                    if (handler.id == id && handler.active)
+                    {
+                        // Only flagged: the handler may be the one running
+                        handler.active = false;
+                        subscriberCount--;
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        void Reset() override
+        {
+            queue.clear();
+            next = 0;
+            handlers.erase(std::remove_if(handlers.begin(), handlers.end(),
+                                          [](const Handler<T>& handler) { return !handler.active; }),
+                           handlers.end());
+        }
+    };
+
+    static uint32_t NextTypeIndex();
+
+    template <typename T>
+    static uint32_t GetTypeIndex()
+    {
+        static const uint32_t index = NextTypeIndex();
+        return index;
+    }
+
+    template <typename T>
+    Channel<T>& GetChannel()
+    {
+        uint32_t type = GetTypeIndex<T>();
+        if (type >= mChannels.size())
+        {
+            mChannels.resize(type + 1);
+        }
+        if (!mChannels[type])
+        {
+            mChannels[type] = std::make_unique<Channel<T>>();
+        }
+        return static_cast<Channel<T>&>(*mChannels[type]);
+    }
+
+    // Indexed by event type
+    std::vector<std::unique_ptr<ChannelBase>> mChannels;
+    // Channel of each queued event, in publish order
+    std::vector<ChannelBase*> mOrder;
+    uint32_t mNextHandlerId;
+    bool mDispatching;
+};
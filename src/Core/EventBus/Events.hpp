@@ -0,0 +1,63 @@
+// ----------------------------------------------------------------
+// Events published on the game's EventBus
+// ----------------------------------------------------------------
+
+#pragma once
+#include "../../Math.h"
+#include "../../Recipe/RecipeBook.hpp"
+#include "../TweenSystem/TweenSystem.hpp"
+
+// Mouse button pressed or released over the board or the sidebar
+struct MouseButtonEvent
+{
+    Vector2 screenPosition;
+    Vector2 worldPosition;
+    // SDL_BUTTON_LEFT, SDL_BUTTON_RIGHT, ...
+    int button;
+};
+
+struct MouseDownEvent : MouseButtonEvent
+{
+};
+
+struct MouseUpEvent : MouseButtonEvent
+{
+};
+
+// At most one per frame: published when the pointer moved on screen or
+// the board moved under it (pan, zoom)
+struct MouseMoveEvent
+{
+    Vector2 screenPosition;
+    Vector2 worldPosition;
+    // Screen-space motion accumulated over the frame
+    Vector2 screenDelta;
+};
+
+// A dragged tile was released
+struct DropEvent
+{
+    class Actor* dropped;
+};
+
+// A background generation finished; result is INVALID_ELEMENT on failure
+struct CombinationResolvedEvent
+{
+    ElementId a;
+    ElementId b;
+    ElementId result;
+};
+
+// A tween ran to completion (cancelled or replaced tweens don't report)
+struct TweenFinishedEvent
+{
+    TweenId id;
+    class Actor* target;
+    TweenProperty property;
+};
+
+// An element reached the board for the first time
+struct ElementDiscoveredEvent
+{
+    ElementId name;
+};
@@ -0,0 +1,303 @@
+// ----------------------------------------------------------------
+// InputSystem implementation
+// ----------------------------------------------------------------
+
+#include "InputSystem.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+InputSystem::InputSystem()
+    : mMode(Mode::Live)
+    , mFrame(0)
+    , mFrameLimit(0)
+    , mFinished(false)
+    , mStartTicks(0)
+    , mMouseX(0)
+    , mMouseY(0)
+    , mMouseButtons(0)
+    , mRecordedMouseX(0)
+    , mRecordedMouseY(0)
+    , mRecordedMouseButtons(0)
+    , mReplayOffset(0)
+    , mReplayFrames(0)
+{
+    std::memset(mKeyState, 0, sizeof(mKeyState));
+    std::memset(mRecordedKeyState, 0, sizeof(mRecordedKeyState));
+}
+
+size_t InputSystem::GetEventSize(uint32_t type)
+{
+    // Only the events the game reacts to; each struct starts at the union's base
+    switch (type)
+    {
+        case SDL_QUIT:
+            return sizeof(Uint32);
+        case SDL_WINDOWEVENT:
+            return sizeof(SDL_WindowEvent);
+        case SDL_KEYDOWN:
+        case SDL_KEYUP:
+            return sizeof(SDL_KeyboardEvent);
+        case SDL_TEXTINPUT:
+            return sizeof(SDL_TextInputEvent);
+        case SDL_MOUSEMOTION:
+            return sizeof(SDL_MouseMotionEvent);
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP:
+            return sizeof(SDL_MouseButtonEvent);
+        case SDL_MOUSEWHEEL:
+            return sizeof(SDL_MouseWheelEvent);
+        default:
+            return 0;
+    }
+}
+
+bool InputSystem::StartRecording(const std::string& path)
+{
+    mLog.open(path, std::ios::binary | std::ios::trunc);
+    if (!mLog)
+    {
+        std::cout << "ERROR::INPUT: Could not create " << path << std::endl;
+        return false;
+    }
+
+    LogHeader header{ MAGIC, VERSION, static_cast<uint32_t>(sizeof(SDL_Event)), 0 };
+    mLog.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    mMode = Mode::Record;
+    return true;
+}
+
+bool InputSystem::StartReplay(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        std::cout << "ERROR::INPUT: Could not open " << path << std::endl;
+        return false;
+    }
+    mReplayData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    LogHeader header;
+    if (mReplayData.size() < sizeof(header))
+    {
+        std::cout << "ERROR::INPUT: " << path << " is too small" << std::endl;
+        return false;
+    }
+    std::memcpy(&header, mReplayData.data(), sizeof(header));
+    if (header.magic != MAGIC || header.version != VERSION || header.eventSize != sizeof(SDL_Event))
+    {
+        std::cout << "ERROR::INPUT: " << path << " is not a compatible input log" << std::endl;
+        return false;
+    }
+
+    mReplayOffset = sizeof(header);
+    mReplayFrames = header.frameCount;
+    mMode = Mode::Replay;
+    return true;
+}
+
+void InputSystem::BeginFrame()
+{
+    if (mFinished)
+    {
+        return;
+    }
+    if (mFrameLimit != 0 && mFrame >= mFrameLimit)
+    {
+        mFinished = true;
+        return;
+    }
+    if (mFrame == 0)
+    {
+        mStartTicks = SDL_GetTicks();
+    }
+
+    if (mMode == Mode::Replay)
+    {
+        ReplayFrame();
+    }
+    else
+    {
+        PollLive();
+        if (mMode == Mode::Record)
+        {
+            RecordFrame();
+        }
+    }
+    mFrame++;
+}
+
+void InputSystem::Stop()
+{
+    if (mLog.is_open())
+    {
+        // Trailing idle frames have no records; the count keeps them
+        mLog.seekp(offsetof(LogHeader, frameCount));
+        mLog.write(reinterpret_cast<const char*>(&mFrame), sizeof(mFrame));
+        mLog.close();
+    }
+    mReplayData.clear();
+    mReplayData.shrink_to_fit();
+}
+
+void InputSystem::PollLive()
+{
+    mEvents.clear();
+    SDL_Event event;
+    while (SDL_PollEvent(&event))
+    {
+        mEvents.push_back(event);
+    }
+
+    mMouseButtons = SDL_GetMouseState(&mMouseX, &mMouseY);
+
+    int keyCount = 0;
+    const Uint8* keys = SDL_GetKeyboardState(&keyCount);
+    std::memcpy(mKeyState, keys, std::min<size_t>(keyCount, SDL_NUM_SCANCODES));
+}
+
+void InputSystem::RecordFrame()
+{
+    mKeyChanges.clear();
+    for (uint16_t scancode = 0; scancode < SDL_NUM_SCANCODES; scancode++)
+    {
+        if (mKeyState[scancode] != mRecordedKeyState[scancode])
+        {
+            mKeyChanges.push_back(static_cast<uint16_t>(scancode | (mKeyState[scancode] ? 0x8000 : 0)));
+            mRecordedKeyState[scancode] = mKeyState[scancode];
+        }
+    }
+
+    mFrameBytes.clear();
+    uint16_t eventCount = 0;
+    for (const SDL_Event& event : mEvents)
+    {
+        size_t size = GetEventSize(event.type);
+        if (size == 0)
+        {
+            continue;
+        }
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&event);
+        uint32_t type = event.type;
+        uint16_t storedSize = static_cast<uint16_t>(size);
+        mFrameBytes.insert(mFrameBytes.end(), reinterpret_cast<const uint8_t*>(&type), reinterpret_cast<const uint8_t*>(&type) + sizeof(type));
+        mFrameBytes.insert(mFrameBytes.end(), reinterpret_cast<const uint8_t*>(&storedSize), reinterpret_cast<const uint8_t*>(&storedSize) + sizeof(storedSize));
+        mFrameBytes.insert(mFrameBytes.end(), bytes, bytes + size);
+        eventCount++;
+    }
+
+    bool mouseChanged = mMouseX != mRecordedMouseX || mMouseY != mRecordedMouseY || mMouseButtons != mRecordedMouseButtons;
+    if (eventCount == 0 && mKeyChanges.empty() && !mouseChanged)
+    {
+        return;
+    }
+    mRecordedMouseX = mMouseX;
+    mRecordedMouseY = mMouseY;
+    mRecordedMouseButtons = mMouseButtons;
+
+    FrameHeader header;
+    header.frame = mFrame;
+    header.timestamp = SDL_GetTicks() - mStartTicks;
+    header.mouseX = mMouseX;
+    header.mouseY = mMouseY;
+    header.mouseButtons = mMouseButtons;
+    header.keyChangeCount = static_cast<uint16_t>(mKeyChanges.size());
+    header.eventCount = eventCount;
+
+    mLog.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    mLog.write(reinterpret_cast<const char*>(mKeyChanges.data()), mKeyChanges.size() * sizeof(uint16_t));
+    mLog.write(reinterpret_cast<const char*>(mFrameBytes.data()), mFrameBytes.size());
+}
+
+void InputSystem::ReplayFrame()
+{
+    mEvents.clear();
+
+    // The real window still needs its events pumped; only closing it counts
+    SDL_Event live;
+    while (SDL_PollEvent(&live))
+    {
+        if (live.type == SDL_QUIT)
+        {
+            mFinished = true;
+        }
+    }
+
+    // Logs from an interrupted recording have no frame count; they end with the data
+    if ((mReplayFrames != 0 && mFrame >= mReplayFrames) ||
+        (mReplayFrames == 0 && mReplayOffset >= mReplayData.size()))
+    {
+        mFinished = true;
+        return;
+    }
+    if (mReplayOffset >= mReplayData.size())
+    {
+        return;
+    }
+
+    FrameHeader header;
+    if (mReplayOffset + sizeof(header) > mReplayData.size())
+    {
+        std::cout << "ERROR::INPUT: Truncated frame in input log" << std::endl;
+        mFinished = true;
+        return;
+    }
+    std::memcpy(&header, mReplayData.data() + mReplayOffset, sizeof(header));
+    if (header.frame != mFrame)
+    {
+        // Nothing changed this frame: keep the previous mouse and key state
+        return;
+    }
+    mReplayOffset += sizeof(header);
+
+    mMouseX = header.mouseX;
+    mMouseY = header.mouseY;
+    mMouseButtons = header.mouseButtons;
+
+    size_t keyBytes = header.keyChangeCount * sizeof(uint16_t);
+    if (mReplayOffset + keyBytes > mReplayData.size())
+    {
+        std::cout << "ERROR::INPUT: Truncated frame in input log" << std::endl;
+        mFinished = true;
+        return;
+    }
+    for (uint16_t i = 0; i < header.keyChangeCount; i++)
+    {
+        uint16_t change;
+        std::memcpy(&change, mReplayData.data() + mReplayOffset + i * sizeof(uint16_t), sizeof(change));
+        uint16_t scancode = change & 0x7fff;
+        if (scancode < SDL_NUM_SCANCODES)
+        {
+            mKeyState[scancode] = (change & 0x8000) ? 1 : 0;
+        }
+    }
+    mReplayOffset += keyBytes;
+
+    for (uint16_t i = 0; i < header.eventCount; i++)
+    {
+        uint32_t type;
+        uint16_t size;
+        if (mReplayOffset + sizeof(type) + sizeof(size) > mReplayData.size())
+        {
+            break;
+        }
+        std::memcpy(&type, mReplayData.data() + mReplayOffset, sizeof(type));
+        std::memcpy(&size, mReplayData.data() + mReplayOffset + sizeof(type), sizeof(size));
+        mReplayOffset += sizeof(type) + sizeof(size);
+        if (size > sizeof(SDL_Event) || mReplayOffset + size > mReplayData.size())
+        {
+            std::cout << "ERROR::INPUT: Corrupt event in input log" << std::endl;
+            mFinished = true;
+            return;
+        }
+
+        SDL_Event event;
+        std::memset(&event, 0, sizeof(event));
+        std::memcpy(&event, mReplayData.data() + mReplayOffset, size);
+        event.type = type;
+        mReplayOffset += size;
+        mEvents.push_back(event);
+    }
+}
@@ -0,0 +1,122 @@
+// ----------------------------------------------------------------
+// InputSystem: per-frame input source with recording and replay
+//
+// Each frame the game reads its events, mouse and keyboard state from
+// here instead of SDL. Live input can be recorded to a binary log and
+// replayed later, frame for frame, for reproducible sessions.
+//
+// Log layout (little-endian):
+//   LogHeader
+//   per frame with any input change:
+//     FrameHeader
+//     uint16_t keyChanges[keyChangeCount]   scancode | 0x8000 if pressed
+//     events[eventCount]                    uint32_t type, uint16_t size, bytes
+// Frames with no new events and unchanged mouse/keys are not stored;
+// replay keeps the previous state for them.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class InputSystem
+{
+public:
+    enum class Mode
+    {
+        Live,
+        Record,
+        Replay
+    };
+
+    static constexpr uint32_t MAGIC = 0x4e494349; // "ICIN"
+    static constexpr uint32_t VERSION = 1;
+    // Simulation step used while replaying, independent of wall time
+    static constexpr float FIXED_TIMESTEP = 1.0f / 60.0f;
+
+    struct LogHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        // sizeof(SDL_Event) on the recording machine; events are stored raw
+        uint32_t eventSize;
+        // Frames in the session, filled in when recording stops
+        uint32_t frameCount;
+    };
+
+    struct FrameHeader
+    {
+        uint32_t frame;
+        // Milliseconds since recording started (informational)
+        uint32_t timestamp;
+        int32_t mouseX;
+        int32_t mouseY;
+        uint32_t mouseButtons;
+        uint16_t keyChangeCount;
+        uint16_t eventCount;
+    };
+
+    InputSystem();
+
+    // Select the input source; call before the first frame
+    bool StartRecording(const std::string& path);
+    bool StartReplay(const std::string& path);
+    // Stop after this many frames (0 = no limit)
+    void SetFrameLimit(uint32_t frames) { mFrameLimit = frames; }
+
+    // Gather this frame's input (live, or from the log)
+    void BeginFrame();
+    // Close the log; a recording is complete after this
+    void Stop();
+
+    Mode GetMode() const { return mMode; }
+    bool IsReplaying() const { return mMode == Mode::Replay; }
+    // True once the frame limit is reached, the replay log has ended or
+    // the window was closed while replaying
+    bool IsFinished() const { return mFinished; }
+    uint32_t GetFrame() const { return mFrame; }
+
+    const std::vector<SDL_Event>& GetEvents() const { return mEvents; }
+    int GetMouseX() const { return mMouseX; }
+    int GetMouseY() const { return mMouseY; }
+    uint32_t GetMouseButtons() const { return mMouseButtons; }
+    const uint8_t* GetKeyState() const { return mKeyState; }
+
+private:
+    // Bytes of an event worth storing (0 for types that are not recorded)
+    static size_t GetEventSize(uint32_t type);
+
+    void PollLive();
+    void RecordFrame();
+    void ReplayFrame();
+
+    Mode mMode;
+    uint32_t mFrame;
+    uint32_t mFrameLimit;
+    bool mFinished;
+    uint32_t mStartTicks;
+
+    std::vector<SDL_Event> mEvents;
+    int mMouseX;
+    int mMouseY;
+    uint32_t mMouseButtons;
+    uint8_t mKeyState[SDL_NUM_SCANCODES];
+
+    // Recording
+    std::ofstream mLog;
+    uint8_t mRecordedKeyState[SDL_NUM_SCANCODES];
+    int mRecordedMouseX;
+    int mRecordedMouseY;
+    uint32_t mRecordedMouseButtons;
+    std::vector<uint16_t> mKeyChanges;
+    std::vector<uint8_t> mFrameBytes;
+
+    // Replay: the whole log, read up front
+    std::vector<uint8_t> mReplayData;
+    size_t mReplayOffset;
+    uint32_t mReplayFrames;
+};
@@ -0,0 +1,429 @@
+// ----------------------------------------------------------------
+// LabelRenderer implementation
+// ----------------------------------------------------------------
+
+#include "LabelRenderer.hpp"
+#include "../../Font/SimpleFont.hpp"
+#include "../Logger/Logger.hpp"
+#include <cmath>
+
+namespace
+{
+    // Instanced quads: the corner comes from gl_VertexID (triangle strip)
+    const char* BOX_VERTEX_SHADER = R"(
+#version 330 core
+layout (location = 0) in vec4 rect;  // <vec2 min, vec2 max>
+layout (location = 1) in vec4 tint;  // <vec3 colour, unused>
+out vec2 Local;
+flat out vec2 HalfSize;
+flat out vec3 Color;
+
+uniform mat4 projection;
+
+void main()
+{
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    vec2 pos = mix(rect.xy, rect.zw, corner);
+    HalfSize = (rect.zw - rect.xy) * 0.5;
+    Local = pos - (rect.xy + rect.zw) * 0.5;
+    Color = tint.rgb;
+    gl_Position = projection * vec4(pos, 0.0, 1.0);
+}
+)";
+
+    // Rounded rect distance field, antialiased over one pixel; premultiplied output
+    const char* BOX_FRAGMENT_SHADER = R"(
+#version 330 core
+in vec2 Local;
+flat in vec2 HalfSize;
+flat in vec3 Color;
+out vec4 color;
+
+uniform float pixelSize;
+
+void main()
+{
+    float radius = min(HalfSize.x, HalfSize.y) * 0.5;
+    vec2 q = abs(Local) - HalfSize + radius;
+    float distance = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - radius;
+    float alpha = clamp(0.5 - distance / pixelSize, 0.0, 1.0);
+    color = vec4(Color * alpha, alpha);
+}
+)";
+
+    const char* IMPOSTOR_VERTEX_SHADER = R"(
+#version 330 core
+layout (location = 0) in vec4 rect;  // <vec2 min, vec2 max>
+layout (location = 1) in vec4 uv;    // <vec2 min, vec2 max>
+layout (location = 2) in vec4 tint;  // <vec3 colour, unused>
+out vec2 TexCoords;
+flat out vec3 Color;
+
+uniform mat4 projection;
+
+void main()
+{
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    TexCoords = mix(uv.xy, uv.zw, corner);
+    Color = tint.rgb;
+    gl_Position = projection * vec4(mix(rect.xy, rect.zw, corner), 0.0, 1.0);
+}
+)";
+
+    // The atlas holds premultiplied text drawn in white (colour glyphs in
+    // their own colours), tinted like glyphs drawn directly
+    const char* IMPOSTOR_FRAGMENT_SHADER = R"(
+#version 330 core
+in vec2 TexCoords;
+flat in vec3 Color;
+out vec4 color;
+
+uniform sampler2D atlas;
+
+void main()
+{
+    color = texture(atlas, TexCoords) * vec4(Color, 1.0);
+}
+)";
+
+    GLuint CompileShader(GLenum type, const char* source)
+    {
+        GLuint shader = glCreateShader(type);
+        glShaderSource(shader, 1, &source, nullptr);
+        glCompileShader(shader);
+
+        GLint success;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+        if (!success)
+        {
+            GLchar infoLog[1024];
+            glGetShaderInfoLog(shader, 1024, nullptr, infoLog);
+            LOG_ERROR("LABEL_RENDERER", "shader compilation failed\n{}", infoLog);
+            glDeleteShader(shader);
+            return 0;
+        }
+        return shader;
+    }
+
+    GLuint CreateProgram(const char* vertexSource, const char* fragmentSource)
+    {
+        GLuint vertex = CompileShader(GL_VERTEX_SHADER, vertexSource);
+        GLuint fragment = CompileShader(GL_FRAGMENT_SHADER, fragmentSource);
+        if (!vertex || !fragment)
+        {
+            glDeleteShader(vertex);
+            glDeleteShader(fragment);
+            return 0;
+        }
+
+        GLuint program = glCreateProgram();
+        glAttachShader(program, vertex);
+        glAttachShader(program, fragment);
+        glLinkProgram(program);
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+
+        GLint success;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success)
+        {
+            GLchar infoLog[1024];
+            glGetProgramInfoLog(program, 1024, nullptr, infoLog);
+            LOG_ERROR("LABEL_RENDERER", "program linking failed\n{}", infoLog);
+            glDeleteProgram(program);
+            return 0;
+        }
+        return program;
+    }
+
+    // Instance buffer with vec4 attributes 0..count-1, one set per instance
+    void SetupInstanceAttributes(GLuint vao, GLuint vbo, int count)
+    {
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        GLsizei stride = count * 4 * sizeof(float);
+        for (int i = 0; i < count; i++)
+        {
+            glEnableVertexAttribArray(i);
+            glVertexAttribPointer(i, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(i * 4 * sizeof(float)));
+            glVertexAttribDivisor(i, 1);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+    }
+
+    const int FLOATS_PER_BOX = 8;
+    const int FLOATS_PER_IMPOSTOR = 12;
+}
+
+LabelRenderer::LabelRenderer()
+    : mProjection(Matrix3x2::Identity)
+    , mPixelsPerUnit(1.0f)
+    , mAtlas(0)
+    , mAtlasFramebuffer(0)
+    , mShelfX(0)
+    , mShelfY(0)
+    , mShelfHeight(0)
+    , mBoxProgram(0)
+    , mImpostorProgram(0)
+    , mBoxVAO(0)
+    , mBoxVBO(0)
+    , mImpostorVAO(0)
+    , mImpostorVBO(0)
+{
+}
+
+LabelRenderer::~LabelRenderer()
+{
+    if (mAtlasFramebuffer) glDeleteFramebuffers(1, &mAtlasFramebuffer);
+    if (mAtlas) glDeleteTextures(1, &mAtlas);
+    if (mBoxVAO) glDeleteVertexArrays(1, &mBoxVAO);
+    if (mBoxVBO) glDeleteBuffers(1, &mBoxVBO);
+    if (mImpostorVAO) glDeleteVertexArrays(1, &mImpostorVAO);
+    if (mImpostorVBO) glDeleteBuffers(1, &mImpostorVBO);
+    if (mBoxProgram) glDeleteProgram(mBoxProgram);
+    if (mImpostorProgram) glDeleteProgram(mImpostorProgram);
+}
+
+bool LabelRenderer::Initialize()
+{
+    mBoxProgram = CreateProgram(BOX_VERTEX_SHADER, BOX_FRAGMENT_SHADER);
+    mImpostorProgram = CreateProgram(IMPOSTOR_VERTEX_SHADER, IMPOSTOR_FRAGMENT_SHADER);
+    if (!mBoxProgram || !mImpostorProgram)
+    {
+        return false;
+    }
+
+    glGenVertexArrays(1, &mBoxVAO);
+    glGenBuffers(1, &mBoxVBO);
+    SetupInstanceAttributes(mBoxVAO, mBoxVBO, FLOATS_PER_BOX / 4);
+    glGenVertexArrays(1, &mImpostorVAO);
+    glGenBuffers(1, &mImpostorVBO);
+    SetupInstanceAttributes(mImpostorVAO, mImpostorVBO, FLOATS_PER_IMPOSTOR / 4);
+
+    glGenTextures(1, &mAtlas);
+    glBindTexture(GL_TEXTURE_2D, mAtlas);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, ATLAS_SIZE, ATLAS_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &mAtlasFramebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, mAtlasFramebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mAtlas, 0);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        LOG_ERROR("LABEL_RENDERER", "atlas framebuffer incomplete (0x{:x})", status);
+        glDeleteProgram(mBoxProgram);
+        glDeleteProgram(mImpostorProgram);
+        mBoxProgram = 0;
+        mImpostorProgram = 0;
+        return false;
+    }
+
+    ClearAtlas();
+    return true;
+}
+
+LabelRenderer::Detail LabelRenderer::GetDetail(float pixelsPerUnit)
+{
+    if (pixelsPerUnit <= BOX_MAX_PIXELS_PER_UNIT)
+    {
+        return Detail::Box;
+    }
+    if (pixelsPerUnit <= IMPOSTOR_MAX_PIXELS_PER_UNIT)
+    {
+        return Detail::Impostor;
+    }
+    return Detail::Glyphs;
+}
+
+Vector3 LabelRenderer::GetNameColor(NameId name)
+{
+    // Fibonacci hashing: consecutive IDs land far apart on the hue wheel
+    uint32_t hash = name * 2654435761u;
+    float hue = (hash >> 8) * (6.0f / 16777216.0f);
+    float fraction = hue - std::floor(hue);
+    const float low = 0.35f;
+    const float high = 0.85f;
+    float rising = low + (high - low) * fraction;
+    float falling = high - (high - low) * fraction;
+    switch (static_cast<int>(hue))
+    {
+    case 0: return Vector3(high, rising, low);
+    case 1: return Vector3(falling, high, low);
+    case 2: return Vector3(low, high, rising);
+    case 3: return Vector3(low, falling, high);
+    case 4: return Vector3(rising, low, high);
+    default: return Vector3(high, low, falling);
+    }
+}
+
+void LabelRenderer::SetProjection(const Matrix3x2& projection, float pixelsPerUnit)
+{
+    Flush();
+    mProjection = projection;
+    mPixelsPerUnit = pixelsPerUnit;
+}
+
+void LabelRenderer::AddBox(const Rect& bounds, const Vector3& color)
+{
+    const float instance[FLOATS_PER_BOX] =
+    {
+        bounds.min.x, bounds.min.y, bounds.max.x, bounds.max.y,
+        color.x, color.y, color.z, 0.0f
+    };
+    mBoxes.insert(mBoxes.end(), instance, instance + FLOATS_PER_BOX);
+}
+
+bool LabelRenderer::AddImpostor(NameId name, std::string_view text, const Rect& extents, float x, float y,
+                                float scale, const Vector3& color, SimpleFont& font)
+{
+    auto it = mImpostors.find(name);
+    if (it == mImpostors.end())
+    {
+        Impostor impostor;
+        if (!RenderImpostor(text, extents, font, impostor))
+        {
+            return false;
+        }
+        it = mImpostors.emplace(name, impostor).first;
+    }
+
+    const Impostor& impostor = it->second;
+    Vector2 pen(x, y);
+    Vector2 min = pen + impostor.extents.min * scale;
+    Vector2 max = pen + impostor.extents.max * scale;
+    const float instance[FLOATS_PER_IMPOSTOR] =
+    {
+        min.x, min.y, max.x, max.y,
+        impostor.uv.min.x, impostor.uv.min.y, impostor.uv.max.x, impostor.uv.max.y,
+        color.x, color.y, color.z, 0.0f
+    };
+    mImpostorQuads.insert(mImpostorQuads.end(), instance, instance + FLOATS_PER_IMPOSTOR);
+    return true;
+}
+
+bool LabelRenderer::RenderImpostor(std::string_view text, const Rect& extents, SimpleFont& font,
+                                   Impostor& outImpostor)
+{
+    int width = static_cast<int>(std::ceil(extents.GetWidth() * IMPOSTOR_SCALE)) + 2 * IMPOSTOR_PADDING;
+    int height = static_cast<int>(std::ceil(extents.GetHeight() * IMPOSTOR_SCALE)) + 2 * IMPOSTOR_PADDING;
+    if (width > ATLAS_SIZE || height > ATLAS_SIZE)
+    {
+        return false;
+    }
+
+    // Next shelf, or start over once the atlas is full. Queued impostors
+    // still point at the old contents, so draw them first.
+    if (mShelfX + width > ATLAS_SIZE)
+    {
+        mShelfX = 0;
+        mShelfY += mShelfHeight;
+        mShelfHeight = 0;
+    }
+    if (mShelfY + height > ATLAS_SIZE)
+    {
+        Flush();
+        ClearAtlas();
+    }
+
+    // The cell covers the text extents plus the padding, in pen space
+    float padding = IMPOSTOR_PADDING / IMPOSTOR_SCALE;
+    Rect area(Vector2(extents.min.x - padding, extents.min.y - padding),
+              Vector2(extents.min.x + (width - IMPOSTOR_PADDING) / IMPOSTOR_SCALE,
+                      extents.min.y + (height - IMPOSTOR_PADDING) / IMPOSTOR_SCALE));
+    Vector2 center = area.GetCenter();
+
+    GLint framebuffer;
+    GLint viewport[4];
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, mAtlasFramebuffer);
+    glViewport(mShelfX, mShelfY, width, height);
+    font.SetProjection(Matrix3x2::CreateTranslation(Vector2(-center.x, -center.y)) *
+                       Matrix3x2::CreateOrtho(area.GetWidth(), area.GetHeight()));
+    font.RenderText(text, 0.0f, 0.0f, 1.0f, Vector3(1.0f, 1.0f, 1.0f));
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+    float texel = 1.0f / ATLAS_SIZE;
+    outImpostor.uv = Rect(Vector2(mShelfX * texel, mShelfY * texel),
+                          Vector2((mShelfX + width) * texel, (mShelfY + height) * texel));
+    outImpostor.extents = area;
+
+    mShelfX += width;
+    mShelfHeight = Math::Max(mShelfHeight, height);
+    return true;
+}
+
+void LabelRenderer::ClearAtlas()
+{
+    GLint framebuffer;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, mAtlasFramebuffer);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+    mImpostors.clear();
+    mShelfX = 0;
+    mShelfY = 0;
+    mShelfHeight = 0;
+}
+
+void LabelRenderer::Flush()
+{
+    if (mBoxes.empty() && mImpostorQuads.empty())
+    {
+        return;
+    }
+
+    Matrix4 projection = mProjection.ToMatrix4();
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    if (!mBoxes.empty())
+    {
+        glUseProgram(mBoxProgram);
+        glUniformMatrix4fv(glGetUniformLocation(mBoxProgram, "projection"), 1, GL_FALSE,
+                           projection.GetAsFloatPtr());
+        glUniform1f(glGetUniformLocation(mBoxProgram, "pixelSize"), 1.0f / mPixelsPerUnit);
+
+        glBindVertexArray(mBoxVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, mBoxVBO);
+        glBufferData(GL_ARRAY_BUFFER, mBoxes.size() * sizeof(float), mBoxes.data(), GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(mBoxes.size() / FLOATS_PER_BOX));
+        mBoxes.clear();
+    }
+
+    if (!mImpostorQuads.empty())
+    {
+        glUseProgram(mImpostorProgram);
+        glUniformMatrix4fv(glGetUniformLocation(mImpostorProgram, "projection"), 1, GL_FALSE,
+                           projection.GetAsFloatPtr());
+        glUniform1i(glGetUniformLocation(mImpostorProgram, "atlas"), 0);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, mAtlas);
+
+        glBindVertexArray(mImpostorVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, mImpostorVBO);
+        glBufferData(GL_ARRAY_BUFFER, mImpostorQuads.size() * sizeof(float), mImpostorQuads.data(),
+                     GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4,
+                              static_cast<GLsizei>(mImpostorQuads.size() / FLOATS_PER_IMPOSTOR));
+        glBindTexture(GL_TEXTURE_2D, 0);
+        mImpostorQuads.clear();
+    }
+
+    glBindVertexArray(0);
+    glDisable(GL_BLEND);
+}
@@ -0,0 +1,111 @@
+// ----------------------------------------------------------------
+// LabelRenderer: cheap stand-ins for tile labels seen from afar
+//
+// Glyph-by-glyph text is only worth its cost while it is readable.
+// Below that, labels are drawn at a lower level of detail chosen from
+// the on-screen size (pixels per world unit of the projection):
+//   - Impostor: the label pre-rendered once into a shared atlas at the
+//     largest size it is used at, drawn as one textured quad
+//   - Box: a rounded rect in a colour derived from the name, sized by
+//     the cached text extents, once the letters would be smudges
+// Both kinds are batched and drawn with one instanced call per kind
+// on Flush, so a zoomed-out board costs one draw for all its tiles.
+//
+// When the atlas fills up it is cleared and labels are re-rendered as
+// they come back into view.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "../../Math.h"
+#include "../StringTable/StringTable.hpp"
+
+class LabelRenderer
+{
+public:
+    enum class Detail
+    {
+        Box,
+        Impostor,
+        Glyphs
+    };
+
+    LabelRenderer();
+    // Releases GL objects; destroy while the context is still alive
+    ~LabelRenderer();
+
+    // Needs a GL context; without one labels are always drawn as glyphs
+    bool Initialize();
+    bool IsReady() const { return mBoxProgram != 0 && mImpostorProgram != 0; }
+
+    // Level of detail for labels drawn at this many pixels per world unit
+    static Detail GetDetail(float pixelsPerUnit);
+    // Stable, distinguishable colour for a name's box
+    static Vector3 GetNameColor(NameId name);
+
+    // Projection for the batches queued from now on (flushes the old ones)
+    void SetProjection(const Matrix3x2& projection, float pixelsPerUnit);
+
+    // Queue a box covering bounds (world space)
+    void AddBox(const Rect& bounds, const Vector3& color);
+    // Queue the cached image of a label whose pen is at (x, y), rendering
+    // it with the font on first use. Leaves the font's projection changed
+    // when it renders. Returns false if the label can't be cached.
+    bool AddImpostor(NameId name, std::string_view text, const Rect& extents, float x, float y, float scale,
+                     const Vector3& color, class SimpleFont& font);
+
+    // Draw everything queued
+    void Flush();
+
+    size_t GetImpostorCount() const { return mImpostors.size(); }
+
+    // Largest scale each stand-in is used at (text 6px and 12px tall at the 24px font size)
+    static constexpr float BOX_MAX_PIXELS_PER_UNIT = 0.25f;
+    static constexpr float IMPOSTOR_MAX_PIXELS_PER_UNIT = 0.5f;
+    // Impostors are rendered at the largest scale they are shown at, so
+    // they are only ever minified
+    static constexpr float IMPOSTOR_SCALE = IMPOSTOR_MAX_PIXELS_PER_UNIT;
+    static const int ATLAS_SIZE = 2048;
+    // Transparent border around each impostor so filtering doesn't bleed
+    static const int IMPOSTOR_PADDING = 1;
+
+private:
+    struct Impostor
+    {
+        // Atlas area in texture coordinates
+        Rect uv;
+        // Area covered relative to the pen at scale 1
+        Rect extents;
+    };
+
+    // Render a label into free atlas space; false if it can't fit
+    bool RenderImpostor(std::string_view text, const Rect& extents, class SimpleFont& font, Impostor& outImpostor);
+    void ClearAtlas();
+
+    Matrix3x2 mProjection;
+    float mPixelsPerUnit;
+
+    // Impostor atlas, filled shelf by shelf from the bottom
+    GLuint mAtlas;
+    GLuint mAtlasFramebuffer;
+    int mShelfX;
+    int mShelfY;
+    int mShelfHeight;
+    std::unordered_map<NameId, Impostor> mImpostors;
+
+    // Per-instance data: rect and colour for boxes; rect, uv and colour for impostors
+    std::vector<float> mBoxes;
+    std::vector<float> mImpostorQuads;
+
+    GLuint mBoxProgram;
+    GLuint mImpostorProgram;
+    GLuint mBoxVAO;
+    GLuint mBoxVBO;
+    GLuint mImpostorVAO;
+    GLuint mImpostorVBO;
+};
@@ -0,0 +1,466 @@
+// ----------------------------------------------------------------
+// Logger implementation
+// ----------------------------------------------------------------
+
+#include "Logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+
+namespace
+{
+    // Record kinds in the ring
+    const uint8_t RECORD_MESSAGE = 1;
+    const uint8_t RECORD_PADDING = 2;
+
+    // Fixed part of a record; the first 8 bytes double as the padding marker
+    struct RecordHeader
+    {
+        uint32_t size;
+        uint8_t kind;
+        uint8_t argumentCount;
+        uint16_t reserved;
+        uint32_t suppressed;
+        uint32_t reserved2;
+        const LogSite* site;
+        int64_t time;
+    };
+
+    // Argument as stored; string bytes follow the argument array
+    struct StoredArgument
+    {
+        uint8_t type;
+        uint8_t reserved[3];
+        uint32_t length;
+        uint64_t bits;
+    };
+
+    const size_t RECORD_ALIGNMENT = 8;
+
+    size_t AlignRecord(size_t size)
+    {
+        return (size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+    }
+
+    // Set once the logger is gone; late messages are dropped
+    std::atomic<bool> gShutDown(false);
+
+    // Marks the thread's ring retired when the thread exits
+    struct RingHolder
+    {
+        std::atomic<bool>* retired = nullptr;
+        void* ring = nullptr;
+
+        ~RingHolder()
+        {
+            if (retired && !gShutDown.load(std::memory_order_acquire))
+            {
+                retired->store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    thread_local RingHolder tRing;
+
+    const char* GetLevelName(LogLevel level)
+    {
+        switch (level)
+        {
+        case LogLevel::Debug:
+            return "DEBUG";
+        case LogLevel::Info:
+            return "INFO";
+        case LogLevel::Warning:
+            return "WARNING";
+        default:
+            return "ERROR";
+        }
+    }
+}
+
+Logger& Logger::Get()
+{
+    static Logger logger;
+    return logger;
+}
+
+Logger::Ring::Ring()
+    : head(0)
+    , tail(0)
+    , dropped(0)
+    , retired(false)
+    , bytes(new unsigned char[RING_BYTES])
+{
+}
+
+Logger::Logger()
+    : mStopping(false)
+    , mFlushRequests(0)
+    , mFlushedThrough(0)
+    , mWritePending(false)
+    , mDroppedTotal(0)
+    , mStartTime(Now())
+{
+    static_assert((RING_BYTES & (RING_BYTES - 1)) == 0, "ring size must be a power of two");
+    mWriter = std::thread(&Logger::WriterLoop, this);
+}
+
+Logger::~Logger()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWake.notify_one();
+    if (mWriter.joinable())
+    {
+        mWriter.join();
+    }
+
+    gShutDown.store(true, std::memory_order_release);
+    for (Ring* ring : mRings)
+    {
+        delete ring;
+    }
+    mRings.clear();
+}
+
+int64_t Logger::Now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool Logger::Admit(LogSite& site, int64_t now, uint32_t& outSuppressed)
+{
+    const int64_t window = now / 1000000000;
+    int64_t start = site.windowStart.load(std::memory_order_relaxed);
+    if (start != window && site.windowStart.compare_exchange_strong(start, window, std::memory_order_relaxed))
+    {
+        site.windowCount.store(0, std::memory_order_relaxed);
+    }
+
+    if (site.windowCount.fetch_add(1, std::memory_order_relaxed) >= RATE_LIMIT)
+    {
+        site.suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    outSuppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+    return true;
+}
+
+Logger::Ring* Logger::GetThreadRing()
+{
+    if (tRing.ring)
+    {
+        return static_cast<Ring*>(tRing.ring);
+    }
+
+    // Once per thread
+    Ring* ring = new Ring();
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mRings.push_back(ring);
+    }
+    tRing.ring = ring;
+    tRing.retired = &ring->retired;
+    return ring;
+}
+
+void Logger::Enqueue(const LogSite& site, int64_t time, uint32_t suppressed, const Argument* arguments, size_t count)
+{
+    if (gShutDown.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    Ring* ring = GetThreadRing();
+
+    size_t size = sizeof(RecordHeader) + count * sizeof(StoredArgument);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (arguments[i].type == Argument::Type::String)
+        {
+            size += arguments[i].length;
+        }
+    }
+    size = AlignRecord(size);
+
+    // Records are contiguous; one that would straddle the end starts over
+    // at the front behind a padding record
+    const uint64_t head = ring->head.load(std::memory_order_relaxed);
+    const uint64_t tail = ring->tail.load(std::memory_order_acquire);
+    const size_t offset = static_cast<size_t>(head & (RING_BYTES - 1));
+    const size_t padding = (RING_BYTES - offset < size) ? RING_BYTES - offset : 0;
+    if (head + padding + size - tail > RING_BYTES)
+    {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        WakeWriter();
+        return;
+    }
+
+    unsigned char* bytes = ring->bytes.get();
+    if (padding > 0)
+    {
+        RecordHeader marker = {};
+        marker.size = static_cast<uint32_t>(padding);
+        marker.kind = RECORD_PADDING;
+        // Only the first 8 bytes are read back (padding can be that short)
+        memcpy(bytes + offset, &marker, RECORD_ALIGNMENT);
+    }
+
+    unsigned char* record = bytes + ((head + padding) & (RING_BYTES - 1));
+    RecordHeader header = {};
+    header.size = static_cast<uint32_t>(size);
+    header.kind = RECORD_MESSAGE;
+    header.argumentCount = static_cast<uint8_t>(count);
+    header.suppressed = suppressed;
+    header.site = &site;
+    header.time = time;
+    memcpy(record, &header, sizeof(header));
+
+    unsigned char* cursor = record + sizeof(RecordHeader);
+    unsigned char* text = cursor + count * sizeof(StoredArgument);
+    for (size_t i = 0; i < count; i++)
+    {
+        const Argument& argument = arguments[i];
+        StoredArgument stored = {};
+        stored.type = static_cast<uint8_t>(argument.type);
+        if (argument.type == Argument::Type::String)
+        {
+            stored.length = argument.length;
+            memcpy(text, argument.text, argument.length);
+            text += argument.length;
+        }
+        else
+        {
+            memcpy(&stored.bits, &argument.u, sizeof(stored.bits));
+        }
+        memcpy(cursor, &stored, sizeof(stored));
+        cursor += sizeof(StoredArgument);
+    }
+
+    ring->head.store(head + padding + size, std::memory_order_release);
+    WakeWriter();
+}
+
+void Logger::WakeWriter()
+{
+    // Cheap check first: while a wake-up is pending, logging stays lock-free
+    if (mWritePending.load(std::memory_order_relaxed) || mWritePending.exchange(true, std::memory_order_acq_rel))
+    {
+        return;
+    }
+    // Under the mutex, so the writer can't miss it between checking and sleeping
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+    }
+    mWake.notify_one();
+}
+
+void Logger::Flush()
+{
+    if (gShutDown.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mMutex);
+    const uint64_t ticket = ++mFlushRequests;
+    mWake.notify_one();
+    mFlushed.wait(lock, [this, ticket] { return mFlushedThrough >= ticket || mStopping; });
+}
+
+void Logger::WriterLoop()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    for (;;)
+    {
+        mWake.wait(lock, [this]
+        {
+            return mStopping || mFlushRequests > mFlushedThrough || mWritePending.load(std::memory_order_relaxed);
+        });
+        const bool stopping = mStopping;
+        const uint64_t flushTarget = mFlushRequests;
+
+        lock.unlock();
+        // Cleared before draining: a record queued after this wakes the
+        // writer again. Acquire makes the rings it announced visible.
+        mWritePending.exchange(false, std::memory_order_acq_rel);
+        Drain();
+        WriteLines();
+        lock.lock();
+
+        mFlushedThrough = flushTarget;
+        mFlushed.notify_all();
+        if (stopping)
+        {
+            return;
+        }
+    }
+}
+
+size_t Logger::Drain()
+{
+    std::vector<Ring*> rings;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        rings = mRings;
+    }
+
+    size_t records = 0;
+    for (Ring* ring : rings)
+    {
+        // Read before draining: everything a retired thread wrote is visible
+        const bool retired = ring->retired.load(std::memory_order_acquire);
+
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        const uint64_t head = ring->head.load(std::memory_order_acquire);
+        const unsigned char* bytes = ring->bytes.get();
+        while (tail < head)
+        {
+            const unsigned char* record = bytes + (tail & (RING_BYTES - 1));
+            uint32_t size;
+            uint8_t kind;
+            memcpy(&size, record, sizeof(size));
+            memcpy(&kind, record + offsetof(RecordHeader, kind), sizeof(kind));
+            if (kind == RECORD_MESSAGE)
+            {
+                mLines.emplace_back();
+                FormatRecord(record, mLines.back());
+                records++;
+            }
+            tail += size;
+        }
+        ring->tail.store(tail, std::memory_order_release);
+
+        const uint64_t dropped = ring->dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0)
+        {
+            mDroppedTotal.fetch_add(dropped, std::memory_order_relaxed);
+            Line line;
+            line.time = Now() - mStartTime;
+            line.level = LogLevel::Warning;
+            line.text = "LOGGER: " + std::to_string(dropped) + " message(s) dropped, ring buffer full";
+            mLines.push_back(std::move(line));
+        }
+
+        if (retired)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mRings.erase(std::find(mRings.begin(), mRings.end(), ring));
+            delete ring;
+        }
+    }
+    return records;
+}
+
+void Logger::FormatRecord(const unsigned char* record, Line& out) const
+{
+    RecordHeader header;
+    memcpy(&header, record, sizeof(header));
+    const StoredArgument* arguments = reinterpret_cast<const StoredArgument*>(record + sizeof(RecordHeader));
+    const char* text = reinterpret_cast<const char*>(record + sizeof(RecordHeader) + header.argumentCount * sizeof(StoredArgument));
+
+    out.time = header.time - mStartTime;
+    out.level = header.site->level;
+
+    std::string& line = out.text;
+    line.reserve(64);
+    line += header.site->category;
+    line += ": ";
+
+    char buffer[64];
+    size_t next = 0;
+    for (const char* f = header.site->format; *f; f++)
+    {
+        // "{}", or "{:x}" for hexadecimal integers
+        const bool hex = f[0] == '{' && f[1] == ':' && f[2] == 'x' && f[3] == '}';
+        if ((f[0] != '{' || f[1] != '}') && !hex)
+        {
+            line += *f;
+            continue;
+        }
+        if (next >= header.argumentCount)
+        {
+            line += *f;
+            continue;
+        }
+        f += hex ? 3 : 1;
+
+        StoredArgument argument;
+        memcpy(&argument, &arguments[next++], sizeof(argument));
+        switch (static_cast<Argument::Type>(argument.type))
+        {
+        case Argument::Type::Int:
+            if (hex)
+            {
+                snprintf(buffer, sizeof(buffer), "%" PRIx64, argument.bits);
+                line += buffer;
+                break;
+            }
+            snprintf(buffer, sizeof(buffer), "%" PRId64, static_cast<int64_t>(argument.bits));
+            line += buffer;
+            break;
+        case Argument::Type::UInt:
+            snprintf(buffer, sizeof(buffer), hex ? "%" PRIx64 : "%" PRIu64, argument.bits);
+            line += buffer;
+            break;
+        case Argument::Type::Double:
+        {
+            double value;
+            memcpy(&value, &argument.bits, sizeof(value));
+            snprintf(buffer, sizeof(buffer), "%g", value);
+            line += buffer;
+            break;
+        }
+        case Argument::Type::Bool:
+            line += argument.bits ? "true" : "false";
+            break;
+        case Argument::Type::Pointer:
+            snprintf(buffer, sizeof(buffer), "0x%" PRIx64, argument.bits);
+            line += buffer;
+            break;
+        case Argument::Type::String:
+            line.append(text, argument.length);
+            text += argument.length;
+            break;
+        }
+    }
+
+    if (header.suppressed > 0)
+    {
+        line += " (+" + std::to_string(header.suppressed) + " suppressed)";
+    }
+}
+
+void Logger::WriteLines()
+{
+    if (mLines.empty())
+    {
+        return;
+    }
+
+    // Rings are drained one after another; restore the global order
+    std::stable_sort(mLines.begin(), mLines.end(), [](const Line& a, const Line& b) { return a.time < b.time; });
+
+    // Keep stdout and stderr in order relative to each other
+    char stamp[32];
+    for (size_t i = 0; i < mLines.size();)
+    {
+        const bool error = mLines[i].level >= LogLevel::Warning;
+        mBatch.clear();
+        for (; i < mLines.size() && (mLines[i].level >= LogLevel::Warning) == error; i++)
+        {
+            const Line& line = mLines[i];
+            snprintf(stamp, sizeof(stamp), "[%9.3f] %s ", static_cast<double>(line.time) * 1e-9,
+                     GetLevelName(line.level));
+            mBatch += stamp;
+            mBatch += line.text;
+            mBatch += '\n';
+        }
+        FILE* stream = error ? stderr : stdout;
+        fwrite(mBatch.data(), 1, mBatch.size(), stream);
+        fflush(stream);
+    }
+    mLines.clear();
+}
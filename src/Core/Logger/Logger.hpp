@@ -0,0 +1,290 @@
+// ----------------------------------------------------------------
+// Logger: asynchronous logging that never blocks the caller
+//
+// Each thread writes records into its own lock-free ring buffer (one
+// producer, one consumer). A record holds the call site, a timestamp
+// and the raw argument values; strings are copied in. Formatting and
+// I/O happen on a background writer thread that drains every ring,
+// merges the records by time and writes them in one batch. A full ring
+// drops the record and counts it instead of waiting.
+//
+// The writer sleeps until there is something to write. Only the first
+// record after it has started a drain wakes it (briefly taking its
+// mutex); records logged while it is awake are picked up by that drain
+// or the next one, so a burst costs one wake-up, not one per message.
+//
+// Messages are logged through the LOG_* macros, which give every call
+// site its own LogSite: levels below LOG_MIN_LEVEL compile to nothing
+// (arguments aren't even evaluated), and a site that fires more than
+// RATE_LIMIT times per second is muted until the next second, with the
+// number of muted messages reported on its next line.
+//
+//     LOG_ERROR("FREETYPE", "Failed to load glyph {} from {}", code, path);
+//
+// Placeholders are "{}" ("{:x}" prints integers in hex); integers, floats, bools, pointers and strings
+// (const char*, std::string, std::string_view) are accepted.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_WARNING 2
+#define LOG_LEVEL_ERROR 3
+
+// Lowest level compiled in (override with -DLOG_MIN_LEVEL=...)
+#ifndef LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define LOG_MIN_LEVEL LOG_LEVEL_INFO
+#else
+#define LOG_MIN_LEVEL LOG_LEVEL_DEBUG
+#endif
+#endif
+
+enum class LogLevel : uint8_t
+{
+    Debug = LOG_LEVEL_DEBUG,
+    Info = LOG_LEVEL_INFO,
+    Warning = LOG_LEVEL_WARNING,
+    Error = LOG_LEVEL_ERROR
+};
+
+// Static per call site: what it logs and its rate-limit state. Queued
+// records point at their site, so it must outlive the logger.
+struct LogSite
+{
+    constexpr LogSite(LogLevel inLevel, const char* inCategory, const char* inFormat)
+        : level(inLevel)
+        , category(inCategory)
+        , format(inFormat)
+        , windowStart(0)
+        , windowCount(0)
+        , suppressed(0)
+    {
+    }
+
+    LogLevel level;
+    const char* category;
+    const char* format;
+
+    // Rate limiting (approximate under contention, never blocks)
+    std::atomic<int64_t> windowStart;
+    std::atomic<uint32_t> windowCount;
+    std::atomic<uint32_t> suppressed;
+};
+
+class Logger
+{
+public:
+    // Process-wide logger; the writer thread starts with the first message
+    static Logger& Get();
+
+    Logger();
+    ~Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    // Queue a message (called by the LOG_* macros)
+    template <typename... Args>
+    void Write(LogSite& site, const Args&... args)
+    {
+        static_assert(sizeof...(Args) <= MAX_ARGUMENTS, "too many log arguments");
+        int64_t now = Now();
+        uint32_t suppressed;
+        if (!Admit(site, now, suppressed))
+        {
+            return;
+        }
+        Argument arguments[sizeof...(Args) + 1];
+        size_t count = 0;
+        (Capture(arguments[count++], args), ...);
+        Enqueue(site, now, suppressed, arguments, count);
+    }
+
+    // Block until everything logged so far has been written (not for use
+    // inside a frame)
+    void Flush();
+
+    // Records lost to full ring buffers
+    uint64_t GetDroppedCount() const { return mDroppedTotal.load(std::memory_order_relaxed); }
+
+    // Messages per call site per second before the site is muted
+    static const uint32_t RATE_LIMIT = 10;
+    static const size_t MAX_ARGUMENTS = 8;
+    // Longest string argument kept (longer ones are cut)
+    static const size_t MAX_STRING_LENGTH = 2048;
+    // Per-thread ring size in bytes (power of two)
+    static const size_t RING_BYTES = 64 * 1024;
+
+private:
+    struct Argument
+    {
+        enum class Type : uint8_t
+        {
+            Int,
+            UInt,
+            Double,
+            Bool,
+            Pointer,
+            String
+        };
+
+        Type type;
+        union
+        {
+            int64_t i;
+            uint64_t u;
+            double d;
+            const void* p;
+        };
+        // String arguments, until they are copied into the ring
+        const char* text;
+        uint32_t length;
+    };
+
+    // One producer thread, drained by the writer
+    struct Ring
+    {
+        Ring();
+
+        alignas(64) std::atomic<uint64_t> head;
+        alignas(64) std::atomic<uint64_t> tail;
+        std::atomic<uint64_t> dropped;
+        // The thread exited; freed once drained
+        std::atomic<bool> retired;
+        std::unique_ptr<unsigned char[]> bytes;
+    };
+
+    // Formatted line waiting for the batch write
+    struct Line
+    {
+        int64_t time;
+        LogLevel level;
+        std::string text;
+    };
+
+    template <typename T>
+    static void Capture(Argument& argument, const T& value)
+    {
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            argument.type = Argument::Type::Bool;
+            argument.u = value ? 1 : 0;
+        }
+        else if constexpr (std::is_enum_v<T>)
+        {
+            argument.type = Argument::Type::Int;
+            argument.i = static_cast<int64_t>(value);
+        }
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+        {
+            argument.type = Argument::Type::Int;
+            argument.i = value;
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            argument.type = Argument::Type::UInt;
+            argument.u = value;
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            argument.type = Argument::Type::Double;
+            argument.d = value;
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+        {
+            std::string_view text;
+            if constexpr (std::is_pointer_v<T>)
+            {
+                text = value ? std::string_view(value) : std::string_view("(null)");
+            }
+            else
+            {
+                text = value;
+            }
+            argument.type = Argument::Type::String;
+            argument.text = text.data();
+            argument.length = static_cast<uint32_t>(text.size() < MAX_STRING_LENGTH ? text.size() : MAX_STRING_LENGTH);
+        }
+        else if constexpr (std::is_pointer_v<T>)
+        {
+            argument.type = Argument::Type::Pointer;
+            argument.p = value;
+        }
+        else
+        {
+            static_assert(std::is_pointer_v<T>, "unsupported log argument type");
+        }
+    }
+
+    static int64_t Now();
+    static bool Admit(LogSite& site, int64_t now, uint32_t& outSuppressed);
+
+    void Enqueue(const LogSite& site, int64_t time, uint32_t suppressed, const Argument* arguments, size_t count);
+    // Ring of the calling thread (registered on first use)
+    Ring* GetThreadRing();
+    // Called after queueing: wakes the writer unless a wake-up is pending
+    void WakeWriter();
+
+    void WriterLoop();
+    // Read everything queued so far into mLines; returns the number of records
+    size_t Drain();
+    void FormatRecord(const unsigned char* record, Line& out) const;
+    void WriteLines();
+
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::condition_variable mFlushed;
+    std::vector<Ring*> mRings;
+    std::thread mWriter;
+    bool mStopping;
+    uint64_t mFlushRequests;
+    uint64_t mFlushedThrough;
+    // Records were queued since the writer's last drain began
+    std::atomic<bool> mWritePending;
+    std::atomic<uint64_t> mDroppedTotal;
+    int64_t mStartTime;
+
+    // Writer thread only
+    std::vector<Line> mLines;
+    std::string mBatch;
+};
+
+#define LOG_AT(level, category, format, ...)                                    \
+    do                                                                          \
+    {                                                                           \
+        static LogSite logSite_(level, category, format);                       \
+        Logger::Get().Write(logSite_, ##__VA_ARGS__);                           \
+    } while (0)
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(category, format, ...) LOG_AT(LogLevel::Debug, category, format, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(category, format, ...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(category, format, ...) LOG_AT(LogLevel::Info, category, format, ##__VA_ARGS__)
+#else
+#define LOG_INFO(category, format, ...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_WARNING
+#define LOG_WARNING(category, format, ...) LOG_AT(LogLevel::Warning, category, format, ##__VA_ARGS__)
+#else
+#define LOG_WARNING(category, format, ...) ((void)0)
+#endif
+
+#define LOG_ERROR(category, format, ...) LOG_AT(LogLevel::Error, category, format, ##__VA_ARGS__)
@@ -0,0 +1,179 @@
+// ----------------------------------------------------------------
+// OverlapSolver implementation
+// ----------------------------------------------------------------
+
+#include "OverlapSolver.hpp"
+#include "../../Actor/Actor.hpp"
+#include "../../Actor/TextActor.hpp"
+#include "../../Component/DragComponent/DragComponent.hpp"
+#include "../SpatialGrid/SpatialGrid.hpp"
+#include <chrono>
+
+namespace
+{
+    // Reading the clock per tile would cost more than most checks
+    const size_t CHECKS_PER_CLOCK_READ = 32;
+    // Successive tie directions never repeat and stay evenly spread
+    const float GOLDEN_ANGLE = 2.39996323f;
+}
+
+OverlapSolver::OverlapSolver(SpatialGrid* grid)
+    : mGrid(grid)
+    , mCursor(0)
+    , mTieAngle(0.0f)
+{
+}
+
+void OverlapSolver::Enqueue(Actor* actor)
+{
+    if (actor->mSolverIndex < 0)
+    {
+        actor->mSolverIndex = static_cast<int>(mRestless.size());
+        mRestless.push_back(actor);
+    }
+}
+
+void OverlapSolver::Remove(Actor* actor)
+{
+    if (actor->mSolverIndex >= 0)
+    {
+        RemoveAt(static_cast<size_t>(actor->mSolverIndex));
+    }
+}
+
+void OverlapSolver::RemoveAt(size_t index)
+{
+    Actor* last = mRestless.back();
+    mRestless[index]->mSolverIndex = -1;
+    mRestless[index] = last;
+    if (last->mSolverIndex >= 0)
+    {
+        last->mSolverIndex = static_cast<int>(index);
+    }
+    mRestless.pop_back();
+}
+
+bool OverlapSolver::Step(double budgetMs, size_t maxChecks)
+{
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point deadline = Clock::now() +
+        std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(budgetMs));
+
+    bool moved = false;
+    size_t sweepLength = mRestless.size();
+    for (size_t checks = 0; checks < sweepLength && !mRestless.empty(); checks++)
+    {
+        if (maxChecks > 0 && checks >= maxChecks)
+        {
+            break;
+        }
+        if (budgetMs > 0.0 && checks % CHECKS_PER_CLOCK_READ == 0 && checks > 0 && Clock::now() >= deadline)
+        {
+            break;
+        }
+
+        if (mCursor >= mRestless.size())
+        {
+            mCursor = 0;
+        }
+        Actor* actor = mRestless[mCursor];
+        if (IsMovable(actor) && Resolve(actor))
+        {
+            moved = true;
+            mCursor++;
+        }
+        else
+        {
+            // At rest (or pinned): the last restless actor moves into this slot
+            RemoveAt(mCursor);
+        }
+    }
+    return moved;
+}
+
+bool OverlapSolver::IsMovable(Actor* actor)
+{
+    TextActor* tile = dynamic_cast<TextActor*>(actor);
+    if (!tile || tile->GetState() != ActorState::Active || tile->IsPending())
+    {
+        return false;
+    }
+    DragComponent* drag = tile->GetComponent<DragComponent>();
+    return !drag || !drag->IsDragging();
+}
+
+bool OverlapSolver::IsSolid(Actor* actor)
+{
+    TextActor* tile = dynamic_cast<TextActor*>(actor);
+    if (!tile || tile->GetState() != ActorState::Active || tile->IsRetiring())
+    {
+        return false;
+    }
+    // Leave room to drop the dragged tile onto anything
+    DragComponent* drag = tile->GetComponent<DragComponent>();
+    return !drag || !drag->IsDragging();
+}
+
+Rect OverlapSolver::GetLayoutBounds(Actor* actor)
+{
+    TextActor* tile = static_cast<TextActor*>(actor);
+    return tile->GetLayoutBounds();
+}
+
+bool OverlapSolver::Resolve(Actor* actor)
+{
+    Rect bounds = GetLayoutBounds(actor);
+    Vector2 gap(GAP, GAP);
+    mGrid->QueryRect(Rect(bounds.min - gap, bounds.max + gap), mQueryResults);
+
+    bool overlapped = false;
+    for (Actor* other : mQueryResults)
+    {
+        if (other == actor || !IsSolid(other))
+        {
+            continue;
+        }
+
+        // Penetration including the gap to keep
+        Rect otherBounds = GetLayoutBounds(other);
+        float overlapX = Math::Min(bounds.max.x, otherBounds.max.x) - Math::Max(bounds.min.x, otherBounds.min.x) + GAP;
+        float overlapY = Math::Min(bounds.max.y, otherBounds.max.y) - Math::Max(bounds.min.y, otherBounds.min.y) + GAP;
+        if (overlapX <= RESOLVED_OVERLAP || overlapY <= RESOLVED_OVERLAP)
+        {
+            continue;
+        }
+        overlapped = true;
+
+        // Separate along the line between the centers, so a pile spreads out
+        // in every direction instead of into a long column. Tiles on exactly
+        // the same spot get a fresh direction each time
+        Vector2 direction = bounds.GetCenter() - otherBounds.GetCenter();
+        if (direction.LengthSq() < RESOLVED_OVERLAP * RESOLVED_OVERLAP)
+        {
+            mTieAngle += GOLDEN_ANGLE;
+            direction = Vector2(Math::Cos(mTieAngle), Math::Sin(mTieAngle));
+        }
+        direction.Normalize();
+
+        // Distance along the direction that clears the overlap on either axis
+        float clearX = Math::Abs(direction.x) > 1e-4f ? overlapX / Math::Abs(direction.x) : Math::Infinity;
+        float clearY = Math::Abs(direction.y) > 1e-4f ? overlapY / Math::Abs(direction.y) : Math::Infinity;
+        float overlap = Math::Min(clearX, clearY);
+        // Relax, but never by less than MIN_STEP so pairs finish separating
+        float distance = Math::Clamp(overlap * RELAXATION, Math::Min(overlap, MIN_STEP), MAX_STEP);
+        Vector2 push = direction * distance;
+
+        if (IsMovable(other))
+        {
+            actor->SetPosition(actor->GetPosition() + push * 0.5f);
+            other->SetPosition(other->GetPosition() - push * 0.5f);
+            Enqueue(other);
+        }
+        else
+        {
+            actor->SetPosition(actor->GetPosition() + push);
+        }
+        bounds = GetLayoutBounds(actor);
+    }
+    return overlapped;
+}
@@ -0,0 +1,68 @@
+// ----------------------------------------------------------------
+// OverlapSolver: pushes piled-up tiles apart over a few frames
+//
+// Only "restless" tiles are examined: ones that were spawned, dropped
+// or pushed recently. Each frame the solver sweeps over them, finds
+// overlapping neighbors through the spatial grid (broad phase) and
+// moves each overlapping pair part of the way apart along the line
+// between their centers (narrow phase). A tile that no longer overlaps
+// anything comes to rest and drops out until something enqueues it
+// again, so a settled board costs nothing.
+//
+// Work per frame is capped by a time budget or a check count; the
+// sweep resumes where it stopped on the next frame.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "../../Math.h"
+
+class OverlapSolver
+{
+public:
+    explicit OverlapSolver(class SpatialGrid* grid);
+
+    // Mark an actor as possibly overlapping (spawned, dropped, moved)
+    void Enqueue(class Actor* actor);
+    // Forget an actor (called when it is destroyed)
+    void Remove(class Actor* actor);
+
+    // Examine restless tiles until budgetMs elapses or maxChecks tiles were
+    // examined (0 disables either limit), at most one sweep per call.
+    // Returns true if any tile moved.
+    bool Step(double budgetMs, size_t maxChecks);
+
+    size_t GetRestlessCount() const { return mRestless.size(); }
+
+    // Space kept between separated tiles
+    static constexpr float GAP = 4.0f;
+    // Fraction of the penetration removed per step (spreads the motion over frames)
+    static constexpr float RELAXATION = 0.5f;
+    // Nearest and farthest a pair moves apart in one step
+    static constexpr float MIN_STEP = 1.0f;
+    static constexpr float MAX_STEP = 24.0f;
+    // Penetration small enough to count as separated
+    static constexpr float RESOLVED_OVERLAP = 0.01f;
+
+private:
+    // Tiles that can be pushed: active, not being dragged or merged
+    static bool IsMovable(class Actor* actor);
+    // Tiles that others are pushed away from (movable ones and pending merges)
+    static bool IsSolid(class Actor* actor);
+    // Bounds at rest, ignoring animated scale
+    static Rect GetLayoutBounds(class Actor* actor);
+
+    // Push the actor and its neighbors apart; false if it overlapped nothing
+    bool Resolve(class Actor* actor);
+    void RemoveAt(size_t index);
+
+    class SpatialGrid* mGrid;
+    // Restless actors; each stores its index (Actor::mSolverIndex)
+    std::vector<class Actor*> mRestless;
+    // Where the next sweep resumes
+    size_t mCursor;
+    // Direction used for the last pair of tiles sharing a center
+    float mTieAngle;
+    std::vector<class Actor*> mQueryResults;
+};
@@ -0,0 +1,77 @@
+// ----------------------------------------------------------------
+// FrameMailbox implementation
+// ----------------------------------------------------------------
+
+#include "FrameMailbox.hpp"
+#include <utility>
+
+FrameMailbox::FrameMailbox()
+    : mWriteIndex(0)
+    , mReadyIndex(1)
+    , mReadIndex(2)
+    , mHasFresh(false)
+    , mClosed(false)
+    , mPublished(0)
+    , mReadySequence(0)
+    , mReadSequence(0)
+    , mDrawn(0)
+{
+}
+
+uint64_t FrameMailbox::Publish()
+{
+    uint64_t sequence;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        std::swap(mWriteIndex, mReadyIndex);
+        mHasFresh = true;
+        sequence = mReadySequence = ++mPublished;
+    }
+    mFrameReady.notify_one();
+    return sequence;
+}
+
+uint64_t FrameMailbox::GetDrawnSequence()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mDrawn;
+}
+
+void FrameMailbox::WaitUntilDrawn()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mFrameDrawn.wait(lock, [this] { return mClosed || mDrawn >= mPublished; });
+}
+
+const FrameSnapshot* FrameMailbox::Take()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mFrameReady.wait(lock, [this] { return mClosed || mHasFresh; });
+    if (mClosed)
+    {
+        return nullptr;
+    }
+    std::swap(mReadyIndex, mReadIndex);
+    mHasFresh = false;
+    mReadSequence = mReadySequence;
+    return &mSlots[mReadIndex];
+}
+
+void FrameMailbox::MarkDrawn()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mDrawn = mReadSequence;
+    }
+    mFrameDrawn.notify_all();
+}
+
+void FrameMailbox::Close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mClosed = true;
+    }
+    mFrameReady.notify_all();
+    mFrameDrawn.notify_all();
+}
@@ -0,0 +1,65 @@
+// ----------------------------------------------------------------
+// FrameMailbox: triple-buffered hand-over of frame snapshots
+//
+// Three snapshots rotate between the simulation (writing the next
+// one), the mailbox (holding the latest published one) and the render
+// thread (drawing one). Publishing never waits for the renderer and
+// taking never waits for the simulation; a snapshot that is replaced
+// before the render thread gets to it is dropped. Snapshots are
+// numbered, and the simulation can ask which one was drawn last to
+// learn that work it handed over (static-layer bakes) has been done.
+//
+// The lock only guards the index swap and the sequence numbers.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include "FrameSnapshot.hpp"
+
+class FrameMailbox
+{
+public:
+    FrameMailbox();
+
+    // Simulation: the snapshot to fill next (owned by the caller until Publish)
+    FrameSnapshot& GetWriteSlot() { return mSlots[mWriteIndex]; }
+    // Simulation: make the write slot the latest frame; returns its
+    // sequence number (the first is 1)
+    uint64_t Publish();
+    // Simulation: sequence number of the last frame drawn (0 if none)
+    uint64_t GetDrawnSequence();
+    // Simulation: block until the render thread has drawn everything
+    // published so far (or the mailbox was closed)
+    void WaitUntilDrawn();
+
+    // Render thread: block for a frame newer than the last one taken.
+    // Returns null once the mailbox is closed.
+    const FrameSnapshot* Take();
+    // Render thread: the frame returned by Take is on screen
+    void MarkDrawn();
+
+    // Wake and release both sides for shutdown
+    void Close();
+
+private:
+    FrameSnapshot mSlots[3];
+    // Slot roles; each index appears exactly once
+    int mWriteIndex;
+    int mReadyIndex;
+    int mReadIndex;
+    // The ready slot holds a frame the render thread hasn't taken
+    bool mHasFresh;
+    bool mClosed;
+    // Frames published so far, and the sequence numbers of the ready,
+    // taken and last drawn frames
+    uint64_t mPublished;
+    uint64_t mReadySequence;
+    uint64_t mReadSequence;
+    uint64_t mDrawn;
+
+    std::mutex mMutex;
+    std::condition_variable mFrameReady;
+    std::condition_variable mFrameDrawn;
+};
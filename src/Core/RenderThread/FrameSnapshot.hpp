@@ -0,0 +1,135 @@
+// ----------------------------------------------------------------
+// FrameSnapshot: everything the render thread needs to draw a frame
+//
+// The simulation fills a snapshot from the actors and UI, then hands
+// it over through the FrameMailbox; from then on it is immutable and
+// the render thread never touches game state. Draw lists hold plain
+// values (interned name IDs, transforms, colours), and their vectors
+// keep their capacity across frames, so filling one doesn't allocate
+// once the game has warmed up.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../../Math.h"
+#include "../Camera/Camera.hpp"
+#include "../StringTable/StringTable.hpp"
+
+// A tile label, placed the way TextRenderer::RenderLabel takes it
+struct LabelItem
+{
+    NameId name;
+    // Text extents relative to the pen at scale 1
+    Rect extents;
+    Vector2 pen;
+    float scale;
+    Vector3 color;
+    // World area covered (pen + extents * scale)
+    Rect bounds;
+};
+
+// A run of text; its characters live in the owning DrawList
+struct TextItem
+{
+    uint32_t offset;
+    uint32_t length;
+    Vector2 pen;
+    float scale;
+    Vector3 color;
+};
+
+class DrawList
+{
+public:
+    void Clear()
+    {
+        mLabels.clear();
+        mTexts.clear();
+        mText.clear();
+    }
+
+    void AddLabel(NameId name, const Rect& extents, const Vector2& pen, float scale, const Vector3& color)
+    {
+        Rect bounds(pen + extents.min * scale, pen + extents.max * scale);
+        mLabels.push_back(LabelItem{ name, extents, pen, scale, color, bounds });
+    }
+
+    // The text is copied, so it may come from short-lived storage
+    void AddText(std::string_view text, const Vector2& pen, float scale = 1.0f,
+                 const Vector3& color = Vector3(1.0f, 1.0f, 1.0f))
+    {
+        mTexts.push_back(TextItem{ static_cast<uint32_t>(mText.size()), static_cast<uint32_t>(text.size()), pen,
+                                   scale, color });
+        mText.append(text.data(), text.size());
+    }
+
+    const std::vector<LabelItem>& GetLabels() const { return mLabels; }
+    const std::vector<TextItem>& GetTexts() const { return mTexts; }
+    std::string_view GetText(const TextItem& item) const
+    {
+        return std::string_view(mText).substr(item.offset, item.length);
+    }
+
+private:
+    std::vector<LabelItem> mLabels;
+    std::vector<TextItem> mTexts;
+    std::string mText;
+};
+
+// A static-layer chunk to show, placed by StaticLayerPlanner
+struct StaticChunk
+{
+    // Texture slot on the render thread
+    uint32_t slot;
+    // Contents the slot must hold; a slot holding another version is
+    // rebaked (bake) or left out
+    uint64_t version;
+    // World area covered
+    Rect area;
+    // Stale: rebake from board labels [firstLabel, firstLabel + labelCount)
+    bool bake;
+    uint32_t firstLabel;
+    uint32_t labelCount;
+};
+
+struct StaticLayerPlan
+{
+    // Chunk resolution
+    float texelsPerUnit;
+    // Chunks in view, composited under the live tiles
+    std::vector<StaticChunk> chunks;
+
+    void Clear()
+    {
+        texelsPerUnit = 0.0f;
+        chunks.clear();
+    }
+};
+
+struct FrameSnapshot
+{
+    // View at the time of the snapshot (projections, zoom, viewport size)
+    Camera camera;
+    // Resting tiles of the static-layer chunks being rebaked, grouped
+    // by chunk (a tile straddling chunks appears in each)
+    DrawList board;
+    // Moving and animating tiles in view, drawn every frame on top (every
+    // tile when there is no static layer)
+    DrawList live;
+    // Screen-space UI, drawn last
+    DrawList overlay;
+    // Cached chunks to composite under the live tiles
+    StaticLayerPlan staticLayer;
+
+    // Empty it for refilling
+    void Reset()
+    {
+        board.Clear();
+        live.Clear();
+        overlay.Clear();
+        staticLayer.Clear();
+    }
+};
@@ -0,0 +1,156 @@
+// ----------------------------------------------------------------
+// RenderThread implementation
+// ----------------------------------------------------------------
+
+#include "RenderThread.hpp"
+#include "../Logger/Logger.hpp"
+#include "../TextRenderer/TextRenderer.hpp"
+
+RenderThread::RenderThread()
+    : mWindow(nullptr)
+    , mContext(nullptr)
+    , mTextRenderer(nullptr)
+    , mHasStaticLayer(false)
+    , mViewportWidth(0)
+    , mViewportHeight(0)
+{
+}
+
+RenderThread::~RenderThread()
+{
+    Stop();
+}
+
+bool RenderThread::Initialize(SDL_Window* window, SDL_GLContext context, int width, int height)
+{
+    mWindow = window;
+    mContext = context;
+
+    mRenderer = std::make_unique<Renderer>();
+    if (!mRenderer->Initialize(width, height))
+    {
+        LOG_ERROR("RENDER_THREAD", "Failed to initialize renderer");
+        mRenderer.reset();
+        return false;
+    }
+    mViewportWidth = width;
+    mViewportHeight = height;
+
+    // Without it every tile is drawn every frame
+    mHasStaticLayer = mStaticLayer.Initialize();
+    if (!mHasStaticLayer)
+    {
+        LOG_WARNING("RENDER_THREAD", "Failed to initialize the static board layer");
+    }
+    return true;
+}
+
+void RenderThread::Start(TextRenderer* textRenderer)
+{
+    if (!mRenderer || mThread.joinable())
+    {
+        return;
+    }
+    mTextRenderer = textRenderer;
+    // A context is current on one thread at a time
+    SDL_GL_MakeCurrent(mWindow, nullptr);
+    mThread = std::thread(&RenderThread::ThreadLoop, this);
+}
+
+void RenderThread::Stop()
+{
+    if (mThread.joinable())
+    {
+        mMailbox.Close();
+        mThread.join();
+        SDL_GL_MakeCurrent(mWindow, mContext);
+    }
+    else if (mRenderer)
+    {
+        // Never started: the context is still current here
+        ReleaseGL();
+    }
+}
+
+void RenderThread::ReleaseGL()
+{
+    mStaticLayer.Shutdown();
+    mRenderer->Shutdown();
+    mRenderer.reset();
+}
+
+void RenderThread::ThreadLoop()
+{
+    SDL_GL_MakeCurrent(mWindow, mContext);
+
+    while (const FrameSnapshot* frame = mMailbox.Take())
+    {
+        Draw(*frame);
+        SDL_GL_SwapWindow(mWindow);
+        mMailbox.MarkDrawn();
+    }
+
+    ReleaseGL();
+    SDL_GL_MakeCurrent(mWindow, nullptr);
+}
+
+void RenderThread::Draw(const FrameSnapshot& frame)
+{
+    const Camera& camera = frame.camera;
+    if (camera.GetViewportWidth() != mViewportWidth || camera.GetViewportHeight() != mViewportHeight)
+    {
+        mViewportWidth = camera.GetViewportWidth();
+        mViewportHeight = camera.GetViewportHeight();
+        mRenderer->SetViewport(mViewportWidth, mViewportHeight);
+    }
+
+    mRenderer->BeginFrame();
+
+    // Clear screen with dark background
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    if (!mTextRenderer)
+    {
+        mRenderer->EndFrame();
+        return;
+    }
+
+    // Resting tiles come from the cache, the rest is drawn on top
+    if (mStaticLayer.IsReady())
+    {
+        const std::vector<LabelItem>& board = frame.board.GetLabels();
+        mStaticLayer.Draw(camera, frame.staticLayer,
+                          [this, &board](const StaticChunk& chunk, const Matrix3x2& projection, float pixelsPerUnit)
+        {
+            DrawLabels(board.data() + chunk.firstLabel, chunk.labelCount, chunk.area, projection, pixelsPerUnit);
+        });
+    }
+    const std::vector<LabelItem>& live = frame.live.GetLabels();
+    DrawLabels(live.data(), live.size(), camera.GetVisibleRect(), camera.GetViewProjection(), camera.GetZoom());
+
+    // UI is drawn in screen space on top of the board
+    mTextRenderer->SetProjection(camera.GetScreenProjection());
+    for (const TextItem& item : frame.overlay.GetTexts())
+    {
+        mTextRenderer->RenderText(frame.overlay.GetText(item), item.pen.x, item.pen.y, item.scale, item.color);
+    }
+
+    mRenderer->EndFrame();
+}
+
+void RenderThread::DrawLabels(const LabelItem* labels, size_t count, const Rect& area, const Matrix3x2& projection,
+                              float pixelsPerUnit)
+{
+    mTextRenderer->SetProjection(projection, pixelsPerUnit);
+    for (size_t i = 0; i < count; i++)
+    {
+        const LabelItem& label = labels[i];
+        if (label.bounds.Intersects(area))
+        {
+            mTextRenderer->RenderLabel(label.name, label.extents, label.pen.x, label.pen.y, label.scale, label.color);
+        }
+    }
+    // Batched labels must land before the target changes (chunks switch framebuffers)
+    mTextRenderer->Flush();
+}
@@ -0,0 +1,67 @@
+// ----------------------------------------------------------------
+// RenderThread: draws published frame snapshots on its own thread
+//
+// The thread owns the GL context while it runs. It takes the newest
+// snapshot from the mailbox, draws it (static layer, live tiles, UI)
+// and swaps, so a swap blocked on vsync or a slow driver call delays
+// only the next picture, never input handling or the simulation. When
+// the simulation publishes faster than frames reach the screen, the
+// frames in between are skipped.
+//
+// GL objects are created on the main thread before Start (the context
+// is current there during initialization) and released on the render
+// thread before Stop hands the context back.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <SDL.h>
+#include <memory>
+#include <thread>
+#include "../../Math.h"
+#include "../Renderer/Renderer.hpp"
+#include "../StaticLayer/StaticLayer.hpp"
+#include "FrameMailbox.hpp"
+
+class RenderThread
+{
+public:
+    RenderThread();
+    ~RenderThread();
+
+    // Main thread, with the context current: load GL and set up the renderers
+    bool Initialize(SDL_Window* window, SDL_GLContext context, int width, int height);
+    // Hand the context to the render thread and start drawing. The text
+    // renderer is shared with the simulation, which only measures text.
+    void Start(class TextRenderer* textRenderer);
+    // Finish the frame in progress, release the GL objects and make the
+    // context current on the calling thread again
+    void Stop();
+    bool IsRunning() const { return mThread.joinable(); }
+    // Whether frames go through the static layer (fixed by Initialize)
+    bool HasStaticLayer() const { return mHasStaticLayer; }
+
+    FrameMailbox* GetMailbox() { return &mMailbox; }
+
+private:
+    void ThreadLoop();
+    // On the thread the context is current on
+    void ReleaseGL();
+    void Draw(const FrameSnapshot& frame);
+    // Labels that touch area, at the given projection
+    void DrawLabels(const LabelItem* labels, size_t count, const Rect& area, const Matrix3x2& projection,
+                    float pixelsPerUnit);
+
+    SDL_Window* mWindow;
+    SDL_GLContext mContext;
+    class TextRenderer* mTextRenderer;
+    std::unique_ptr<Renderer> mRenderer;
+    // Cached rendering of the resting board
+    StaticLayer mStaticLayer;
+    bool mHasStaticLayer;
+    // Viewport the GL state was last set up for
+    int mViewportWidth;
+    int mViewportHeight;
+
+    FrameMailbox mMailbox;
+    std::thread mThread;
+};
@@ -3,7 +3,7 @@
 // ----------------------------------------------------------------
 
 #include "Renderer.hpp"
-#include <iostream>
+#include "../Logger/Logger.hpp"
 
 Renderer::Renderer()
     : mWindowWidth(0)
@@ -24,7 +24,7 @@ bool Renderer::Initialize(int windowWidth, int windowHeight)
     // Initialize GLEW
     if (glewInit() != GLEW_OK)
     {
-        std::cerr << "Failed to initialize GLEW!" << std::endl;
+        LOG_ERROR("RENDERER", "Failed to initialize GLEW");
         return false;
     }
 
@@ -32,9 +32,18 @@ bool Renderer::Initialize(int windowWidth, int windowHeight)
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+    SetViewport(windowWidth, windowHeight);
+
     return true;
 }
 
+void Renderer::SetViewport(int windowWidth, int windowHeight)
+{
+    mWindowWidth = windowWidth;
+    mWindowHeight = windowHeight;
+    glViewport(0, 0, mWindowWidth, mWindowHeight);
+}
+
 void Renderer::BeginFrame()
 {
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
@@ -16,6 +16,9 @@ public:
     void EndFrame();
     void Shutdown();
 
+    // Resize the GL viewport (called when the window size changes)
+    void SetViewport(int windowWidth, int windowHeight);
+
 private:
     int mWindowWidth;
     int mWindowHeight;
@@ -0,0 +1,559 @@
+// ----------------------------------------------------------------
+// SaveGame implementation
+// ----------------------------------------------------------------
+
+#include "SaveGame.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    const char* KIND_NAMES[] = { "recipes", "discovered", "board" };
+
+    uint64_t Fnv1a(const uint8_t* data, size_t size)
+    {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= data[i];
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    template <typename T>
+    void Put(std::vector<uint8_t>& bytes, const T& value)
+    {
+        size_t offset = bytes.size();
+        bytes.resize(offset + sizeof(T));
+        std::memcpy(bytes.data() + offset, &value, sizeof(T));
+    }
+
+    void PutName(std::vector<uint8_t>& bytes, NameId name)
+    {
+        std::string_view text = StringTable::Get().GetString(name);
+        Put(bytes, static_cast<uint32_t>(text.size()));
+        bytes.insert(bytes.end(), text.begin(), text.end());
+    }
+
+    // Bounds-checked cursor over a chunk payload
+    struct Reader
+    {
+        const uint8_t* data;
+        size_t size;
+        size_t offset;
+        bool ok;
+        // Version 1 saves prefix names with 16-bit lengths
+        bool shortLengths;
+
+        template <typename T>
+        T Get()
+        {
+            T value{};
+            if (offset + sizeof(T) > size)
+            {
+                ok = false;
+                return value;
+            }
+            std::memcpy(&value, data + offset, sizeof(T));
+            offset += sizeof(T);
+            return value;
+        }
+
+        NameId GetName()
+        {
+            size_t length = shortLengths ? Get<uint16_t>() : Get<uint32_t>();
+            if (!ok || offset + length > size)
+            {
+                ok = false;
+                return INVALID_NAME;
+            }
+            std::string_view text(reinterpret_cast<const char*>(data + offset), length);
+            offset += length;
+            return StringTable::Get().Intern(text);
+        }
+    };
+
+    bool WriteAll(int fd, const void* data, size_t size)
+    {
+        const char* bytes = static_cast<const char*>(data);
+        while (size > 0)
+        {
+            ssize_t count = write(fd, bytes, size);
+            if (count < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            bytes += count;
+            size -= static_cast<size_t>(count);
+        }
+        return true;
+    }
+
+    // Write and fsync: the file is on disk before the manifest can name it
+    bool WriteFile(const std::string& path, const void* header, size_t headerSize, const std::vector<uint8_t>& payload)
+    {
+        int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+        {
+            return false;
+        }
+        bool written = WriteAll(fd, header, headerSize) && WriteAll(fd, payload.data(), payload.size()) &&
+                       fsync(fd) == 0;
+        return close(fd) == 0 && written;
+    }
+
+    // Persist renames and new files in a directory
+    bool SyncDirectory(const std::string& path)
+    {
+        int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return false;
+        }
+        bool synced = fsync(fd) == 0;
+        close(fd);
+        return synced;
+    }
+}
+
+SaveGame::SaveGame(const std::string& directory)
+    : mDirectory(directory)
+    , mGeneration(0)
+    , mNextLoadEntry(0)
+    , mLoadVersion(VERSION)
+    , mHasJob(false)
+    , mBusy(false)
+    , mStopping(false)
+{
+    mWorker = std::thread(&SaveGame::WorkerLoop, this);
+}
+
+SaveGame::~SaveGame()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mJobReady.notify_all();
+    mWorker.join();
+}
+
+std::string SaveGame::GetManifestPath() const
+{
+    return mDirectory + "/manifest.bin";
+}
+
+std::string SaveGame::GetChunkPath(uint32_t kind, uint32_t index, uint32_t generation) const
+{
+    return mDirectory + "/" + KIND_NAMES[kind] + "_" + std::to_string(index) + "_" +
+           std::to_string(generation) + ".chunk";
+}
+
+bool SaveGame::BeginLoad()
+{
+    std::ifstream file(GetManifestPath(), std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+
+    ManifestHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.magic != MAGIC || header.version < MIN_VERSION || header.version > VERSION ||
+        header.chunkCount > MAX_CHUNKS)
+    {
+        std::cout << "ERROR::SAVEGAME: " << GetManifestPath() << " has an invalid header" << std::endl;
+        return false;
+    }
+
+    std::vector<ManifestEntry> entries(header.chunkCount);
+    if (!file.read(reinterpret_cast<char*>(entries.data()), entries.size() * sizeof(ManifestEntry)) ||
+        Fnv1a(reinterpret_cast<const uint8_t*>(entries.data()), entries.size() * sizeof(ManifestEntry)) != header.checksum)
+    {
+        std::cout << "ERROR::SAVEGAME: " << GetManifestPath() << " is corrupt" << std::endl;
+        return false;
+    }
+    for (const ManifestEntry& entry : entries)
+    {
+        if (entry.kind >= static_cast<uint32_t>(ChunkKind::Count) || entry.itemCount > CHUNK_ITEMS)
+        {
+            std::cout << "ERROR::SAVEGAME: " << GetManifestPath() << " lists an invalid chunk" << std::endl;
+            return false;
+        }
+    }
+
+    mGeneration = header.generation;
+    mLoadVersion = header.version;
+    if (mLoadVersion == VERSION)
+    {
+        mEntries = entries;
+    }
+    else
+    {
+        // Older chunks can't be reused as-is: treat them all as superseded
+        // so the next save rewrites every chunk in the current format
+        mEntries.clear();
+        mOrphans = entries;
+    }
+    mLoadEntries = std::move(entries);
+    mNextLoadEntry = 0;
+    return true;
+}
+
+bool SaveGame::LoadNextChunk(Chunk& outChunk)
+{
+    while (mNextLoadEntry < mLoadEntries.size())
+    {
+        const ManifestEntry& entry = mLoadEntries[mNextLoadEntry++];
+        if (ReadChunk(entry, outChunk))
+        {
+            // Loaded records count as saved; new ones append after them
+            mRecipes.insert(mRecipes.end(), outChunk.recipes.begin(), outChunk.recipes.end());
+            mDiscovered.insert(mDiscovered.end(), outChunk.discovered.begin(), outChunk.discovered.end());
+            return true;
+        }
+
+        std::cout << "ERROR::SAVEGAME: Skipping unreadable chunk "
+                  << GetChunkPath(entry.kind, entry.index, entry.generation) << std::endl;
+        // Records after a lost append-only chunk shift down, so those chunks
+        // no longer match their saved copies
+        if (entry.kind != static_cast<uint32_t>(ChunkKind::Board))
+        {
+            DropEntries(entry.kind, entry.index);
+        }
+    }
+
+    mLoadEntries.clear();
+    mLoadEntries.shrink_to_fit();
+    mNextLoadEntry = 0;
+    return false;
+}
+
+bool SaveGame::ReadChunk(const ManifestEntry& entry, Chunk& outChunk) const
+{
+    std::ifstream file(GetChunkPath(entry.kind, entry.index, entry.generation), std::ios::binary);
+    ChunkHeader header;
+    if (!file || !file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+    {
+        return false;
+    }
+    if (header.magic != CHUNK_MAGIC || header.kind != entry.kind || header.index != entry.index ||
+        header.itemCount != entry.itemCount || header.payloadSize != entry.payloadSize ||
+        header.checksum != entry.checksum)
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> payload(header.payloadSize);
+    if (!file.read(reinterpret_cast<char*>(payload.data()), payload.size()) ||
+        Fnv1a(payload.data(), payload.size()) != header.checksum)
+    {
+        return false;
+    }
+
+    outChunk.kind = static_cast<ChunkKind>(entry.kind);
+    outChunk.recipes.clear();
+    outChunk.discovered.clear();
+    outChunk.tiles.clear();
+
+    Reader reader{ payload.data(), payload.size(), 0, true, mLoadVersion < 2 };
+    for (uint32_t i = 0; i < header.itemCount && reader.ok; i++)
+    {
+        switch (outChunk.kind)
+        {
+            case ChunkKind::Recipes:
+            {
+                RecipeRecord recipe;
+                recipe.a = reader.GetName();
+                recipe.b = reader.GetName();
+                recipe.result = reader.GetName();
+                outChunk.recipes.push_back(recipe);
+                break;
+            }
+            case ChunkKind::Discovered:
+                outChunk.discovered.push_back(reader.GetName());
+                break;
+            case ChunkKind::Board:
+            {
+                TileRecord tile;
+                tile.position.x = reader.Get<float>();
+                tile.position.y = reader.Get<float>();
+                tile.scale.x = reader.Get<float>();
+                tile.scale.y = reader.Get<float>();
+                tile.rotation = reader.Get<float>();
+                tile.name = reader.GetName();
+                outChunk.tiles.push_back(tile);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return reader.ok && reader.offset == reader.size;
+}
+
+void SaveGame::DropEntries(uint32_t kind, uint32_t fromIndex)
+{
+    std::vector<ManifestEntry> kept;
+    for (const ManifestEntry& entry : mEntries)
+    {
+        if (entry.kind != kind || entry.index < fromIndex)
+        {
+            kept.push_back(entry);
+        }
+        else
+        {
+            mOrphans.push_back(entry);
+        }
+    }
+    mEntries.swap(kept);
+}
+
+void SaveGame::AddRecipe(NameId a, NameId b, NameId result)
+{
+    mPendingRecipes.push_back(RecipeRecord{ a, b, result });
+}
+
+void SaveGame::AddDiscovery(NameId name)
+{
+    mPendingDiscoveries.push_back(name);
+}
+
+bool SaveGame::Autosave(std::vector<TileRecord>& board)
+{
+    if (IsLoading())
+    {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mHasJob || mBusy)
+        {
+            return false;
+        }
+        // Swaps hand back the previous job's (emptied) buffers for reuse
+        mJob.recipes.swap(mPendingRecipes);
+        mJob.discovered.swap(mPendingDiscoveries);
+        mJob.board.swap(board);
+        mHasJob = true;
+    }
+    mJobReady.notify_one();
+    return true;
+}
+
+void SaveGame::Wait()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mIdle.wait(lock, [this] { return !mHasJob && !mBusy; });
+}
+
+void SaveGame::WorkerLoop()
+{
+    Job job;
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true)
+    {
+        mJobReady.wait(lock, [this] { return mStopping || mHasJob; });
+        if (!mHasJob)
+        {
+            return;
+        }
+
+        job.recipes.swap(mJob.recipes);
+        job.discovered.swap(mJob.discovered);
+        job.board.swap(mJob.board);
+        mHasJob = false;
+        mBusy = true;
+        lock.unlock();
+
+        WriteSave(job);
+        job.recipes.clear();
+        job.discovered.clear();
+        job.board.clear();
+
+        lock.lock();
+        mBusy = false;
+        mIdle.notify_all();
+    }
+}
+
+void SaveGame::SerializeChunk(ChunkKind kind, uint32_t index, const std::vector<TileRecord>& board,
+                              std::vector<uint8_t>& outPayload) const
+{
+    outPayload.clear();
+    size_t first = static_cast<size_t>(index) * CHUNK_ITEMS;
+    switch (kind)
+    {
+        case ChunkKind::Recipes:
+            for (size_t i = first; i < mRecipes.size() && i < first + CHUNK_ITEMS; i++)
+            {
+                PutName(outPayload, mRecipes[i].a);
+                PutName(outPayload, mRecipes[i].b);
+                PutName(outPayload, mRecipes[i].result);
+            }
+            break;
+        case ChunkKind::Discovered:
+            for (size_t i = first; i < mDiscovered.size() && i < first + CHUNK_ITEMS; i++)
+            {
+                PutName(outPayload, mDiscovered[i]);
+            }
+            break;
+        case ChunkKind::Board:
+            for (size_t i = first; i < board.size() && i < first + CHUNK_ITEMS; i++)
+            {
+                const TileRecord& tile = board[i];
+                Put(outPayload, tile.position.x);
+                Put(outPayload, tile.position.y);
+                Put(outPayload, tile.scale.x);
+                Put(outPayload, tile.scale.y);
+                Put(outPayload, tile.rotation);
+                PutName(outPayload, tile.name);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void SaveGame::WriteSave(Job& job)
+{
+    mRecipes.insert(mRecipes.end(), job.recipes.begin(), job.recipes.end());
+    mDiscovered.insert(mDiscovered.end(), job.discovered.begin(), job.discovered.end());
+
+    uint32_t generation = mGeneration + 1;
+    mkdir(mDirectory.c_str(), 0755);
+
+    std::vector<ManifestEntry> entries;
+    std::vector<std::string> written;
+    std::vector<uint8_t> payload;
+    bool failed = false;
+
+    for (uint32_t kind = 0; kind < static_cast<uint32_t>(ChunkKind::Count) && !failed; kind++)
+    {
+        size_t items = kind == static_cast<uint32_t>(ChunkKind::Recipes) ? mRecipes.size()
+                     : kind == static_cast<uint32_t>(ChunkKind::Discovered) ? mDiscovered.size()
+                     : job.board.size();
+        uint32_t chunkCount = static_cast<uint32_t>((items + CHUNK_ITEMS - 1) / CHUNK_ITEMS);
+
+        for (uint32_t index = 0; index < chunkCount; index++)
+        {
+            uint32_t itemCount = static_cast<uint32_t>(std::min<size_t>(CHUNK_ITEMS, items - static_cast<size_t>(index) * CHUNK_ITEMS));
+            const ManifestEntry* saved = nullptr;
+            for (const ManifestEntry& entry : mEntries)
+            {
+                if (entry.kind == kind && entry.index == index)
+                {
+                    saved = &entry;
+                    break;
+                }
+            }
+
+            // Append-only chunks with the same record count are unchanged
+            if (saved && kind != static_cast<uint32_t>(ChunkKind::Board) && saved->itemCount == itemCount)
+            {
+                entries.push_back(*saved);
+                continue;
+            }
+
+            SerializeChunk(static_cast<ChunkKind>(kind), index, job.board, payload);
+            uint64_t checksum = Fnv1a(payload.data(), payload.size());
+            if (saved && saved->itemCount == itemCount && saved->payloadSize == payload.size() && saved->checksum == checksum)
+            {
+                entries.push_back(*saved);
+                continue;
+            }
+
+            ManifestEntry entry{ kind, index, itemCount, generation, payload.size(), checksum };
+            ChunkHeader header{ CHUNK_MAGIC, kind, index, itemCount, payload.size(), checksum };
+            std::string path = GetChunkPath(kind, index, generation);
+            if (!WriteFile(path, &header, sizeof(header), payload))
+            {
+                std::cout << "ERROR::SAVEGAME: Could not write " << path << std::endl;
+                failed = true;
+                break;
+            }
+            written.push_back(path);
+            entries.push_back(entry);
+        }
+    }
+
+    bool changed = entries.size() != mEntries.size() || !written.empty();
+    if (!failed && changed)
+    {
+        ManifestHeader header{ MAGIC, VERSION, generation, static_cast<uint32_t>(entries.size()), 0 };
+        header.checksum = Fnv1a(reinterpret_cast<const uint8_t*>(entries.data()), entries.size() * sizeof(ManifestEntry));
+        const uint8_t* entryBytes = reinterpret_cast<const uint8_t*>(entries.data());
+        payload.assign(entryBytes, entryBytes + entries.size() * sizeof(ManifestEntry));
+
+        // The rename is the commit point: until then the old manifest stays valid
+        std::string manifestPath = GetManifestPath();
+        std::string tempPath = manifestPath + ".tmp";
+        if (!WriteFile(tempPath, &header, sizeof(header), payload))
+        {
+            std::cout << "ERROR::SAVEGAME: Could not write " << tempPath << std::endl;
+            failed = true;
+        }
+        else if (std::rename(tempPath.c_str(), manifestPath.c_str()) != 0)
+        {
+            std::cout << "ERROR::SAVEGAME: Could not rename " << tempPath << " to " << manifestPath << std::endl;
+            std::remove(tempPath.c_str());
+            failed = true;
+        }
+        else if (!SyncDirectory(mDirectory))
+        {
+            // Committed, but the rename may not survive a power loss yet;
+            // the next save syncs again
+            std::cout << "ERROR::SAVEGAME: Could not sync " << mDirectory << std::endl;
+        }
+    }
+
+    if (failed)
+    {
+        // The old save is untouched; retry everything next time
+        for (const std::string& path : written)
+        {
+            std::remove(path.c_str());
+        }
+        return;
+    }
+
+    // Delete chunk files the new manifest no longer references
+    mOrphans.insert(mOrphans.end(), mEntries.begin(), mEntries.end());
+    for (const ManifestEntry& old : mOrphans)
+    {
+        bool kept = false;
+        for (const ManifestEntry& entry : entries)
+        {
+            if (entry.kind == old.kind && entry.index == old.index && entry.generation == old.generation)
+            {
+                kept = true;
+                break;
+            }
+        }
+        if (!kept)
+        {
+            std::remove(GetChunkPath(old.kind, old.index, old.generation).c_str());
+        }
+    }
+
+    mOrphans.clear();
+    if (changed)
+    {
+        mGeneration = generation;
+    }
+    mEntries.swap(entries);
+}
@@ -0,0 +1,183 @@
+// ----------------------------------------------------------------
+// SaveGame: chunked, versioned binary save with streaming load and
+// incremental background autosave
+//
+// A save is a directory holding one file per chunk plus a manifest:
+//   manifest.bin                  ManifestHeader, ManifestEntry[chunkCount]
+//   <kind>_<index>_<gen>.chunk    ChunkHeader, payload
+//
+// Chunks hold up to CHUNK_ITEMS records of one kind (generated
+// recipes, discovered elements, board tiles). Names are stored as
+// length-prefixed strings since name IDs are only meaningful within
+// one process (version 1 used 16-bit lengths; such saves still load
+// and are rewritten in full by the next save).
+// Recipes and discoveries are append-only, so only their last chunk
+// changes between saves; board chunks are rewritten only when their
+// contents (checksum) differ from the saved copy.
+//
+// Chunk files are never overwritten: a save writes changed chunks
+// under a new generation, then atomically renames the new manifest
+// into place and deletes the files it superseded. Every file is synced
+// before the rename and the directory after it, so a crash or power
+// loss at any point leaves a manifest whose files are all on disk.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../Math.h"
+#include "../StringTable/StringTable.hpp"
+
+class SaveGame
+{
+public:
+    static constexpr uint32_t MAGIC = 0x56534349;       // "ICSV"
+    static constexpr uint32_t CHUNK_MAGIC = 0x4b4e4843; // "CHNK"
+    static constexpr uint32_t VERSION = 2;
+    // Oldest version BeginLoad accepts
+    static constexpr uint32_t MIN_VERSION = 1;
+    static constexpr uint32_t CHUNK_ITEMS = 4096;
+    // Sanity limit for manifests read from disk
+    static constexpr uint32_t MAX_CHUNKS = 1u << 20;
+
+    // Chunk kinds, in load order
+    enum class ChunkKind : uint32_t
+    {
+        Recipes = 0,
+        Discovered = 1,
+        Board = 2,
+        Count
+    };
+
+    struct ManifestHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t generation;
+        uint32_t chunkCount;
+        // FNV-1a over the entries
+        uint64_t checksum;
+    };
+
+    struct ManifestEntry
+    {
+        uint32_t kind;
+        uint32_t index;
+        uint32_t itemCount;
+        // Generation that wrote the chunk file
+        uint32_t generation;
+        uint64_t payloadSize;
+        uint64_t checksum;
+    };
+
+    struct ChunkHeader
+    {
+        uint32_t magic;
+        uint32_t kind;
+        uint32_t index;
+        uint32_t itemCount;
+        uint64_t payloadSize;
+        // FNV-1a over the payload
+        uint64_t checksum;
+    };
+
+    struct RecipeRecord
+    {
+        NameId a;
+        NameId b;
+        NameId result;
+    };
+
+    struct TileRecord
+    {
+        NameId name;
+        Vector2 position;
+        Vector2 scale;
+        float rotation;
+    };
+
+    // One decoded chunk; vectors are reused between LoadNextChunk calls
+    struct Chunk
+    {
+        ChunkKind kind;
+        std::vector<RecipeRecord> recipes;
+        std::vector<NameId> discovered;
+        std::vector<TileRecord> tiles;
+    };
+
+    explicit SaveGame(const std::string& directory);
+    ~SaveGame();
+    SaveGame(const SaveGame&) = delete;
+    SaveGame& operator=(const SaveGame&) = delete;
+
+    // Read the manifest; returns false if there is no usable save
+    bool BeginLoad();
+    bool IsLoading() const { return mNextLoadEntry < mLoadEntries.size(); }
+    // Read and decode the next chunk (one file). Returns false when the
+    // load is finished; corrupt chunks are logged and skipped.
+    bool LoadNextChunk(Chunk& outChunk);
+
+    // Record progress made since the last save (main thread)
+    void AddRecipe(NameId a, NameId b, NameId result);
+    void AddDiscovery(NameId name);
+    bool HasUnsavedProgress() const { return !mPendingRecipes.empty() || !mPendingDiscoveries.empty(); }
+
+    // Hand the board and recorded progress to the save thread. Returns
+    // false (keeping everything for the next attempt) while a load is in
+    // progress or the previous save is still being written.
+    bool Autosave(std::vector<TileRecord>& board);
+    // Block until the save thread is idle
+    void Wait();
+
+private:
+    struct Job
+    {
+        std::vector<RecipeRecord> recipes;
+        std::vector<NameId> discovered;
+        std::vector<TileRecord> board;
+    };
+
+    std::string GetManifestPath() const;
+    std::string GetChunkPath(uint32_t kind, uint32_t index, uint32_t generation) const;
+    bool ReadChunk(const ManifestEntry& entry, Chunk& outChunk) const;
+    void WorkerLoop();
+    void WriteSave(Job& job);
+    void SerializeChunk(ChunkKind kind, uint32_t index, const std::vector<TileRecord>& board,
+                        std::vector<uint8_t>& outPayload) const;
+    // Forget saved chunks of a kind from index on (their records shifted)
+    void DropEntries(uint32_t kind, uint32_t fromIndex);
+
+    std::string mDirectory;
+
+    // Manifest of the save on disk (load: main thread; afterwards: save thread)
+    uint32_t mGeneration;
+    std::vector<ManifestEntry> mEntries;
+    // Files on disk no longer in mEntries; deleted after the next save
+    std::vector<ManifestEntry> mOrphans;
+    std::vector<ManifestEntry> mLoadEntries;
+    size_t mNextLoadEntry;
+    // Format version of the save being loaded
+    uint32_t mLoadVersion;
+
+    // Everything saved or being saved, in record order (same ownership as mEntries)
+    std::vector<RecipeRecord> mRecipes;
+    std::vector<NameId> mDiscovered;
+
+    // Recorded since the last Autosave (main thread only)
+    std::vector<RecipeRecord> mPendingRecipes;
+    std::vector<NameId> mPendingDiscoveries;
+
+    std::mutex mMutex;
+    std::condition_variable mJobReady;
+    std::condition_variable mIdle;
+    Job mJob;
+    bool mHasJob;
+    bool mBusy;
+    bool mStopping;
+    std::thread mWorker;
+};
@@ -0,0 +1,389 @@
+// ----------------------------------------------------------------
+// SearchIndex: incremental trigram index over interned names
+// ----------------------------------------------------------------
+
+#include "SearchIndex.hpp"
+#include <algorithm>
+#include <cctype>
+
+SearchIndex::SearchIndex()
+    : mPendingMaxResults(0)
+    , mSubmitted(0)
+    , mStarted(0)
+    , mCompleted(0)
+    , mDelivered(0)
+    , mAddedCount(0)
+    , mStopping(false)
+{
+    mLowerOffsets.push_back(0);
+    mWorker = std::thread(&SearchIndex::WorkerLoop, this);
+}
+
+SearchIndex::~SearchIndex()
+{
+    {
+        std::lock_guard<std::mutex> lock(mQueryMutex);
+        mStopping = true;
+    }
+    mQueryReady.notify_all();
+    mWorker.join();
+}
+
+std::string SearchIndex::ToLower(std::string_view text)
+{
+    std::string lower(text);
+    for (char& c : lower)
+    {
+        // ASCII only; UTF-8 continuation bytes pass through unchanged
+        if (c >= 'A' && c <= 'Z')
+        {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+    return lower;
+}
+
+void SearchIndex::AddKey(uint32_t key, uint32_t doc)
+{
+    // Documents are added in ascending order, so postings stay sorted and
+    // a repeated trigram within one name only needs a back() check
+    std::vector<uint32_t>& postings = mPostings[key];
+    if (postings.empty() || postings.back() != doc)
+    {
+        postings.push_back(doc);
+    }
+}
+
+void SearchIndex::Add(NameId name)
+{
+    {
+        std::lock_guard<std::mutex> lock(mQueryMutex);
+        mPendingAdds.push_back(name);
+        mAddedCount++;
+    }
+    // The worker indexes it as soon as no query holds the index
+    mQueryReady.notify_one();
+}
+
+size_t SearchIndex::GetCount() const
+{
+    std::lock_guard<std::mutex> lock(mQueryMutex);
+    return mAddedCount;
+}
+
+void SearchIndex::ApplyPendingAdds()
+{
+    std::vector<NameId> names;
+    {
+        std::lock_guard<std::mutex> lock(mQueryMutex);
+        names.swap(mPendingAdds);
+    }
+    for (NameId name : names)
+    {
+        IndexName(name);
+    }
+}
+
+void SearchIndex::IndexName(NameId name)
+{
+    std::string lower = ToLower(StringTable::Get().GetString(name));
+
+    uint32_t doc = static_cast<uint32_t>(mDocs.size());
+    mDocs.push_back(name);
+    mLowerPool += lower;
+    mLowerOffsets.push_back(static_cast<uint32_t>(mLowerPool.size()));
+
+    const unsigned char* text = reinterpret_cast<const unsigned char*>(lower.data());
+    size_t length = lower.size();
+    for (size_t i = 0; i + 2 < length; ++i)
+    {
+        AddKey(MakeKey(text[i], text[i + 1], text[i + 2]), doc);
+    }
+
+    // Word starts: "<start>x" for one-letter and "<start>xy" for two-letter queries
+    for (size_t i = 0; i < length; ++i)
+    {
+        if (text[i] == ' ' || (i > 0 && text[i - 1] != ' '))
+        {
+            continue;
+        }
+        AddKey(MakePrefixKey(text[i]), doc);
+        if (i + 1 < length)
+        {
+            AddKey(MakeKey(WORD_START, text[i], text[i + 1]), doc);
+        }
+    }
+}
+
+const std::vector<uint32_t>* SearchIndex::FindPostings(uint32_t key) const
+{
+    auto it = mPostings.find(key);
+    return it != mPostings.end() ? &it->second : nullptr;
+}
+
+size_t SearchIndex::EstimateCost(const std::string& lowerQuery) const
+{
+    const unsigned char* text = reinterpret_cast<const unsigned char*>(lowerQuery.data());
+    size_t length = lowerQuery.size();
+    const std::vector<uint32_t>* postings = nullptr;
+    if (length == 1)
+    {
+        postings = FindPostings(MakePrefixKey(text[0]));
+    }
+    else if (length == 2)
+    {
+        postings = FindPostings(MakeKey(WORD_START, text[0], text[1]));
+    }
+    else
+    {
+        size_t cost = 0;
+        for (size_t i = 0; i + 2 < length; ++i)
+        {
+            postings = FindPostings(MakeKey(text[i], text[i + 1], text[i + 2]));
+            cost += postings ? postings->size() : 0;
+        }
+        return cost;
+    }
+    return postings ? postings->size() : 0;
+}
+
+float SearchIndex::ScoreDocument(uint32_t doc, const std::string& lowerQuery) const
+{
+    std::string_view name(mLowerPool.data() + mLowerOffsets[doc], mLowerOffsets[doc + 1] - mLowerOffsets[doc]);
+
+    // Tier first, then prefer shorter names within a tier
+    float lengthPenalty = std::min(static_cast<float>(name.size()), 99.0f);
+    if (name == lowerQuery)
+    {
+        return 4000.0f;
+    }
+    size_t position = name.find(lowerQuery);
+    if (position == 0)
+    {
+        return 3000.0f - lengthPenalty;
+    }
+    if (position != std::string_view::npos)
+    {
+        return (name[position - 1] == ' ' ? 2000.0f : 1000.0f) - lengthPenalty;
+    }
+    return 0.0f;
+}
+
+void SearchIndex::SearchLocked(const std::string& lowerQuery, size_t maxResults, std::vector<Match>& outMatches) const
+{
+    outMatches.clear();
+    if (lowerQuery.empty() || maxResults == 0)
+    {
+        return;
+    }
+
+    const unsigned char* text = reinterpret_cast<const unsigned char*>(lowerQuery.data());
+    size_t length = lowerQuery.size();
+
+    if (length < 3)
+    {
+        // Too short for trigrams: word-prefix matches only
+        const std::vector<uint32_t>* postings = length == 1
+            ? FindPostings(MakePrefixKey(text[0]))
+            : FindPostings(MakeKey(WORD_START, text[0], text[1]));
+        if (postings)
+        {
+            for (uint32_t doc : *postings)
+            {
+                outMatches.push_back({ mDocs[doc], ScoreDocument(doc, lowerQuery) });
+            }
+        }
+    }
+    else
+    {
+        // Count shared trigrams per document; substrings share all of them,
+        // typos still share most
+        std::vector<uint32_t> keys;
+        for (size_t i = 0; i + 2 < length; ++i)
+        {
+            keys.push_back(MakeKey(text[i], text[i + 1], text[i + 2]));
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+        std::lock_guard<std::mutex> scratchLock(mScratchMutex);
+        if (mCounts.size() < mDocs.size())
+        {
+            mCounts.resize(mDocs.size(), 0);
+        }
+        mTouched.clear();
+        for (uint32_t key : keys)
+        {
+            const std::vector<uint32_t>* postings = FindPostings(key);
+            if (!postings)
+            {
+                continue;
+            }
+            for (uint32_t doc : *postings)
+            {
+                if (mCounts[doc]++ == 0)
+                {
+                    mTouched.push_back(doc);
+                }
+            }
+        }
+
+        size_t required = (keys.size() + 1) / 2;
+        for (uint32_t doc : mTouched)
+        {
+            size_t shared = mCounts[doc];
+            mCounts[doc] = 0;
+            if (shared < required)
+            {
+                continue;
+            }
+            float score = shared == keys.size() ? ScoreDocument(doc, lowerQuery) : 0.0f;
+            if (score <= 0.0f)
+            {
+                // Fuzzy: fraction of query trigrams present, damped by extra length
+                size_t docLength = mLowerOffsets[doc + 1] - mLowerOffsets[doc];
+                float overlap = static_cast<float>(shared) / static_cast<float>(keys.size());
+                float lengthRatio = static_cast<float>(length) / static_cast<float>(std::max(docLength, length));
+                score = 900.0f * overlap * (0.5f + 0.5f * lengthRatio);
+            }
+            outMatches.push_back({ mDocs[doc], score });
+        }
+    }
+
+    // Stable ordering on ties keeps earlier discoveries first
+    auto better = [](const Match& a, const Match& b)
+    {
+        return a.score > b.score || (a.score == b.score && a.name < b.name);
+    };
+    if (outMatches.size() > maxResults)
+    {
+        std::partial_sort(outMatches.begin(), outMatches.begin() + maxResults, outMatches.end(), better);
+        outMatches.resize(maxResults);
+    }
+    else
+    {
+        std::sort(outMatches.begin(), outMatches.end(), better);
+    }
+}
+
+void SearchIndex::Search(std::string_view query, size_t maxResults, std::vector<Match>& outMatches)
+{
+    std::string lower = ToLower(query);
+    {
+        std::unique_lock<std::shared_mutex> writeLock(mIndexMutex);
+        ApplyPendingAdds();
+    }
+    std::shared_lock<std::shared_mutex> lock(mIndexMutex);
+    SearchLocked(lower, maxResults, outMatches);
+}
+
+void SearchIndex::Submit(std::string_view query, size_t maxResults)
+{
+    std::string lower = ToLower(query);
+
+    // Fold in new names unless a background query is scanning the index
+    {
+        std::unique_lock<std::shared_mutex> writeLock(mIndexMutex, std::try_to_lock);
+        if (writeLock.owns_lock())
+        {
+            ApplyPendingAdds();
+        }
+    }
+
+    {
+        std::shared_lock<std::shared_mutex> lock(mIndexMutex);
+        bool indexBehind;
+        {
+            std::lock_guard<std::mutex> queryLock(mQueryMutex);
+            indexBehind = !mPendingAdds.empty();
+        }
+        // A query over a stale index goes to the worker, which indexes
+        // the queued names first
+        if (!indexBehind && EstimateCost(lower) <= ASYNC_COST_THRESHOLD)
+        {
+            std::vector<Match> matches;
+            SearchLocked(lower, maxResults, matches);
+
+            std::lock_guard<std::mutex> queryLock(mQueryMutex);
+            // Supersede anything still running in the background
+            mSubmitted++;
+            mStarted = mSubmitted;
+            mCompleted = mSubmitted;
+            mResults.swap(matches);
+            return;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> queryLock(mQueryMutex);
+        mSubmitted++;
+        mPendingQuery = std::move(lower);
+        mPendingMaxResults = maxResults;
+    }
+    mQueryReady.notify_one();
+}
+
+bool SearchIndex::Poll(std::vector<Match>& outMatches)
+{
+    std::lock_guard<std::mutex> lock(mQueryMutex);
+    if (mCompleted != mSubmitted || mDelivered == mCompleted)
+    {
+        return false;
+    }
+    mDelivered = mCompleted;
+    outMatches.swap(mResults);
+    return true;
+}
+
+bool SearchIndex::IsQueryPending() const
+{
+    std::lock_guard<std::mutex> lock(mQueryMutex);
+    return mDelivered != mSubmitted;
+}
+
+void SearchIndex::WorkerLoop()
+{
+    std::vector<Match> matches;
+    std::unique_lock<std::mutex> lock(mQueryMutex);
+    while (true)
+    {
+        mQueryReady.wait(lock, [this] { return mStopping || mStarted != mSubmitted || !mPendingAdds.empty(); });
+        if (mStopping)
+        {
+            return;
+        }
+
+        if (!mPendingAdds.empty())
+        {
+            lock.unlock();
+            {
+                std::unique_lock<std::shared_mutex> indexLock(mIndexMutex);
+                ApplyPendingAdds();
+            }
+            lock.lock();
+            if (mStarted == mSubmitted)
+            {
+                continue;
+            }
+        }
+
+        uint64_t generation = mSubmitted;
+        std::string query = mPendingQuery;
+        size_t maxResults = mPendingMaxResults;
+        mStarted = generation;
+        lock.unlock();
+
+        {
+            std::shared_lock<std::shared_mutex> indexLock(mIndexMutex);
+            SearchLocked(query, maxResults, matches);
+        }
+
+        lock.lock();
+        // Drop results for a query the user has already typed past
+        if (generation == mSubmitted)
+        {
+            mCompleted = generation;
+            mResults.swap(matches);
+        }
+    }
+}
@@ -0,0 +1,113 @@
+// ----------------------------------------------------------------
+// SearchIndex: incremental trigram index over interned names
+//
+// Names are lower-cased and split into trigrams; each trigram maps to
+// the (ascending) list of documents containing it, so adding a name
+// only appends to a few posting lists. Word starts are also indexed
+// so one- and two-letter queries resolve as word-prefix lookups.
+// Matches are ranked exact > prefix > word prefix > substring > fuzzy.
+//
+// Queries whose posting lists are large run on a background thread;
+// Submit/Poll let the caller keep rendering while they finish. Added
+// names are queued and folded into the index whenever no query is
+// scanning it, so Add never waits for a running query.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "../StringTable/StringTable.hpp"
+
+class SearchIndex
+{
+public:
+    struct Match
+    {
+        NameId name;
+        float score;
+    };
+
+    SearchIndex();
+    ~SearchIndex();
+    SearchIndex(const SearchIndex&) = delete;
+    SearchIndex& operator=(const SearchIndex&) = delete;
+
+    // Index a name (call once per name). Never blocks on a running query.
+    void Add(NameId name);
+    // Names added so far, including ones not indexed yet
+    size_t GetCount() const;
+
+    // Ranked matches for query, best first (synchronous; waits for a
+    // running query to index names added since)
+    void Search(std::string_view query, size_t maxResults, std::vector<Match>& outMatches);
+
+    // Start a query; cheap ones complete immediately, expensive ones run on
+    // the background thread. A newer Submit supersedes an unfinished one.
+    void Submit(std::string_view query, size_t maxResults);
+    // True (and fills outMatches) once results for the latest Submit are ready
+    bool Poll(std::vector<Match>& outMatches);
+    // True while the latest Submit's results haven't been polled yet
+    bool IsQueryPending() const;
+
+    // Queries touching more postings than this run off the main thread
+    static constexpr size_t ASYNC_COST_THRESHOLD = 20000;
+
+private:
+    static uint32_t MakeKey(unsigned char a, unsigned char b, unsigned char c)
+    {
+        return (static_cast<uint32_t>(a) << 16) | (static_cast<uint32_t>(b) << 8) | c;
+    }
+    // Word-start marker; never appears in lower-cased text
+    static constexpr unsigned char WORD_START = 0x02;
+    // One-letter word-prefix keys live above the trigram key space
+    static uint32_t MakePrefixKey(unsigned char c) { return 0x01000000u | c; }
+
+    static std::string ToLower(std::string_view text);
+    void AddKey(uint32_t key, uint32_t doc);
+    // Index every queued name; the caller holds mIndexMutex exclusively
+    void ApplyPendingAdds();
+    void IndexName(NameId name);
+    const std::vector<uint32_t>* FindPostings(uint32_t key) const;
+    size_t EstimateCost(const std::string& lowerQuery) const;
+    void SearchLocked(const std::string& lowerQuery, size_t maxResults, std::vector<Match>& outMatches) const;
+    float ScoreDocument(uint32_t doc, const std::string& lowerQuery) const;
+    void WorkerLoop();
+
+    // Documents in insertion order, with their lower-cased text in one pool
+    std::vector<NameId> mDocs;
+    std::vector<uint32_t> mLowerOffsets;
+    std::string mLowerPool;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> mPostings;
+
+    // Readers (queries) vs the writer (ApplyPendingAdds). Taken before
+    // mQueryMutex when both are held.
+    mutable std::shared_mutex mIndexMutex;
+    // Per-document trigram hit counts, reused between queries
+    mutable std::vector<uint16_t> mCounts;
+    mutable std::vector<uint32_t> mTouched;
+    mutable std::mutex mScratchMutex;
+
+    // Background query state
+    mutable std::mutex mQueryMutex;
+    std::condition_variable mQueryReady;
+    std::string mPendingQuery;
+    size_t mPendingMaxResults;
+    uint64_t mSubmitted;
+    uint64_t mStarted;
+    uint64_t mCompleted;
+    uint64_t mDelivered;
+    std::vector<Match> mResults;
+    // Names added but not yet indexed
+    std::vector<NameId> mPendingAdds;
+    size_t mAddedCount;
+    bool mStopping;
+    std::thread mWorker;
+};
@@ -0,0 +1,358 @@
+// ----------------------------------------------------------------
+// SpatialGrid implementation
+// ----------------------------------------------------------------
+
+#include "SpatialGrid.hpp"
+#include "../../Actor/Actor.hpp"
+#include <algorithm>
+
+SpatialGrid::SpatialGrid(float cellSize)
+    : mCellSize(cellSize)
+    , mInvCellSize(1.0f / cellSize)
+    , mOccupied{0, 0, 0, 0}
+    , mHasOccupied(false)
+    , mQueryStamp(0)
+{
+}
+
+void SpatialGrid::Insert(Actor* actor, const Rect& bounds)
+{
+    if (actor->mSpatialHandle >= 0)
+    {
+        Update(actor, bounds);
+        return;
+    }
+
+    int index;
+    if (!mFreeEntries.empty())
+    {
+        index = mFreeEntries.back();
+        mFreeEntries.pop_back();
+    }
+    else
+    {
+        index = static_cast<int>(mEntries.size());
+        mEntries.emplace_back();
+    }
+
+    Entry& entry = mEntries[index];
+    entry.actor = actor;
+    entry.bounds = bounds;
+    entry.cells = ComputeRange(bounds);
+    entry.queryStamp = 0;
+    actor->mSpatialHandle = index;
+
+    AddToCells(index, entry.cells);
+}
+
+void SpatialGrid::Update(Actor* actor, const Rect& bounds)
+{
+    int index = actor->mSpatialHandle;
+    if (index < 0)
+    {
+        Insert(actor, bounds);
+        return;
+    }
+
+    Entry& entry = mEntries[index];
+    entry.bounds = bounds;
+
+    // Common case: a small move that stays inside the same cells
+    CellRange range = ComputeRange(bounds);
+    if (range == entry.cells)
+    {
+        return;
+    }
+
+    RemoveFromCells(index, entry.cells);
+    entry.cells = range;
+    AddToCells(index, range);
+}
+
+void SpatialGrid::Remove(Actor* actor)
+{
+    int index = actor->mSpatialHandle;
+    if (index < 0)
+    {
+        return;
+    }
+
+    RemoveFromCells(index, mEntries[index].cells);
+    mEntries[index].actor = nullptr;
+    mFreeEntries.push_back(index);
+    actor->mSpatialHandle = -1;
+}
+
+const Rect& SpatialGrid::GetBounds(const Actor* actor) const
+{
+    return mEntries[actor->mSpatialHandle].bounds;
+}
+
+void SpatialGrid::Clear()
+{
+    for (Entry& entry : mEntries)
+    {
+        if (entry.actor)
+        {
+            entry.actor->mSpatialHandle = -1;
+        }
+    }
+    mEntries.clear();
+    mFreeEntries.clear();
+    mCells.clear();
+    mHasOccupied = false;
+}
+
+void SpatialGrid::QueryPoint(const Vector2& point, std::vector<Actor*>& outActors) const
+{
+    outActors.clear();
+
+    // A point lies in exactly one cell, and every actor covering it is registered there
+    const std::vector<int>* cell = FindCell(ToCell(point.x), ToCell(point.y));
+    if (!cell)
+    {
+        return;
+    }
+
+    for (int index : *cell)
+    {
+        const Entry& entry = mEntries[index];
+        if (entry.bounds.Contains(point))
+        {
+            outActors.push_back(entry.actor);
+        }
+    }
+}
+
+void SpatialGrid::QueryRect(const Rect& rect, std::vector<Actor*>& outActors) const
+{
+    outActors.clear();
+
+    CellRange range = ComputeRange(rect);
+    uint32_t stamp = NextQueryStamp();
+
+    // Rects larger than the occupied area only need to scan the occupied cells
+    if (mHasOccupied)
+    {
+        range.minX = Math::Max(range.minX, mOccupied.minX);
+        range.minY = Math::Max(range.minY, mOccupied.minY);
+        range.maxX = Math::Min(range.maxX, mOccupied.maxX);
+        range.maxY = Math::Min(range.maxY, mOccupied.maxY);
+    }
+
+    // Walking every cell of a huge, sparse range is slower than scanning the entries
+    int64_t cellCount = static_cast<int64_t>(range.maxX - range.minX + 1) *
+                        static_cast<int64_t>(range.maxY - range.minY + 1);
+    if (cellCount > static_cast<int64_t>(mCells.size()))
+    {
+        for (const auto& cell : mCells)
+        {
+            int32_t x = static_cast<int32_t>(cell.first >> 32);
+            int32_t y = static_cast<int32_t>(cell.first & 0xffffffffu);
+            if (x < range.minX || x > range.maxX || y < range.minY || y > range.maxY)
+            {
+                continue;
+            }
+            for (int index : cell.second)
+            {
+                const Entry& entry = mEntries[index];
+                if (entry.queryStamp != stamp && entry.bounds.Intersects(rect))
+                {
+                    entry.queryStamp = stamp;
+                    outActors.push_back(entry.actor);
+                }
+            }
+        }
+        return;
+    }
+
+    for (int32_t y = range.minY; y <= range.maxY; y++)
+    {
+        for (int32_t x = range.minX; x <= range.maxX; x++)
+        {
+            const std::vector<int>* cell = FindCell(x, y);
+            if (!cell)
+            {
+                continue;
+            }
+            for (int index : *cell)
+            {
+                const Entry& entry = mEntries[index];
+                if (entry.queryStamp != stamp && entry.bounds.Intersects(rect))
+                {
+                    entry.queryStamp = stamp;
+                    outActors.push_back(entry.actor);
+                }
+            }
+        }
+    }
+}
+
+void SpatialGrid::QueryNearest(const Vector2& point, size_t k, std::vector<Actor*>& outActors) const
+{
+    outActors.clear();
+    if (k == 0 || GetCount() == 0)
+    {
+        return;
+    }
+
+    uint32_t stamp = NextQueryStamp();
+    int32_t cx = ToCell(point.x);
+    int32_t cy = ToCell(point.y);
+
+    std::vector<std::pair<float, int>> candidates;
+    auto visitCell = [&](int32_t x, int32_t y) {
+        const std::vector<int>* cell = FindCell(x, y);
+        if (!cell)
+        {
+            return;
+        }
+        for (int index : *cell)
+        {
+            const Entry& entry = mEntries[index];
+            if (entry.queryStamp != stamp)
+            {
+                entry.queryStamp = stamp;
+                candidates.emplace_back(entry.bounds.DistanceSq(point), index);
+            }
+        }
+    };
+
+    // Visit rings of cells at increasing Chebyshev distance from the query cell
+    for (int32_t r = 0; ; r++)
+    {
+        if (r == 0)
+        {
+            visitCell(cx, cy);
+        }
+        else
+        {
+            for (int32_t x = cx - r; x <= cx + r; x++)
+            {
+                visitCell(x, cy - r);
+                visitCell(x, cy + r);
+            }
+            for (int32_t y = cy - r + 1; y <= cy + r - 1; y++)
+            {
+                visitCell(cx - r, y);
+                visitCell(cx + r, y);
+            }
+        }
+
+        bool coveredAll = cx - r <= mOccupied.minX && cx + r >= mOccupied.maxX &&
+                          cy - r <= mOccupied.minY && cy + r >= mOccupied.maxY;
+        if (coveredAll)
+        {
+            break;
+        }
+
+        if (candidates.size() >= k)
+        {
+            // Anything not yet visited lies outside the searched block of cells
+            float blockMinX = (cx - r) * mCellSize;
+            float blockMinY = (cy - r) * mCellSize;
+            float blockMaxX = (cx + r + 1) * mCellSize;
+            float blockMaxY = (cy + r + 1) * mCellSize;
+            float reach = Math::Min(Math::Min(point.x - blockMinX, blockMaxX - point.x),
+                                    Math::Min(point.y - blockMinY, blockMaxY - point.y));
+
+            std::nth_element(candidates.begin(), candidates.begin() + (k - 1), candidates.end());
+            if (candidates[k - 1].first <= reach * reach)
+            {
+                break;
+            }
+        }
+    }
+
+    size_t count = Math::Min(k, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+    for (size_t i = 0; i < count; i++)
+    {
+        outActors.push_back(mEntries[candidates[i].second].actor);
+    }
+}
+
+int32_t SpatialGrid::ToCell(float coord) const
+{
+    float cell = std::floor(coord * mInvCellSize);
+    return static_cast<int32_t>(Math::Clamp(cell, -1.0e9f, 1.0e9f));
+}
+
+SpatialGrid::CellRange SpatialGrid::ComputeRange(const Rect& bounds) const
+{
+    return CellRange{ ToCell(bounds.min.x), ToCell(bounds.min.y),
+                      ToCell(bounds.max.x), ToCell(bounds.max.y) };
+}
+
+void SpatialGrid::AddToCells(int entryIndex, const CellRange& range)
+{
+    for (int32_t y = range.minY; y <= range.maxY; y++)
+    {
+        for (int32_t x = range.minX; x <= range.maxX; x++)
+        {
+            mCells[MakeKey(x, y)].push_back(entryIndex);
+        }
+    }
+
+    if (!mHasOccupied)
+    {
+        mOccupied = range;
+        mHasOccupied = true;
+    }
+    else
+    {
+        mOccupied.minX = Math::Min(mOccupied.minX, range.minX);
+        mOccupied.minY = Math::Min(mOccupied.minY, range.minY);
+        mOccupied.maxX = Math::Max(mOccupied.maxX, range.maxX);
+        mOccupied.maxY = Math::Max(mOccupied.maxY, range.maxY);
+    }
+}
+
+void SpatialGrid::RemoveFromCells(int entryIndex, const CellRange& range)
+{
+    for (int32_t y = range.minY; y <= range.maxY; y++)
+    {
+        for (int32_t x = range.minX; x <= range.maxX; x++)
+        {
+            auto it = mCells.find(MakeKey(x, y));
+            if (it == mCells.end())
+            {
+                continue;
+            }
+
+            // Cells are small, swap-and-pop keeps removal O(cell size)
+            std::vector<int>& cell = it->second;
+            auto found = std::find(cell.begin(), cell.end(), entryIndex);
+            if (found != cell.end())
+            {
+                *found = cell.back();
+                cell.pop_back();
+            }
+            if (cell.empty())
+            {
+                mCells.erase(it);
+            }
+        }
+    }
+}
+
+const std::vector<int>* SpatialGrid::FindCell(int32_t x, int32_t y) const
+{
+    auto it = mCells.find(MakeKey(x, y));
+    return it != mCells.end() ? &it->second : nullptr;
+}
+
+uint32_t SpatialGrid::NextQueryStamp() const
+{
+    mQueryStamp++;
+    if (mQueryStamp == 0)
+    {
+        // Wrapped around: reset stamps so stale values can't collide
+        for (const Entry& entry : mEntries)
+        {
+            entry.queryStamp = 0;
+        }
+        mQueryStamp = 1;
+    }
+    return mQueryStamp;
+}
@@ -0,0 +1,98 @@
+// ----------------------------------------------------------------
+// Uniform-grid spatial index over actor bounds
+// Supports point, rect and k-nearest queries in time proportional
+// to the number of nearby actors, not to the board size
+// ----------------------------------------------------------------
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+#include "../../Math.h"
+
+class Actor;
+
+class SpatialGrid
+{
+public:
+    explicit SpatialGrid(float cellSize = 128.0f);
+
+    // Insert/update/remove an actor. The grid stores its handle in the actor,
+    // so Update is cheap when the actor stays within the same cells.
+    void Insert(Actor* actor, const Rect& bounds);
+    void Update(Actor* actor, const Rect& bounds);
+    void Remove(Actor* actor);
+    void Clear();
+    // Bounds an actor was last inserted or updated with (it must be indexed)
+    const Rect& GetBounds(const Actor* actor) const;
+
+    // Actors whose bounds contain the point
+    void QueryPoint(const Vector2& point, std::vector<Actor*>& outActors) const;
+    // Actors whose bounds overlap the rect
+    void QueryRect(const Rect& rect, std::vector<Actor*>& outActors) const;
+    // Up to k actors closest to the point (by distance to their bounds), nearest first
+    void QueryNearest(const Vector2& point, size_t k, std::vector<Actor*>& outActors) const;
+
+    size_t GetCount() const { return mEntries.size() - mFreeEntries.size(); }
+    float GetCellSize() const { return mCellSize; }
+
+private:
+    struct CellRange
+    {
+        int32_t minX, minY, maxX, maxY;
+        bool operator==(const CellRange& other) const
+        {
+            return minX == other.minX && minY == other.minY &&
+                   maxX == other.maxX && maxY == other.maxY;
+        }
+    };
+
+    struct Entry
+    {
+        Actor* actor;
+        Rect bounds;
+        CellRange cells;
+        // Last query that visited this entry (dedups actors spanning several cells)
+        mutable uint32_t queryStamp;
+    };
+
+    struct CellKeyHash
+    {
+        size_t operator()(uint64_t key) const
+        {
+            // splitmix64 finalizer
+            key ^= key >> 30;
+            key *= 0xbf58476d1ce4e5b9ULL;
+            key ^= key >> 27;
+            key *= 0x94d049bb133111ebULL;
+            key ^= key >> 31;
+            return static_cast<size_t>(key);
+        }
+    };
+
+    static uint64_t MakeKey(int32_t x, int32_t y)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+    }
+
+    int32_t ToCell(float coord) const;
+    CellRange ComputeRange(const Rect& bounds) const;
+    void AddToCells(int entryIndex, const CellRange& range);
+    void RemoveFromCells(int entryIndex, const CellRange& range);
+    const std::vector<int>* FindCell(int32_t x, int32_t y) const;
+    uint32_t NextQueryStamp() const;
+
+    float mCellSize;
+    float mInvCellSize;
+
+    std::vector<Entry> mEntries;
+    std::vector<int> mFreeEntries;
+    std::unordered_map<uint64_t, std::vector<int>, CellKeyHash> mCells;
+
+    // Cell-space extent ever occupied, bounds the k-nearest ring search
+    CellRange mOccupied;
+    bool mHasOccupied;
+
+    mutable uint32_t mQueryStamp;
+};
@@ -0,0 +1,281 @@
+// ----------------------------------------------------------------
+// StaticLayer implementation
+// ----------------------------------------------------------------
+
+#include "StaticLayer.hpp"
+#include "../Camera/Camera.hpp"
+#include "../Logger/Logger.hpp"
+#include "StaticLayerPlanner.hpp"
+
+namespace
+{
+    const char* COMPOSITE_VERTEX_SHADER = R"(
+#version 330 core
+layout (location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
+out vec2 TexCoords;
+
+uniform mat4 projection;
+
+void main()
+{
+    gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
+    TexCoords = vertex.zw;
+}
+)";
+
+    // Chunk textures hold premultiplied colour
+    const char* COMPOSITE_FRAGMENT_SHADER = R"(
+#version 330 core
+in vec2 TexCoords;
+out vec4 color;
+
+uniform sampler2D layer;
+
+void main()
+{
+    color = texture(layer, TexCoords);
+}
+)";
+
+    GLuint CompileShader(GLenum type, const char* source)
+    {
+        GLuint shader = glCreateShader(type);
+        glShaderSource(shader, 1, &source, nullptr);
+        glCompileShader(shader);
+
+        GLint success;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+        if (!success)
+        {
+            GLchar infoLog[1024];
+            glGetShaderInfoLog(shader, 1024, nullptr, infoLog);
+            LOG_ERROR("STATIC_LAYER", "shader compilation failed\n{}", infoLog);
+            glDeleteShader(shader);
+            return 0;
+        }
+        return shader;
+    }
+
+    const int FLOATS_PER_QUAD = 6 * 4;
+}
+
+StaticLayer::StaticLayer()
+    : mBakeCount(0)
+    , mProgram(0)
+    , mVAO(0)
+    , mVBO(0)
+{
+}
+
+StaticLayer::~StaticLayer()
+{
+    // GL objects go in Shutdown, while the context still exists
+}
+
+bool StaticLayer::Initialize()
+{
+    GLuint vertex = CompileShader(GL_VERTEX_SHADER, COMPOSITE_VERTEX_SHADER);
+    GLuint fragment = CompileShader(GL_FRAGMENT_SHADER, COMPOSITE_FRAGMENT_SHADER);
+    if (!vertex || !fragment)
+    {
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+        return false;
+    }
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertex);
+    glAttachShader(program, fragment);
+    glLinkProgram(program);
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        GLchar infoLog[1024];
+        glGetProgramInfoLog(program, 1024, nullptr, infoLog);
+        LOG_ERROR("STATIC_LAYER", "program linking failed\n{}", infoLog);
+        glDeleteProgram(program);
+        return false;
+    }
+    mProgram = program;
+
+    glGenVertexArrays(1, &mVAO);
+    glGenBuffers(1, &mVBO);
+    glBindVertexArray(mVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, mVBO);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    return true;
+}
+
+void StaticLayer::Shutdown()
+{
+    for (Slot& slot : mSlots)
+    {
+        if (slot.texture)
+        {
+            glDeleteFramebuffers(1, &slot.framebuffer);
+            glDeleteTextures(1, &slot.texture);
+        }
+    }
+    mSlots.clear();
+
+    if (mVAO)
+    {
+        glDeleteVertexArrays(1, &mVAO);
+        mVAO = 0;
+    }
+    if (mVBO)
+    {
+        glDeleteBuffers(1, &mVBO);
+        mVBO = 0;
+    }
+    if (mProgram)
+    {
+        glDeleteProgram(mProgram);
+        mProgram = 0;
+    }
+}
+
+void StaticLayer::Draw(const Camera& camera, const StaticLayerPlan& plan, const DrawFunction& drawStatic)
+{
+    // Bake first: it switches framebuffers and the viewport
+    mBakeCount = 0;
+    GLint viewport[4];
+    for (const StaticChunk& chunk : plan.chunks)
+    {
+        Slot* slot = chunk.bake ? GetSlot(chunk.slot) : nullptr;
+        if (!slot || slot->version == chunk.version)
+        {
+            continue;
+        }
+        if (mBakeCount == 0)
+        {
+            glGetIntegerv(GL_VIEWPORT, viewport);
+        }
+        Bake(*slot, chunk, plan.texelsPerUnit, drawStatic);
+        mBakeCount++;
+    }
+    if (mBakeCount > 0)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    }
+
+    // One quad per chunk holding what the plan expects, uploaded together
+    mVertices.clear();
+    mTextures.clear();
+    for (const StaticChunk& chunk : plan.chunks)
+    {
+        if (chunk.slot >= mSlots.size() || mSlots[chunk.slot].version != chunk.version)
+        {
+            continue;
+        }
+        const Rect& rect = chunk.area;
+        const float quad[FLOATS_PER_QUAD] =
+        {
+            rect.min.x, rect.max.y, 0.0f, 1.0f,
+            rect.min.x, rect.min.y, 0.0f, 0.0f,
+            rect.max.x, rect.min.y, 1.0f, 0.0f,
+
+            rect.min.x, rect.max.y, 0.0f, 1.0f,
+            rect.max.x, rect.min.y, 1.0f, 0.0f,
+            rect.max.x, rect.max.y, 1.0f, 1.0f
+        };
+        mVertices.insert(mVertices.end(), quad, quad + FLOATS_PER_QUAD);
+        mTextures.push_back(mSlots[chunk.slot].texture);
+    }
+    if (mTextures.empty())
+    {
+        return;
+    }
+
+    glUseProgram(mProgram);
+    Matrix4 projection = camera.GetViewProjection().ToMatrix4();
+    glUniformMatrix4fv(glGetUniformLocation(mProgram, "projection"), 1, GL_FALSE, projection.GetAsFloatPtr());
+    glUniform1i(glGetUniformLocation(mProgram, "layer"), 0);
+    glActiveTexture(GL_TEXTURE0);
+
+    glBindVertexArray(mVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, mVBO);
+    glBufferData(GL_ARRAY_BUFFER, mVertices.size() * sizeof(float), mVertices.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    for (size_t i = 0; i < mTextures.size(); i++)
+    {
+        glBindTexture(GL_TEXTURE_2D, mTextures[i]);
+        glDrawArrays(GL_TRIANGLES, static_cast<GLint>(i * 6), 6);
+    }
+
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_BLEND);
+}
+
+StaticLayer::Slot* StaticLayer::GetSlot(uint32_t index)
+{
+    if (index >= mSlots.size())
+    {
+        mSlots.resize(static_cast<size_t>(index) + 1, Slot{ 0, 0, 0 });
+    }
+    Slot& slot = mSlots[index];
+    if (!slot.texture && !CreateSlot(slot))
+    {
+        return nullptr;
+    }
+    return &slot;
+}
+
+bool StaticLayer::CreateSlot(Slot& outSlot)
+{
+    outSlot = Slot{ 0, 0, 0 };
+    const int texels = StaticLayerPlanner::CHUNK_TEXELS;
+
+    glGenTextures(1, &outSlot.texture);
+    glBindTexture(GL_TEXTURE_2D, outSlot.texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, texels, texels, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &outSlot.framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, outSlot.framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, outSlot.texture, 0);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        LOG_ERROR("STATIC_LAYER", "chunk framebuffer incomplete (0x{:x})", status);
+        glDeleteFramebuffers(1, &outSlot.framebuffer);
+        glDeleteTextures(1, &outSlot.texture);
+        outSlot = Slot{ 0, 0, 0 };
+        return false;
+    }
+    return true;
+}
+
+void StaticLayer::Bake(Slot& slot, const StaticChunk& chunk, float texelsPerUnit, const DrawFunction& drawStatic)
+{
+    const int texels = StaticLayerPlanner::CHUNK_TEXELS;
+    glBindFramebuffer(GL_FRAMEBUFFER, slot.framebuffer);
+    glViewport(0, 0, texels, texels);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    Vector2 center = chunk.area.GetCenter();
+    float size = chunk.area.max.x - chunk.area.min.x;
+    Matrix3x2 projection = Matrix3x2::CreateTranslation(Vector2(-center.x, -center.y)) *
+                           Matrix3x2::CreateOrtho(size, size);
+    drawStatic(chunk, projection, texelsPerUnit);
+    slot.version = chunk.version;
+}
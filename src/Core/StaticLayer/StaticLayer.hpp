@@ -0,0 +1,75 @@
+// ----------------------------------------------------------------
+// StaticLayer: render-to-texture cache for the resting board
+//
+// The board is cut into square world-space chunks. Each chunk in view
+// owns a framebuffer-backed texture holding its static tiles, baked
+// once and re-composited every frame as one textured quad, so drawing
+// a settled board costs one quad per chunk however many tiles it
+// holds. Tiles that move or animate are drawn live on top by the
+// caller.
+//
+// This half lives on the render thread and only owns the textures:
+// which chunk each texture slot holds, and when it is stale, is
+// decided on the simulation thread by StaticLayerPlanner and arrives
+// with each snapshot as a StaticLayerPlan.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "../../Math.h"
+#include "../RenderThread/FrameSnapshot.hpp"
+
+class StaticLayer
+{
+public:
+    // Draws the static contents of a chunk using the given projection
+    // (world -> clip space of the chunk being baked), at the chunk's
+    // resolution in texels per world unit
+    using DrawFunction = std::function<void(const StaticChunk& chunk, const Matrix3x2& projection, float pixelsPerUnit)>;
+
+    StaticLayer();
+    ~StaticLayer();
+
+    // Needs a GL context; without one (or on failure) the layer stays unused
+    bool Initialize();
+    // Release GL objects (call while the context is still alive)
+    void Shutdown();
+    bool IsReady() const { return mProgram != 0; }
+
+    // Rebake the plan's chunks whose textures are out of date, then
+    // composite them
+    void Draw(const class Camera& camera, const StaticLayerPlan& plan, const DrawFunction& drawStatic);
+
+    // Chunks baked by the last Draw
+    size_t GetBakeCount() const { return mBakeCount; }
+
+private:
+    struct Slot
+    {
+        GLuint framebuffer;
+        GLuint texture;
+        // StaticChunk::version baked into the texture (0 = none)
+        uint64_t version;
+    };
+
+    // Slot by index, creating its texture on first use; null on failure
+    Slot* GetSlot(uint32_t index);
+    bool CreateSlot(Slot& outSlot);
+    void Bake(Slot& slot, const StaticChunk& chunk, float texelsPerUnit, const DrawFunction& drawStatic);
+
+    // Indexed like the planner's slots; textures are created lazily
+    std::vector<Slot> mSlots;
+    size_t mBakeCount;
+
+    // Composite pass
+    GLuint mProgram;
+    GLuint mVAO;
+    GLuint mVBO;
+    std::vector<float> mVertices;
+    // Slots composited this frame, in quad order
+    std::vector<GLuint> mTextures;
+};
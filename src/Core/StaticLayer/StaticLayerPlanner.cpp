@@ -0,0 +1,249 @@
+// ----------------------------------------------------------------
+// StaticLayerPlanner implementation
+// ----------------------------------------------------------------
+
+#include "StaticLayerPlanner.hpp"
+#include "../Camera/Camera.hpp"
+#include <cmath>
+
+StaticLayerPlanner::StaticLayerPlanner()
+    : mTexelsPerUnit(0.0f)
+    , mChunkSize(0.0f)
+    , mFrame(0)
+    , mNextVersion(1)
+{
+}
+
+StaticLayerPlanner::Coverage StaticLayerPlanner::ComputeCoverage(const Camera& camera)
+{
+    // Smallest power of two at or above the zoom: chunks are only ever
+    // scaled down when composited, so text stays sharp
+    float zoom = camera.GetZoom();
+    Coverage coverage;
+    coverage.texelsPerUnit = 1.0f;
+    while (coverage.texelsPerUnit < zoom)
+    {
+        coverage.texelsPerUnit *= 2.0f;
+    }
+    while (coverage.texelsPerUnit * 0.5f >= zoom)
+    {
+        coverage.texelsPerUnit *= 0.5f;
+    }
+
+    // Drop resolution if the view would need more chunks than the cache holds
+    const Rect& visible = camera.GetVisibleRect();
+    while (true)
+    {
+        coverage.chunkSize = CHUNK_TEXELS / coverage.texelsPerUnit;
+        coverage.minX = static_cast<int32_t>(std::floor(visible.min.x / coverage.chunkSize));
+        coverage.minY = static_cast<int32_t>(std::floor(visible.min.y / coverage.chunkSize));
+        coverage.maxX = static_cast<int32_t>(std::floor(visible.max.x / coverage.chunkSize));
+        coverage.maxY = static_cast<int32_t>(std::floor(visible.max.y / coverage.chunkSize));
+        int64_t count = static_cast<int64_t>(coverage.maxX - coverage.minX + 1) * (coverage.maxY - coverage.minY + 1);
+        if (count <= static_cast<int64_t>(MAX_CHUNKS))
+        {
+            break;
+        }
+        coverage.texelsPerUnit *= 0.5f;
+    }
+    return coverage;
+}
+
+Rect StaticLayerPlanner::Coverage::GetRect() const
+{
+    return Rect(Vector2(minX * chunkSize, minY * chunkSize), Vector2((maxX + 1) * chunkSize, (maxY + 1) * chunkSize));
+}
+
+Rect StaticLayerPlanner::BeginFrame(const Camera& camera, uint64_t drawnSequence)
+{
+    // Bakes the render thread has drawn are done
+    for (Chunk& chunk : mChunks)
+    {
+        if (chunk.stale && chunk.sentIn != 0 && chunk.sentIn <= drawnSequence)
+        {
+            chunk.stale = false;
+        }
+    }
+
+    Coverage coverage = ComputeCoverage(camera);
+    if (coverage.texelsPerUnit != mTexelsPerUnit)
+    {
+        // New resolution: every cached chunk is stale
+        mTexelsPerUnit = coverage.texelsPerUnit;
+        mChunkSize = coverage.chunkSize;
+        mChunkIndex.clear();
+        for (Chunk& chunk : mChunks)
+        {
+            chunk.assigned = false;
+        }
+    }
+
+    mFrame++;
+    mVisible.clear();
+    for (int32_t y = coverage.minY; y <= coverage.maxY; y++)
+    {
+        for (int32_t x = coverage.minX; x <= coverage.maxX; x++)
+        {
+            size_t index = AcquireChunk(x, y);
+            if (index != SIZE_MAX)
+            {
+                mVisible.push_back(index);
+            }
+        }
+    }
+
+    return coverage.GetRect();
+}
+
+void StaticLayerPlanner::Invalidate(const Rect& worldBounds)
+{
+    if (mChunkIndex.empty())
+    {
+        return;
+    }
+
+    int32_t minX = ToChunk(worldBounds.min.x);
+    int32_t minY = ToChunk(worldBounds.min.y);
+    int32_t maxX = ToChunk(worldBounds.max.x);
+    int32_t maxY = ToChunk(worldBounds.max.y);
+    int64_t cells = static_cast<int64_t>(maxX - minX + 1) * (maxY - minY + 1);
+
+    // Walk whichever is smaller: the covered cells or the cache
+    if (cells > static_cast<int64_t>(mChunkIndex.size()))
+    {
+        for (Chunk& chunk : mChunks)
+        {
+            if (chunk.assigned && chunk.x >= minX && chunk.x <= maxX && chunk.y >= minY && chunk.y <= maxY)
+            {
+                MarkStale(chunk);
+            }
+        }
+        return;
+    }
+    for (int32_t y = minY; y <= maxY; y++)
+    {
+        for (int32_t x = minX; x <= maxX; x++)
+        {
+            auto it = mChunkIndex.find(MakeKey(x, y));
+            if (it != mChunkIndex.end())
+            {
+                MarkStale(mChunks[it->second]);
+            }
+        }
+    }
+}
+
+void StaticLayerPlanner::FillPlan(FrameSnapshot& frame, const CollectFunction& collect)
+{
+    StaticLayerPlan& plan = frame.staticLayer;
+    plan.texelsPerUnit = mTexelsPerUnit;
+    mSent.clear();
+    for (size_t index : mVisible)
+    {
+        Chunk& chunk = mChunks[index];
+        StaticChunk item{ static_cast<uint32_t>(index), chunk.version, GetChunkRect(chunk), chunk.stale, 0, 0 };
+        if (chunk.stale)
+        {
+            item.firstLabel = static_cast<uint32_t>(frame.board.GetLabels().size());
+            collect(item.area);
+            item.labelCount = static_cast<uint32_t>(frame.board.GetLabels().size()) - item.firstLabel;
+            mSent.emplace_back(index, chunk.version);
+        }
+        plan.chunks.push_back(item);
+    }
+
+    // A stale chunk left out of this snapshot is only done once a later
+    // one carrying it is drawn
+    for (Chunk& chunk : mChunks)
+    {
+        if (chunk.stale && chunk.lastUsed != mFrame)
+        {
+            chunk.sentIn = 0;
+        }
+    }
+}
+
+void StaticLayerPlanner::OnPublished(uint64_t sequence)
+{
+    for (const std::pair<size_t, uint64_t>& sent : mSent)
+    {
+        Chunk& chunk = mChunks[sent.first];
+        if (chunk.version == sent.second && chunk.sentIn == 0)
+        {
+            chunk.sentIn = sequence;
+        }
+    }
+    mSent.clear();
+}
+
+int32_t StaticLayerPlanner::ToChunk(float coord) const
+{
+    return static_cast<int32_t>(std::floor(coord / mChunkSize));
+}
+
+Rect StaticLayerPlanner::GetChunkRect(const Chunk& chunk) const
+{
+    Vector2 min(chunk.x * mChunkSize, chunk.y * mChunkSize);
+    return Rect(min, min + Vector2(mChunkSize, mChunkSize));
+}
+
+size_t StaticLayerPlanner::AcquireChunk(int32_t x, int32_t y)
+{
+    uint64_t key = MakeKey(x, y);
+    auto it = mChunkIndex.find(key);
+    if (it != mChunkIndex.end())
+    {
+        mChunks[it->second].lastUsed = mFrame;
+        return it->second;
+    }
+
+    // Prefer a free slot, then a new one, then the one out of view longest
+    size_t index = SIZE_MAX;
+    for (size_t i = 0; i < mChunks.size(); i++)
+    {
+        if (!mChunks[i].assigned)
+        {
+            index = i;
+            break;
+        }
+    }
+    if (index == SIZE_MAX && mChunks.size() < MAX_CHUNKS)
+    {
+        index = mChunks.size();
+        mChunks.push_back(Chunk{ 0, 0, false, false, 0, 0, 0 });
+    }
+    if (index == SIZE_MAX)
+    {
+        for (size_t i = 0; i < mChunks.size(); i++)
+        {
+            if (mChunks[i].lastUsed != mFrame && (index == SIZE_MAX || mChunks[i].lastUsed < mChunks[index].lastUsed))
+            {
+                index = i;
+            }
+        }
+        if (index == SIZE_MAX)
+        {
+            return SIZE_MAX;
+        }
+    }
+
+    Chunk& chunk = mChunks[index];
+    if (chunk.assigned)
+    {
+        mChunkIndex.erase(MakeKey(chunk.x, chunk.y));
+    }
+    chunk.x = x;
+    chunk.y = y;
+    chunk.assigned = true;
+    chunk.lastUsed = mFrame;
+    MarkStale(chunk);
+    mChunkIndex[key] = index;
+    return index;
+}
+
+void StaticLayerPlanner::MarkStale(Chunk& chunk)
+{
+    chunk.stale = true;
+    chunk.version = mNextVersion++;
+    chunk.sentIn = 0;
+}
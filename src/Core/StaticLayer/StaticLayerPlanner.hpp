@@ -0,0 +1,118 @@
+// ----------------------------------------------------------------
+// StaticLayerPlanner: the static layer's cache bookkeeping, kept on
+// the simulation thread
+//
+// Decides which board chunks the StaticLayer holds, at what
+// resolution, in which texture slot, and which of them are stale. A
+// snapshot then carries the labels of the chunks that need (re)baking
+// and nothing else; the render thread keeps every baked texture and
+// composites it as it is. A settled board costs one quad per chunk per
+// frame, on both threads, however many tiles it holds.
+//
+// A stale chunk is sent with every snapshot until one sent after it
+// went stale has been drawn (FrameMailbox::GetDrawnSequence), so
+// snapshots the render thread skips lose no bakes. Each time a chunk
+// goes stale it gets a new version; the render thread skips a bake its
+// texture already holds, so resending one costs only the label copy.
+//
+// Chunk resolution follows the camera zoom in power-of-two steps (at
+// least one texel per screen pixel); crossing a step rebakes the view.
+// Chunks that leave the view stay cached until their slot is needed
+// for another one.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "../../Math.h"
+#include "../RenderThread/FrameSnapshot.hpp"
+
+class StaticLayerPlanner
+{
+public:
+    // Appends the labels of the resting tiles touching area to the
+    // snapshot's board list
+    using CollectFunction = std::function<void(const Rect& area)>;
+
+    StaticLayerPlanner();
+
+    // Pick the resolution for the camera and claim the chunks in view.
+    // Bakes sent in snapshots up to drawnSequence are done. Returns the
+    // world area the chunks cover (at least the visible rect).
+    Rect BeginFrame(const class Camera& camera, uint64_t drawnSequence);
+    // Static contents changed inside these world bounds
+    void Invalidate(const Rect& worldBounds);
+    // Describe the chunks claimed by BeginFrame in frame.staticLayer;
+    // stale ones get their labels collected into frame.board
+    void FillPlan(FrameSnapshot& frame, const CollectFunction& collect);
+    // The snapshot holding the last plan was published as sequence
+    void OnPublished(uint64_t sequence);
+
+    // Chunk texture size in texels
+    static const int CHUNK_TEXELS = 512;
+    // Cache budget (CHUNK_TEXELS^2 RGBA texels each)
+    static const size_t MAX_CHUNKS = 64;
+
+private:
+    // Resolution and chunk range needed for a view
+    struct Coverage
+    {
+        float texelsPerUnit;
+        float chunkSize;
+        int32_t minX;
+        int32_t minY;
+        int32_t maxX;
+        int32_t maxY;
+
+        Rect GetRect() const;
+    };
+
+    // One texture slot on the render thread
+    struct Chunk
+    {
+        int32_t x;
+        int32_t y;
+        // Holds a chunk of the current resolution
+        bool assigned;
+        bool stale;
+        // Contents the slot should hold; bumped whenever it goes stale
+        uint64_t version;
+        // First snapshot that carried the current bake (0 = not sent, or
+        // missing from a later snapshot)
+        uint64_t sentIn;
+        // Frame the chunk was last in view
+        uint32_t lastUsed;
+    };
+
+    static uint64_t MakeKey(int32_t x, int32_t y)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+    }
+
+    static Coverage ComputeCoverage(const class Camera& camera);
+    int32_t ToChunk(float coord) const;
+    Rect GetChunkRect(const Chunk& chunk) const;
+    // Slot for chunk (x, y): cached, unassigned, new, or the least recently used
+    size_t AcquireChunk(int32_t x, int32_t y);
+    void MarkStale(Chunk& chunk);
+
+    // Chunk textures hold this many texels per world unit
+    float mTexelsPerUnit;
+    // Chunk edge length in world units
+    float mChunkSize;
+
+    // Indexed by texture slot
+    std::vector<Chunk> mChunks;
+    // Assigned chunks by coordinate
+    std::unordered_map<uint64_t, size_t> mChunkIndex;
+    // Slots in view this frame
+    std::vector<size_t> mVisible;
+    // Slots and versions whose bakes went into the last plan
+    std::vector<std::pair<size_t, uint64_t>> mSent;
+    uint32_t mFrame;
+    uint64_t mNextVersion;
+};
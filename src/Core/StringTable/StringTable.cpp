@@ -0,0 +1,174 @@
+// ----------------------------------------------------------------
+// StringTable implementation
+// ----------------------------------------------------------------
+
+#include "StringTable.hpp"
+#include <cstring>
+
+StringTable& StringTable::Get()
+{
+    static StringTable table;
+    return table;
+}
+
+StringTable::Index::Index(size_t capacity)
+    : mask(capacity - 1)
+    , slots(new std::atomic<uint32_t>[capacity])
+{
+    for (size_t i = 0; i < capacity; i++)
+    {
+        slots[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+StringTable::StringTable()
+    : mChunks(new std::atomic<Entry*>[MAX_CHUNKS])
+    , mCount(0)
+    , mIndex(nullptr)
+    , mArenaCursor(nullptr)
+    , mArenaRemaining(0)
+    , mArenaBytes(0)
+{
+    for (uint32_t i = 0; i < MAX_CHUNKS; i++)
+    {
+        mChunks[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    mIndexes.push_back(std::make_unique<Index>(1024));
+    mIndex.store(mIndexes.back().get(), std::memory_order_release);
+}
+
+StringTable::~StringTable()
+{
+}
+
+NameId StringTable::Intern(std::string_view text)
+{
+    NameId id = Find(text);
+    if (id != INVALID_NAME)
+    {
+        return id;
+    }
+    return Add(text);
+}
+
+NameId StringTable::Find(std::string_view text) const
+{
+    return FindInIndex(mIndex.load(std::memory_order_acquire), text, Hash(text));
+}
+
+uint32_t StringTable::Hash(std::string_view text)
+{
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : text)
+    {
+        hash ^= c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+NameId StringTable::FindInIndex(const Index* index, std::string_view text, uint32_t hash) const
+{
+    size_t slot = hash & index->mask;
+    while (true)
+    {
+        uint32_t value = index->slots[slot].load(std::memory_order_acquire);
+        if (value == 0)
+        {
+            return INVALID_NAME;
+        }
+
+        NameId id = value - 1;
+        const Entry& entry = mChunks[id >> CHUNK_SHIFT].load(std::memory_order_acquire)[id & CHUNK_MASK];
+        if (entry.hash == hash && std::string_view(entry.data, entry.length) == text)
+        {
+            return id;
+        }
+        slot = (slot + 1) & index->mask;
+    }
+}
+
+NameId StringTable::Add(std::string_view text)
+{
+    std::lock_guard<std::mutex> lock(mWriteMutex);
+
+    // Another writer may have added it while we waited for the lock
+    uint32_t hash = Hash(text);
+    Index* index = mIndex.load(std::memory_order_relaxed);
+    NameId existing = FindInIndex(index, text, hash);
+    if (existing != INVALID_NAME)
+    {
+        return existing;
+    }
+
+    NameId id = mCount.load(std::memory_order_relaxed);
+    uint32_t chunk = id >> CHUNK_SHIFT;
+    if (chunk >= MAX_CHUNKS)
+    {
+        return INVALID_NAME;
+    }
+    if (!mChunks[chunk].load(std::memory_order_relaxed))
+    {
+        mOwnedChunks.emplace_back(new Entry[CHUNK_SIZE]);
+        mChunks[chunk].store(mOwnedChunks.back().get(), std::memory_order_release);
+    }
+
+    Entry& entry = mChunks[chunk].load(std::memory_order_relaxed)[id & CHUNK_MASK];
+    entry.data = CopyToArena(text);
+    entry.length = static_cast<uint32_t>(text.size());
+    entry.hash = hash;
+
+    // Publish the entry before any index slot can point at it
+    mCount.store(id + 1, std::memory_order_release);
+
+    // Keep the index at most half full; readers keep using the old one until swapped
+    if ((static_cast<size_t>(id) + 1) * 2 > index->mask + 1)
+    {
+        mIndexes.push_back(std::make_unique<Index>((index->mask + 1) * 2));
+        Index* grown = mIndexes.back().get();
+        for (NameId i = 0; i <= id; i++)
+        {
+            const Entry& e = mChunks[i >> CHUNK_SHIFT].load(std::memory_order_relaxed)[i & CHUNK_MASK];
+            InsertIntoIndex(grown, i, e.hash);
+        }
+        mIndex.store(grown, std::memory_order_release);
+    }
+    else
+    {
+        InsertIntoIndex(index, id, hash);
+    }
+
+    return id;
+}
+
+const char* StringTable::CopyToArena(std::string_view text)
+{
+    size_t needed = text.size() + 1;
+    if (needed > mArenaRemaining)
+    {
+        // Oversized strings get their own block
+        size_t blockSize = needed > ARENA_BLOCK_SIZE ? needed : ARENA_BLOCK_SIZE;
+        mArenaBlocks.emplace_back(new char[blockSize]);
+        mArenaCursor = mArenaBlocks.back().get();
+        mArenaRemaining = blockSize;
+    }
+
+    char* copy = mArenaCursor;
+    std::memcpy(copy, text.data(), text.size());
+    copy[text.size()] = '\0';
+    mArenaCursor += needed;
+    mArenaRemaining -= needed;
+    mArenaBytes += needed;
+    return copy;
+}
+
+void StringTable::InsertIntoIndex(Index* index, NameId id, uint32_t hash)
+{
+    size_t slot = hash & index->mask;
+    while (index->slots[slot].load(std::memory_order_relaxed) != 0)
+    {
+        slot = (slot + 1) & index->mask;
+    }
+    index->slots[slot].store(id + 1, std::memory_order_release);
+}
@@ -0,0 +1,94 @@
+// ----------------------------------------------------------------
+// StringTable: global interned strings addressed by 32-bit IDs
+//
+// Strings are copied once into an append-only arena and never move. Readers (GetString, Find) are
+// lock-free; writers (Intern) are serialized by a mutex.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+using NameId = uint32_t;
+constexpr NameId INVALID_NAME = 0xffffffffu;
+
+class StringTable
+{
+public:
+    // Process-wide table shared by every subsystem
+    static StringTable& Get();
+
+    StringTable();
+    ~StringTable();
+    StringTable(const StringTable&) = delete;
+    StringTable& operator=(const StringTable&) = delete;
+
+    // ID for text, copying it into the arena on first use
+    NameId Intern(std::string_view text);
+
+    // Lock-free: ID for text or INVALID_NAME. May miss a string that is
+    // being interned concurrently.
+    NameId Find(std::string_view text) const;
+    // Lock-free: the interned text (stable for the table's lifetime), or
+    // an empty view for INVALID_NAME and IDs never handed out
+    std::string_view GetString(NameId id) const
+    {
+        if (id >= GetCount())
+        {
+            return std::string_view();
+        }
+        const Entry& entry = mChunks[id >> CHUNK_SHIFT].load(std::memory_order_acquire)[id & CHUNK_MASK];
+        return std::string_view(entry.data, entry.length);
+    }
+
+    size_t GetCount() const { return mCount.load(std::memory_order_acquire); }
+    size_t GetArenaBytes() const { return mArenaBytes; }
+
+private:
+    struct Entry
+    {
+        const char* data;
+        uint32_t length;
+        uint32_t hash;
+    };
+
+    // Open-addressing index of (id + 1), 0 = empty; replaced wholesale on growth
+    struct Index
+    {
+        explicit Index(size_t capacity);
+        size_t mask;
+        std::unique_ptr<std::atomic<uint32_t>[]> slots;
+    };
+
+    static constexpr uint32_t CHUNK_SHIFT = 12;
+    static constexpr uint32_t CHUNK_SIZE = 1u << CHUNK_SHIFT;
+    static constexpr uint32_t CHUNK_MASK = CHUNK_SIZE - 1;
+    static constexpr uint32_t MAX_CHUNKS = 1u << 14; // 64M strings
+    static constexpr size_t ARENA_BLOCK_SIZE = 64 * 1024;
+
+    static uint32_t Hash(std::string_view text);
+
+    NameId FindInIndex(const Index* index, std::string_view text, uint32_t hash) const;
+    NameId Add(std::string_view text);
+    const char* CopyToArena(std::string_view text);
+    void InsertIntoIndex(Index* index, NameId id, uint32_t hash);
+
+    // Entry chunks never move once published
+    std::unique_ptr<std::atomic<Entry*>[]> mChunks;
+    std::atomic<uint32_t> mCount;
+    std::atomic<Index*> mIndex;
+
+    // Writer-only state
+    std::mutex mWriteMutex;
+    std::vector<std::unique_ptr<Entry[]>> mOwnedChunks;
+    std::vector<std::unique_ptr<Index>> mIndexes;
+    std::vector<std::unique_ptr<char[]>> mArenaBlocks;
+    char* mArenaCursor;
+    size_t mArenaRemaining;
+    size_t mArenaBytes;
+};
@@ -1,7 +1,9 @@
 #include "TextRenderer.hpp"
-#include <iostream>
+#include "../Logger/Logger.hpp"
 
-TextRenderer::TextRenderer() {
+TextRenderer::TextRenderer()
+    : projection(Matrix3x2::Identity)
+    , pixelsPerUnit(1.0f) {
 }
 
 TextRenderer::~TextRenderer() {
@@ -10,21 +12,96 @@ TextRenderer::~TextRenderer() {
 bool TextRenderer::Initialize() {
     font = std::make_unique<SimpleFont>();
     
-    // Try system font first for better ASCII character support
-    if (!font->LoadFont("/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf", 24)) {
-        if (!font->LoadFont("/usr/share/fonts/truetype/liberation/LiberationSans-Regular.ttf", 24)) {
-            if (!font->LoadFont("assets/NotoColorEmoji-Regular.ttf", 24)) {
-                std::cout << "ERROR: Could not load any font!" << std::endl;
-                return false;
-            }
-        }
+    // Fallback chain: each character comes from the first font that has it
+    static const char* const fontPaths[] = {
+        "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+        "/usr/share/fonts/truetype/liberation/LiberationSans-Regular.ttf",
+        "assets/NotoColorEmoji-Regular.ttf"
+    };
+    for (const char* path : fontPaths) {
+        font->AddFont(path, 24);
+    }
+    if (font->GetFaceCount() == 0) {
+        LOG_ERROR("TEXT_RENDERER", "Could not load any font");
+        font.reset();
+        return false;
+    }
+
+    labels = std::make_unique<LabelRenderer>();
+    if (!labels->Initialize()) {
+        LOG_ERROR("TEXT_RENDERER", "Could not set up label level of detail, drawing all labels as text");
+        labels.reset();
     }
     
     return true;
 }
 
-void TextRenderer::RenderText(const std::string& text, float x, float y, float scale) {
+void TextRenderer::RenderText(std::string_view text, float x, float y, float scale, const Vector3& color) {
+    if (font) {
+        Flush();
+        font->RenderText(text, x, y, scale, color);
+    }
+}
+
+void TextRenderer::SetProjection(const Matrix3x2& projection, float pixelsPerUnit) {
+    this->projection = projection;
+    this->pixelsPerUnit = pixelsPerUnit;
+    if (labels) {
+        labels->SetProjection(projection, pixelsPerUnit);
+    }
+    if (font) {
+        font->SetProjection(projection);
+    }
+}
+
+void TextRenderer::RenderLabel(NameId name, const Rect& extents, float x, float y, float scale, const Vector3& color) {
+    if (!font) {
+        return;
+    }
+
+    // Detail follows the zoom rather than the tile's own scale, so all
+    // labels in a batch share a level and animated tiles don't flip levels
+    LabelRenderer::Detail detail = labels ? LabelRenderer::GetDetail(pixelsPerUnit) : LabelRenderer::Detail::Glyphs;
+    if (detail == LabelRenderer::Detail::Box) {
+        Vector2 pen(x, y);
+        labels->AddBox(Rect(pen + extents.min * scale, pen + extents.max * scale),
+                       LabelRenderer::GetNameColor(name) * color);
+        return;
+    }
+    if (detail == LabelRenderer::Detail::Impostor) {
+        bool queued = labels->AddImpostor(name, StringTable::Get().GetString(name), extents, x, y, scale, color, *font);
+        // Rendering a new impostor borrows the font's projection
+        font->SetProjection(projection);
+        if (queued) {
+            return;
+        }
+    }
+    RenderText(StringTable::Get().GetString(name), x, y, scale, color);
+}
+
+void TextRenderer::Flush() {
+    if (labels) {
+        labels->Flush();
+    }
+}
+
+Rect TextRenderer::MeasureText(std::string_view text, float scale) const {
+    if (font) {
+        return font->MeasureText(text, scale);
+    }
+    return Rect(Vector2::Zero, Vector2::Zero);
+}
+
+size_t TextRenderer::FitText(std::string_view text, float maxWidth, float scale) const {
+    if (font) {
+        return font->FitText(text, maxWidth, scale);
+    }
+    return text.size();
+}
+
+size_t TextRenderer::FitTextTail(std::string_view text, float maxWidth, float scale) const {
     if (font) {
-        font->RenderText(text, x, y, scale);
+        return font->FitTextTail(text, maxWidth, scale);
     }
-}
\ No newline at end of file
+    return text.size();
+}
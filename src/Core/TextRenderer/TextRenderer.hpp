@@ -1,5 +1,7 @@
 #pragma once
 #include "../../Font/SimpleFont.hpp"
+#include "../LabelRenderer/LabelRenderer.hpp"
+#include "../StringTable/StringTable.hpp"
 #include <memory>
 
 class TextRenderer {
@@ -8,8 +10,27 @@ public:
     ~TextRenderer();
     
     bool Initialize();
-    void RenderText(const std::string& text, float x, float y, float scale = 1.0f);
+    void RenderText(std::string_view text, float x, float y, float scale = 1.0f,
+                    const Vector3& color = Vector3(1.0f, 1.0f, 1.0f));
+    // pixelsPerUnit is the on-screen size of one unit of the projection's
+    // space; it picks how much detail RenderLabel spends on a label
+    void SetProjection(const Matrix3x2& projection, float pixelsPerUnit = 1.0f);
+    // Draw a tile label (pen at x, y; extents from MeasureText at scale 1) as
+    // glyphs, a cached impostor or a plain box depending on its on-screen size.
+    // Impostors and boxes are batched until the next Flush or SetProjection.
+    void RenderLabel(NameId name, const Rect& extents, float x, float y, float scale,
+                     const Vector3& color = Vector3(1.0f, 1.0f, 1.0f));
+    void Flush();
+    // Glyphs load on first use under a lock and are then read lock-free,
+    // so the simulation may measure while the render thread draws
+    Rect MeasureText(std::string_view text, float scale = 1.0f) const;
+    size_t FitText(std::string_view text, float maxWidth, float scale = 1.0f) const;
+    size_t FitTextTail(std::string_view text, float maxWidth, float scale = 1.0f) const;
     
 private:
     std::unique_ptr<SimpleFont> font;
+    // Null if its GL setup failed: every label is drawn as glyphs then
+    std::unique_ptr<LabelRenderer> labels;
+    Matrix3x2 projection;
+    float pixelsPerUnit;
 };
\ No newline at end of file
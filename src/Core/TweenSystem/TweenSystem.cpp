@@ -0,0 +1,285 @@
+// ----------------------------------------------------------------
+// TweenSystem implementation
+// ----------------------------------------------------------------
+
+#include "TweenSystem.hpp"
+#include "../../Actor/Actor.hpp"
+#include "../EventBus/EventBus.hpp"
+#include "../EventBus/Events.hpp"
+#include <algorithm>
+
+namespace
+{
+    struct EasingCurve
+    {
+        float a;
+        float b;
+        float c;
+    };
+
+    // Back easings use the usual overshoot constant
+    const float BACK_C1 = 1.70158f;
+    const float BACK_C3 = BACK_C1 + 1.0f;
+
+    // Indexed by Easing
+    const EasingCurve EASING_CURVES[] =
+    {
+        { 1.0f, 0.0f, 0.0f },                                           // Linear: t
+        { 0.0f, 1.0f, 0.0f },                                           // InQuad: t^2
+        { 2.0f, -1.0f, 0.0f },                                          // OutQuad: 1 - (1 - t)^2
+        { 0.0f, 0.0f, 1.0f },                                           // InCubic: t^3
+        { 3.0f, -3.0f, 1.0f },                                          // OutCubic: 1 - (1 - t)^3
+        { 0.0f, 3.0f, -2.0f },                                          // InOutCubic: 3t^2 - 2t^3
+        { 0.0f, -BACK_C1, BACK_C3 },                                    // InBack
+        { 3.0f * BACK_C3 - 2.0f * BACK_C1, BACK_C1 - 3.0f * BACK_C3, BACK_C3 }, // OutBack
+    };
+
+    // Shorter durations would divide by (nearly) zero; such tweens finish next update
+    const float MIN_DURATION = 1e-4f;
+
+    Vector2 GetProperty(const Actor* actor, TweenProperty property)
+    {
+        switch (property)
+        {
+            case TweenProperty::Position:
+                return actor->GetPosition();
+            case TweenProperty::Scale:
+                return actor->GetScale();
+            default:
+                return Vector2(actor->GetRotation(), 0.0f);
+        }
+    }
+}
+
+TweenSystem::TweenSystem(EventBus* eventBus)
+    : mEventBus(eventBus)
+    , mNextId(0)
+{
+}
+
+TweenSystem::~TweenSystem()
+{
+}
+
+TweenId TweenSystem::Start(Actor* target, TweenProperty property, const Vector2& to, float duration, Easing easing)
+{
+    return Start(target, property, GetProperty(target, property), to, duration, easing);
+}
+
+TweenId TweenSystem::Start(Actor* target, TweenProperty property, const Vector2& from, const Vector2& to,
+                           float duration, Easing easing)
+{
+    int32_t slotIndex = AcquireSlot(target);
+    TargetSlot& slot = mSlots[slotIndex];
+    int32_t& tween = slot.tweens[static_cast<size_t>(property)];
+
+    // Replace the property's running tween in place
+    if (tween < 0)
+    {
+        tween = static_cast<int32_t>(mIds.size());
+        slot.count++;
+        mTargets.push_back(static_cast<uint32_t>(slotIndex));
+        mProperties.push_back(property);
+        mIds.push_back(INVALID_TWEEN);
+        mFromX.push_back(0.0f);
+        mFromY.push_back(0.0f);
+        mDeltaX.push_back(0.0f);
+        mDeltaY.push_back(0.0f);
+        mElapsed.push_back(0.0f);
+        mInvDuration.push_back(0.0f);
+        mEaseA.push_back(0.0f);
+        mEaseB.push_back(0.0f);
+        mEaseC.push_back(0.0f);
+    }
+
+    size_t index = static_cast<size_t>(tween);
+    if (++mNextId == INVALID_TWEEN)
+    {
+        ++mNextId;
+    }
+    const EasingCurve& curve = EASING_CURVES[static_cast<size_t>(easing)];
+    mIds[index] = mNextId;
+    mFromX[index] = from.x;
+    mFromY[index] = from.y;
+    mDeltaX[index] = to.x - from.x;
+    mDeltaY[index] = to.y - from.y;
+    mElapsed[index] = 0.0f;
+    mInvDuration[index] = 1.0f / std::max(duration, MIN_DURATION);
+    mEaseA[index] = curve.a;
+    mEaseB[index] = curve.b;
+    mEaseC[index] = curve.c;
+    return mNextId;
+}
+
+void TweenSystem::Cancel(Actor* target, TweenProperty property)
+{
+    if (target->mTweenSlot < 0)
+    {
+        return;
+    }
+    int32_t tween = mSlots[target->mTweenSlot].tweens[static_cast<size_t>(property)];
+    if (tween >= 0)
+    {
+        RemoveTween(static_cast<size_t>(tween));
+    }
+}
+
+void TweenSystem::CancelAll(Actor* target)
+{
+    // The slot is released with the actor's last tween
+    for (size_t property = 0; property < static_cast<size_t>(TweenProperty::Count); property++)
+    {
+        Cancel(target, static_cast<TweenProperty>(property));
+    }
+}
+
+bool TweenSystem::GetEndValue(const Actor* target, TweenProperty property, Vector2& outValue) const
+{
+    if (target->mTweenSlot < 0)
+    {
+        return false;
+    }
+    int32_t tween = mSlots[target->mTweenSlot].tweens[static_cast<size_t>(property)];
+    if (tween < 0)
+    {
+        return false;
+    }
+    outValue = Vector2(mFromX[tween] + mDeltaX[tween], mFromY[tween] + mDeltaY[tween]);
+    return true;
+}
+
+void TweenSystem::Update(float deltaTime)
+{
+    size_t count = mIds.size();
+    if (count == 0)
+    {
+        return;
+    }
+    mProgress.resize(count);
+    mValueX.resize(count);
+    mValueY.resize(count);
+
+    // Evaluate every tween: plain arithmetic over contiguous arrays
+    float* elapsed = mElapsed.data();
+    const float* invDuration = mInvDuration.data();
+    const float* easeA = mEaseA.data();
+    const float* easeB = mEaseB.data();
+    const float* easeC = mEaseC.data();
+    const float* fromX = mFromX.data();
+    const float* fromY = mFromY.data();
+    const float* deltaX = mDeltaX.data();
+    const float* deltaY = mDeltaY.data();
+    float* progress = mProgress.data();
+    float* valueX = mValueX.data();
+    float* valueY = mValueY.data();
+    for (size_t i = 0; i < count; i++)
+    {
+        elapsed[i] += deltaTime;
+        float t = elapsed[i] * invDuration[i];
+        t = t < 1.0f ? t : 1.0f;
+        float eased = t * (easeA[i] + t * (easeB[i] + t * easeC[i]));
+        progress[i] = t;
+        valueX[i] = fromX[i] + deltaX[i] * eased;
+        valueY[i] = fromY[i] + deltaY[i] * eased;
+    }
+
+    // Write results back to the actors
+    for (size_t i = 0; i < count; i++)
+    {
+        Actor* actor = mSlots[mTargets[i]].actor;
+        switch (mProperties[i])
+        {
+            case TweenProperty::Position:
+                actor->SetPosition(Vector2(valueX[i], valueY[i]));
+                break;
+            case TweenProperty::Scale:
+                actor->SetScale(Vector2(valueX[i], valueY[i]));
+                break;
+            default:
+                actor->SetRotation(valueX[i]);
+                break;
+        }
+    }
+
+    // Retire finished tweens back to front, so swap-removal only moves
+    // entries that were already checked
+    for (size_t i = count; i-- > 0;)
+    {
+        if (mProgress[i] >= 1.0f)
+        {
+            TweenFinishedEvent event{ mIds[i], mSlots[mTargets[i]].actor, mProperties[i] };
+            RemoveTween(i);
+            mEventBus->Publish(event);
+        }
+    }
+}
+
+int32_t TweenSystem::AcquireSlot(Actor* target)
+{
+    if (target->mTweenSlot >= 0)
+    {
+        return target->mTweenSlot;
+    }
+
+    int32_t slotIndex;
+    if (!mFreeSlots.empty())
+    {
+        slotIndex = mFreeSlots.back();
+        mFreeSlots.pop_back();
+    }
+    else
+    {
+        slotIndex = static_cast<int32_t>(mSlots.size());
+        mSlots.emplace_back();
+    }
+
+    TargetSlot& slot = mSlots[slotIndex];
+    slot.actor = target;
+    std::fill(std::begin(slot.tweens), std::end(slot.tweens), -1);
+    slot.count = 0;
+    target->mTweenSlot = slotIndex;
+    return slotIndex;
+}
+
+void TweenSystem::RemoveTween(size_t index)
+{
+    TargetSlot& slot = mSlots[mTargets[index]];
+    slot.tweens[static_cast<size_t>(mProperties[index])] = -1;
+    if (--slot.count == 0)
+    {
+        slot.actor->mTweenSlot = -1;
+        slot.actor = nullptr;
+        mFreeSlots.push_back(static_cast<int32_t>(mTargets[index]));
+    }
+
+    size_t last = mIds.size() - 1;
+    if (index != last)
+    {
+        mTargets[index] = mTargets[last];
+        mProperties[index] = mProperties[last];
+        mIds[index] = mIds[last];
+        mFromX[index] = mFromX[last];
+        mFromY[index] = mFromY[last];
+        mDeltaX[index] = mDeltaX[last];
+        mDeltaY[index] = mDeltaY[last];
+        mElapsed[index] = mElapsed[last];
+        mInvDuration[index] = mInvDuration[last];
+        mEaseA[index] = mEaseA[last];
+        mEaseB[index] = mEaseB[last];
+        mEaseC[index] = mEaseC[last];
+        mSlots[mTargets[index]].tweens[static_cast<size_t>(mProperties[index])] = static_cast<int32_t>(index);
+    }
+
+    mTargets.pop_back();
+    mProperties.pop_back();
+    mIds.pop_back();
+    mFromX.pop_back();
+    mFromY.pop_back();
+    mDeltaX.pop_back();
+    mDeltaY.pop_back();
+    mElapsed.pop_back();
+    mInvDuration.pop_back();
+    mEaseA.pop_back();
+    mEaseB.pop_back();
+    mEaseC.pop_back();
+}
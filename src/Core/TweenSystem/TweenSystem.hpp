@@ -0,0 +1,111 @@
+// ----------------------------------------------------------------
+// TweenSystem: batched property animation for actors
+//
+// Active tweens live in parallel arrays (structure of arrays) and are
+// evaluated together once per frame: advancing time, easing and
+// interpolation are straight loops over floats that the compiler can
+// vectorize. Results are then written back to the actors' transforms.
+//
+// Every easing curve here is a cubic through (0,0) and (1,1), stored
+// as three coefficients per tween, so mixed easings share one loop.
+//
+// An actor has at most one tween per property; starting another
+// replaces it. A finished tween publishes a TweenFinishedEvent.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "../../Math.h"
+
+enum class TweenProperty : uint8_t
+{
+    Position,
+    Scale,
+    // Uses the x component only
+    Rotation,
+    Count
+};
+
+enum class Easing : uint8_t
+{
+    Linear,
+    InQuad,
+    OutQuad,
+    InCubic,
+    OutCubic,
+    // Smoothstep: slow at both ends
+    InOutCubic,
+    // Pulls back before starting
+    InBack,
+    // Overshoots, then settles
+    OutBack
+};
+
+using TweenId = uint32_t;
+const TweenId INVALID_TWEEN = 0;
+
+class TweenSystem
+{
+public:
+    TweenSystem(class EventBus* eventBus);
+    ~TweenSystem();
+
+    // Animate a property from its current value to `to` over duration seconds
+    TweenId Start(class Actor* target, TweenProperty property, const Vector2& to, float duration,
+                  Easing easing = Easing::OutCubic);
+    TweenId Start(class Actor* target, TweenProperty property, const Vector2& from, const Vector2& to,
+                  float duration, Easing easing = Easing::OutCubic);
+
+    // Stop a property's tween where it is (no event)
+    void Cancel(class Actor* target, TweenProperty property);
+    // Stop all of an actor's tweens (called when the actor is destroyed)
+    void CancelAll(class Actor* target);
+
+    // Value the property's tween will end on; false if it isn't animating
+    bool GetEndValue(const class Actor* target, TweenProperty property, Vector2& outValue) const;
+
+    // Advance, evaluate and apply every tween, then retire finished ones
+    void Update(float deltaTime);
+
+    size_t GetActiveCount() const { return mTargets.size(); }
+
+private:
+    struct TargetSlot
+    {
+        class Actor* actor;
+        // Index of the tween animating each property, or -1
+        int32_t tweens[static_cast<size_t>(TweenProperty::Count)];
+        int32_t count;
+    };
+
+    int32_t AcquireSlot(class Actor* target);
+    void RemoveTween(size_t index);
+
+    class EventBus* mEventBus;
+
+    // One entry per active tween
+    std::vector<uint32_t> mTargets;  // index into mSlots
+    std::vector<TweenProperty> mProperties;
+    std::vector<TweenId> mIds;
+    std::vector<float> mFromX;
+    std::vector<float> mFromY;
+    std::vector<float> mDeltaX;
+    std::vector<float> mDeltaY;
+    std::vector<float> mElapsed;
+    std::vector<float> mInvDuration;
+    // Easing cubic e(t) = t * (a + t * (b + t * c))
+    std::vector<float> mEaseA;
+    std::vector<float> mEaseB;
+    std::vector<float> mEaseC;
+    // Scratch for the evaluation passes
+    std::vector<float> mProgress;
+    std::vector<float> mValueX;
+    std::vector<float> mValueY;
+
+    // Per-actor bookkeeping; actors remember their slot (Actor::mTweenSlot)
+    std::vector<TargetSlot> mSlots;
+    std::vector<int32_t> mFreeSlots;
+
+    TweenId mNextId;
+};
@@ -0,0 +1,18 @@
+#include "FontCoverage.hpp"
+
+FontCoverage::FontCoverage() : blocks(BLOCK_COUNT, -1), count(0) {
+}
+
+void FontCoverage::Add(uint32_t codepoint) {
+    if (codepoint > MAX_CODEPOINT || Contains(codepoint)) {
+        return;
+    }
+    int32_t& block = blocks[codepoint >> BLOCK_SHIFT];
+    if (block < 0) {
+        block = static_cast<int32_t>(bits.size() / WORDS_PER_BLOCK);
+        bits.resize(bits.size() + WORDS_PER_BLOCK, 0);
+    }
+    uint32_t bit = codepoint & (BLOCK_SIZE - 1);
+    bits[block * WORDS_PER_BLOCK + (bit >> 6)] |= uint64_t(1) << (bit & 63);
+    count++;
+}
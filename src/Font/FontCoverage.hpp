@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Set of Unicode codepoints, e.g. the ones a font's cmap maps. Stored as
+// a bitmap per block of 256 codepoints; empty blocks cost one index entry.
+class FontCoverage {
+public:
+    static constexpr uint32_t MAX_CODEPOINT = 0x10FFFF;
+    static constexpr uint32_t BLOCK_SHIFT = 8;
+    static constexpr uint32_t BLOCK_SIZE = 1u << BLOCK_SHIFT;
+    static constexpr uint32_t BLOCK_COUNT = (MAX_CODEPOINT + 1) >> BLOCK_SHIFT;
+
+    FontCoverage();
+
+    void Add(uint32_t codepoint);
+    bool Contains(uint32_t codepoint) const {
+        if (codepoint > MAX_CODEPOINT) {
+            return false;
+        }
+        int32_t block = blocks[codepoint >> BLOCK_SHIFT];
+        if (block < 0) {
+            return false;
+        }
+        uint32_t bit = codepoint & (BLOCK_SIZE - 1);
+        return (bits[block * WORDS_PER_BLOCK + (bit >> 6)] >> (bit & 63)) & 1;
+    }
+    size_t GetCount() const { return count; }
+
+    // Calls f(codepoint) for every codepoint in the set, in ascending order
+    template <typename F>
+    void ForEach(F f) const {
+        for (uint32_t b = 0; b < BLOCK_COUNT; b++) {
+            if (blocks[b] < 0) {
+                continue;
+            }
+            const uint64_t* words = &bits[blocks[b] * WORDS_PER_BLOCK];
+            for (uint32_t w = 0; w < WORDS_PER_BLOCK; w++) {
+                for (uint32_t i = 0; i < 64 && (words[w] >> i); i++) {
+                    if ((words[w] >> i) & 1) {
+                        f((b << BLOCK_SHIFT) | (w << 6) | i);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr uint32_t WORDS_PER_BLOCK = BLOCK_SIZE / 64;
+
+    // Per block: index of its bitmap in bits, or -1 if the block is empty
+    std::vector<int32_t> blocks;
+    std::vector<uint64_t> bits;
+    size_t count;
+};
@@ -1,12 +1,17 @@
 #include "SimpleFont.hpp"
-#include <iostream>
+#include "../Core/Logger/Logger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
 const char* vertexShaderSource = R"(
 #version 330 core
 layout (location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
+layout (location = 1) in float page;  // 0 = coverage, 1 = colour
 out vec2 TexCoords;
+flat out float Colored;
 
 uniform mat4 projection;
 
@@ -14,132 +19,346 @@ void main()
 {
     gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
     TexCoords = vertex.zw;
+    Colored = page;
 }
 )";
 
+// Premultiplied output. Both pages are sampled unconditionally: the
+// colour page is mipmapped and needs derivatives from uniform control flow.
 const char* fragmentShaderSource = R"(
 #version 330 core
 in vec2 TexCoords;
+flat in float Colored;
 out vec4 color;
 
 uniform sampler2D text;
+uniform sampler2D colorGlyphs;
 uniform vec3 textColor;
 
 void main()
 {
     float alpha = texture(text, TexCoords).r;
-    color = vec4(textColor, alpha);
+    vec4 glyph = texture(colorGlyphs, TexCoords) * vec4(textColor, 1.0);
+    color = mix(vec4(textColor * alpha, alpha), glyph, Colored);
 }
 )";
 
-SimpleFont::SimpleFont() : VAO(0), VBO(0), shaderProgram(0), face(nullptr) {
+const int FLOATS_PER_VERTEX = 5;
+
+struct SimpleFont::Face {
+    FT_Face face;
+    FontCoverage coverage;
+    // Target size over strike size for fixed-size (bitmap) fonts, else 1
+    float scale;
+    // Has colour glyphs (CBDT/sbix bitmaps)
+    bool color;
+};
+
+namespace {
+    // Decode the UTF-8 sequence at text[i] and move i past it; malformed
+    // bytes decode to U+FFFD one at a time
+    uint32_t NextCodepoint(std::string_view text, size_t& i) {
+        unsigned char lead = static_cast<unsigned char>(text[i]);
+        if (lead < 0x80) {
+            i++;
+            return lead;
+        }
+
+        size_t length = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 0;
+        if (length == 0 || i + length > text.size()) {
+            i++;
+            return 0xFFFD;
+        }
+        uint32_t codepoint = lead & (0x7F >> length);
+        for (size_t k = 1; k < length; k++) {
+            unsigned char next = static_cast<unsigned char>(text[i + k]);
+            if ((next & 0xC0) != 0x80) {
+                i++;
+                return 0xFFFD;
+            }
+            codepoint = (codepoint << 6) | (next & 0x3F);
+        }
+        i += length;
+        return codepoint;
+    }
+
+    // Blocks whose characters default to emoji presentation; a colour
+    // font beats an earlier monochrome one there
+    bool PrefersColor(uint32_t codepoint) {
+        return codepoint >= 0x1F000 && codepoint <= 0x1FAFF;
+    }
+
+    // Area-average a premultiplied RGBA image down to width x height
+    void DownscaleRGBA(const unsigned char* source, int sourceWidth, int sourceHeight,
+                       unsigned char* out, int width, int height) {
+        float stepX = float(sourceWidth) / width;
+        float stepY = float(sourceHeight) / height;
+        for (int y = 0; y < height; y++) {
+            float top = y * stepY, bottom = (y + 1) * stepY;
+            for (int x = 0; x < width; x++) {
+                float left = x * stepX, right = (x + 1) * stepX;
+                float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+                for (int sy = int(top); sy < sourceHeight && sy < bottom; sy++) {
+                    float wy = Math::Min(bottom, sy + 1.0f) - Math::Max(top, float(sy));
+                    for (int sx = int(left); sx < sourceWidth && sx < right; sx++) {
+                        float w = wy * (Math::Min(right, sx + 1.0f) - Math::Max(left, float(sx)));
+                        const unsigned char* texel = source + (size_t(sy) * sourceWidth + sx) * 4;
+                        for (int c = 0; c < 4; c++) {
+                            sum[c] += texel[c] * w;
+                        }
+                    }
+                }
+                float norm = 1.0f / (stepX * stepY);
+                for (int c = 0; c < 4; c++) {
+                    out[(size_t(y) * width + x) * 4 + c] = (unsigned char)Math::Min(255.0f, sum[c] * norm + 0.5f);
+                }
+            }
+        }
+    }
+}
+
+SimpleFont::SimpleFont()
+    : library(nullptr),
+      resolveBlocks(FontCoverage::BLOCK_COUNT, -1),
+      glyphBlocks(new std::atomic<GlyphBlock*>[FontCoverage::BLOCK_COUNT]),
+      maskPage{ 0, 0, 0, 0, 1 }, colorPage{ 0, 0, 0, 0, 1 },
+      VAO(0), VBO(0), shaderProgram(0), projectionLocation(-1), colorLocation(-1) {
+    for (uint32_t i = 0; i < FontCoverage::BLOCK_COUNT; i++) {
+        glyphBlocks[i].store(nullptr, std::memory_order_relaxed);
+    }
 }
 
 SimpleFont::~SimpleFont() {
     // Clean up OpenGL resources
-    for (auto& pair : characters) {
-        glDeleteTextures(1, &pair.second.textureID);
-    }
-    for (auto& pair : unicodeCharacters) {
-        glDeleteTextures(1, &pair.second.textureID);
-    }
-    
+    if (maskPage.texture) glDeleteTextures(1, &maskPage.texture);
+    if (colorPage.texture) glDeleteTextures(1, &colorPage.texture);
     if (VAO) glDeleteVertexArrays(1, &VAO);
     if (VBO) glDeleteBuffers(1, &VBO);
     if (shaderProgram) glDeleteProgram(shaderProgram);
-    
-    // Clean up FreeType face
-    if (face) {
-        FT_Done_Face((FT_Face)face);
+
+    // Clean up FreeType
+    for (auto& face : faces) {
+        FT_Done_Face(face->face);
+    }
+    if (library) {
+        FT_Done_FreeType((FT_Library)library);
     }
 }
 
-bool SimpleFont::LoadFont(const std::string& fontPath, int fontSize) {
-    // Initialize FreeType
-    FT_Library ft;
-    if (FT_Init_FreeType(&ft)) {
-        std::cout << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
+bool SimpleFont::AddFont(const std::string& fontPath, int fontSize) {
+    if (faces.size() >= NO_FACE) {
+        LOG_ERROR("FONT", "Too many fonts, not loading {}", fontPath);
         return false;
     }
 
+    // Initialize FreeType
+    if (!library) {
+        FT_Library ft;
+        if (FT_Init_FreeType(&ft)) {
+            LOG_ERROR("FREETYPE", "Could not init FreeType Library");
+            return false;
+        }
+        library = ft;
+    }
+
     // Load font
     FT_Face face;
-    if (FT_New_Face(ft, fontPath.c_str(), 0, &face)) {
-        std::cout << "ERROR::FREETYPE: Failed to load font from " << fontPath << std::endl;
-        FT_Done_FreeType(ft);
+    if (FT_New_Face((FT_Library)library, fontPath.c_str(), 0, &face)) {
+        LOG_ERROR("FREETYPE", "Failed to load font from {}", fontPath);
         return false;
     }
 
-    // Set size
-    FT_Set_Pixel_Sizes(face, 0, fontSize);
+    // Set size; fixed-size fonts get the closest strike and are scaled
+    float scale = 1.0f;
+    if (FT_IS_SCALABLE(face)) {
+        FT_Set_Pixel_Sizes(face, 0, fontSize);
+    } else if (face->num_fixed_sizes > 0) {
+        // Smallest strike at least as big as asked for, else the biggest
+        const FT_Pos wanted = FT_Pos(fontSize) * 64;
+        int best = 0;
+        for (int i = 1; i < face->num_fixed_sizes; i++) {
+            FT_Pos size = face->available_sizes[i].y_ppem;
+            FT_Pos bestSize = face->available_sizes[best].y_ppem;
+            if (bestSize < wanted ? size > bestSize : (size >= wanted && size < bestSize)) {
+                best = i;
+            }
+        }
+        FT_Select_Size(face, best);
+        scale = fontSize * 64.0f / face->available_sizes[best].y_ppem;
+    } else {
+        LOG_ERROR("FREETYPE", "Font has no usable sizes: {}", fontPath);
+        FT_Done_Face(face);
+        return false;
+    }
 
-    // Disable byte-alignment restriction
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    auto entry = std::make_unique<Face>();
+    entry->face = face;
+    entry->scale = scale;
+    entry->color = FT_HAS_COLOR(face);
+    if (FT_Select_Charmap(face, FT_ENCODING_UNICODE) == 0) {
+        FT_UInt index;
+        for (FT_ULong c = FT_Get_First_Char(face, &index); index != 0; c = FT_Get_Next_Char(face, c, &index)) {
+            entry->coverage.Add(static_cast<uint32_t>(c));
+        }
+    }
+    if (entry->coverage.GetCount() == 0) {
+        LOG_ERROR("FREETYPE", "Font maps no Unicode characters: {}", fontPath);
+        FT_Done_Face(face);
+        return false;
+    }
+    size_t covered = entry->coverage.GetCount();
+    faces.push_back(std::move(entry));
+    BuildResolveTable();
+
+    // Create shaders, atlas and VAO/VBO with the first font
+    if (!shaderProgram && (!CreateShaders() || !CreateAtlas())) {
+        return false;
+    }
+
+    // Warm the cache with printable ASCII so the common case never loads
+    for (uint32_t c = 32; c < 127; c++) {
+        GetCharacter(c);
+    }
 
-    // Load first 128 characters of ASCII set
-    for (unsigned char c = 0; c < 128; c++) {
-        // Load character glyph
-        if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
-            std::cout << "ERROR::FREETYTPE: Failed to load Glyph " << (int)c << std::endl;
+    LOG_INFO("FONT", "Font loaded successfully: {} ({} characters)", fontPath, covered);
+    return true;
+}
+
+void SimpleFont::BuildResolveTable() {
+    std::fill(resolveBlocks.begin(), resolveBlocks.end(), -1);
+    resolved.clear();
+    // Earlier faces win, so fill back to front
+    for (size_t f = faces.size(); f-- > 0;) {
+        faces[f]->coverage.ForEach([this, f](uint32_t codepoint) {
+            int32_t& block = resolveBlocks[codepoint >> FontCoverage::BLOCK_SHIFT];
+            if (block < 0) {
+                block = static_cast<int32_t>(resolved.size() / FontCoverage::BLOCK_SIZE);
+                resolved.resize(resolved.size() + FontCoverage::BLOCK_SIZE, NO_FACE);
+            }
+            resolved[block * FontCoverage::BLOCK_SIZE + (codepoint & (FontCoverage::BLOCK_SIZE - 1))] = static_cast<uint8_t>(f);
+        });
+    }
+    // Then the first colour font takes the emoji blocks it covers
+    for (size_t f = faces.size(); f-- > 0;) {
+        if (!faces[f]->color) {
             continue;
         }
-        
-        // Skip characters with no bitmap (like spaces, control chars)
-        if (face->glyph->bitmap.width == 0 || face->glyph->bitmap.rows == 0) {
-            // For space character, create a simple placeholder
-            if (c == ' ') {
-                Character character = { 0, 0, 0, 0, 0, (int)face->glyph->advance.x };
-                characters.insert(std::pair<char, Character>(c, character));
+        faces[f]->coverage.ForEach([this, f](uint32_t codepoint) {
+            if (PrefersColor(codepoint)) {
+                int32_t block = resolveBlocks[codepoint >> FontCoverage::BLOCK_SHIFT];
+                resolved[block * FontCoverage::BLOCK_SIZE + (codepoint & (FontCoverage::BLOCK_SIZE - 1))] = static_cast<uint8_t>(f);
             }
-            continue;
+        });
+    }
+}
+
+Character* SimpleFont::GetCharacter(uint32_t codepoint) const {
+    if (codepoint > FontCoverage::MAX_CODEPOINT) {
+        return nullptr;
+    }
+    GlyphBlock* block = glyphBlocks[codepoint >> FontCoverage::BLOCK_SHIFT].load(std::memory_order_acquire);
+    if (block) {
+        Character* glyph = block->glyphs[codepoint & (FontCoverage::BLOCK_SIZE - 1)].load(std::memory_order_acquire);
+        if (glyph) {
+            return glyph;
         }
-        
-        // Generate texture
-        GLuint texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            GL_RED,
-            face->glyph->bitmap.width,
-            face->glyph->bitmap.rows,
-            0,
-            GL_RED,
-            GL_UNSIGNED_BYTE,
-            face->glyph->bitmap.buffer
-        );
-        
-        // Set texture options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        
-        // Store character for later use
-        Character character = {
-            texture,
-            (int)face->glyph->bitmap.width,
-            (int)face->glyph->bitmap.rows,
-            face->glyph->bitmap_left,
-            face->glyph->bitmap_top,
-            (int)face->glyph->advance.x
-        };
-        characters.insert(std::pair<char, Character>(c, character));
     }
-    glBindTexture(GL_TEXTURE_2D, 0);
+    if (ResolveFace(codepoint) == NO_FACE) {
+        return nullptr;
+    }
+    return LoadCharacter(codepoint);
+}
 
-    // Clean up FreeType
-    FT_Done_Face(face);
-    FT_Done_FreeType(ft);
+Character* SimpleFont::LoadCharacter(uint32_t codepoint) const {
+    std::lock_guard<std::mutex> lock(glyphMutex);
 
-    // Create shaders and VAO/VBO
-    if (!CreateShaders()) {
-        return false;
+    std::atomic<GlyphBlock*>& blockSlot = glyphBlocks[codepoint >> FontCoverage::BLOCK_SHIFT];
+    GlyphBlock* block = blockSlot.load(std::memory_order_relaxed);
+    if (!block) {
+        glyphBlockStore.push_back(std::make_unique<GlyphBlock>());
+        block = glyphBlockStore.back().get();
+        for (auto& slot : block->glyphs) {
+            slot.store(nullptr, std::memory_order_relaxed);
+        }
+        blockSlot.store(block, std::memory_order_release);
+    }
+    std::atomic<Character*>& slot = block->glyphs[codepoint & (FontCoverage::BLOCK_SIZE - 1)];
+    if (Character* loaded = slot.load(std::memory_order_relaxed)) {
+        return loaded; // Another thread got here first
     }
 
-    std::cout << "Font loaded successfully: " << fontPath << std::endl;
-    return true;
+    glyphStore.push_back(std::make_unique<Character>());
+    Character* glyph = glyphStore.back().get();
+    *glyph = Character{ 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0, 0, {}, false, 0.0f, 0.0f, 0.0f, 0.0f, 0 };
+
+    // A glyph that fails to load is cached empty rather than retried
+    const Face& face = *faces[ResolveFace(codepoint)];
+    if (FT_Load_Char(face.face, codepoint, FT_LOAD_RENDER | FT_LOAD_COLOR)) {
+        LOG_ERROR("FREETYPE", "Failed to load glyph {}", codepoint);
+        slot.store(glyph, std::memory_order_release);
+        return glyph;
+    }
+
+    FT_GlyphSlot loaded = face.face->glyph;
+    const FT_Bitmap& bitmap = loaded->bitmap;
+    glyph->advance = (loaded->advance.x >> 6) * face.scale;
+    glyph->bearingX = loaded->bitmap_left * face.scale;
+    glyph->bearingY = loaded->bitmap_top * face.scale;
+    glyph->width = bitmap.width * face.scale;
+    glyph->height = bitmap.rows * face.scale;
+
+    if (bitmap.width == 0 || bitmap.rows == 0) {
+        slot.store(glyph, std::memory_order_release);
+        return glyph;
+    }
+
+    if (bitmap.pixel_mode == FT_PIXEL_MODE_BGRA) {
+        // Colour strikes are far bigger than the font size: swizzle to RGBA
+        // (FreeType's is premultiplied already) and shrink to the oversampled size
+        std::vector<unsigned char> rgba(size_t(bitmap.width) * bitmap.rows * 4);
+        for (unsigned int y = 0; y < bitmap.rows; y++) {
+            const unsigned char* row = bitmap.buffer + (ptrdiff_t)y * bitmap.pitch;
+            unsigned char* out = &rgba[size_t(y) * bitmap.width * 4];
+            for (unsigned int x = 0; x < bitmap.width; x++) {
+                out[x * 4 + 0] = row[x * 4 + 2];
+                out[x * 4 + 1] = row[x * 4 + 1];
+                out[x * 4 + 2] = row[x * 4 + 0];
+                out[x * 4 + 3] = row[x * 4 + 3];
+            }
+        }
+        int width = Math::Max(1, (int)std::ceil(glyph->width * COLOR_OVERSAMPLE));
+        int rows = Math::Max(1, (int)std::ceil(glyph->height * COLOR_OVERSAMPLE));
+        glyph->colored = true;
+        if (width < (int)bitmap.width || rows < (int)bitmap.rows) {
+            glyph->bitmapWidth = width;
+            glyph->bitmapRows = rows;
+            glyph->bitmap.resize(size_t(width) * rows * 4);
+            DownscaleRGBA(rgba.data(), bitmap.width, bitmap.rows, glyph->bitmap.data(), width, rows);
+        } else {
+            glyph->bitmapWidth = bitmap.width;
+            glyph->bitmapRows = bitmap.rows;
+            glyph->bitmap = std::move(rgba);
+        }
+    } else if (bitmap.pixel_mode == FT_PIXEL_MODE_GRAY || bitmap.pixel_mode == FT_PIXEL_MODE_MONO) {
+        // Coverage: grey levels as they are, 1-bit masks widened
+        glyph->bitmapWidth = bitmap.width;
+        glyph->bitmapRows = bitmap.rows;
+        glyph->bitmap.resize(size_t(bitmap.width) * bitmap.rows);
+        for (unsigned int y = 0; y < bitmap.rows; y++) {
+            const unsigned char* row = bitmap.buffer + (ptrdiff_t)y * bitmap.pitch;
+            unsigned char* out = &glyph->bitmap[size_t(y) * bitmap.width];
+            for (unsigned int x = 0; x < bitmap.width; x++) {
+                if (bitmap.pixel_mode == FT_PIXEL_MODE_GRAY) {
+                    out[x] = row[x];
+                } else {
+                    out[x] = (row[x >> 3] & (0x80 >> (x & 7))) ? 255 : 0;
+                }
+            }
+        }
+    }
+
+    slot.store(glyph, std::memory_order_release);
+    return glyph;
 }
 
 bool SimpleFont::CreateShaders() {
@@ -147,13 +366,13 @@ bool SimpleFont::CreateShaders() {
     GLuint vertex = glCreateShader(GL_VERTEX_SHADER);
     glShaderSource(vertex, 1, &vertexShaderSource, NULL);
     glCompileShader(vertex);
-    
+
     GLint success;
     GLchar infoLog[1024];
     glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
     if (!success) {
         glGetShaderInfoLog(vertex, 1024, NULL, infoLog);
-        std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: VERTEX\n" << infoLog << std::endl;
+        LOG_ERROR("SHADER", "Compilation error of type VERTEX\n{}", infoLog);
         return false;
     }
 
@@ -161,11 +380,11 @@ bool SimpleFont::CreateShaders() {
     GLuint fragment = glCreateShader(GL_FRAGMENT_SHADER);
     glShaderSource(fragment, 1, &fragmentShaderSource, NULL);
     glCompileShader(fragment);
-    
+
     glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
     if (!success) {
         glGetShaderInfoLog(fragment, 1024, NULL, infoLog);
-        std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: FRAGMENT\n" << infoLog << std::endl;
+        LOG_ERROR("SHADER", "Compilation error of type FRAGMENT\n{}", infoLog);
         return false;
     }
 
@@ -174,98 +393,326 @@ bool SimpleFont::CreateShaders() {
     glAttachShader(shaderProgram, vertex);
     glAttachShader(shaderProgram, fragment);
     glLinkProgram(shaderProgram);
-    
+
     glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
     if (!success) {
         glGetProgramInfoLog(shaderProgram, 1024, NULL, infoLog);
-        std::cout << "ERROR::PROGRAM_LINKING_ERROR\n" << infoLog << std::endl;
+        LOG_ERROR("SHADER", "Program linking error\n{}", infoLog);
         return false;
     }
+    projectionLocation = glGetUniformLocation(shaderProgram, "projection");
+    colorLocation = glGetUniformLocation(shaderProgram, "textColor");
+    glUseProgram(shaderProgram);
+    glUniform1i(glGetUniformLocation(shaderProgram, "text"), 0);
+    glUniform1i(glGetUniformLocation(shaderProgram, "colorGlyphs"), 1);
+    glUseProgram(0);
 
     // Clean up shaders
     glDeleteShader(vertex);
     glDeleteShader(fragment);
 
-    // Configure VAO/VBO for texture quads
+    // Configure VAO/VBO for texture quads (resized per batch)
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
     glBindVertexArray(VAO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(float), 0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(float), (void*)(4 * sizeof(float)));
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 
     return true;
 }
 
-void SimpleFont::RenderText(const std::string& text, float x, float y, float scale) {
+bool SimpleFont::CreateAtlas() {
+    glGenTextures(1, &maskPage.texture);
+    glBindTexture(GL_TEXTURE_2D, maskPage.texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, ATLAS_SIZE, ATLAS_SIZE, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return maskPage.texture != 0;
+}
+
+bool SimpleFont::CreateColorAtlas() {
+    // Left bound to unit 1, where RenderText samples it
+    glActiveTexture(GL_TEXTURE1);
+    glGenTextures(1, &colorPage.texture);
+    glBindTexture(GL_TEXTURE_2D, colorPage.texture);
+    for (int level = 0; level <= COLOR_MIP_LEVELS; level++) {
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, ATLAS_SIZE >> level, ATLAS_SIZE >> level, 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, COLOR_MIP_LEVELS);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glActiveTexture(GL_TEXTURE0);
+    return colorPage.texture != 0;
+}
+
+bool SimpleFont::AllocateCell(AtlasPage& page, int width, int height, int& outX, int& outY) {
+    if (page.shelfX + width > ATLAS_SIZE) {
+        page.shelfX = 0;
+        page.shelfY += page.shelfHeight;
+        page.shelfHeight = 0;
+    }
+    if (width > ATLAS_SIZE || page.shelfY + height > ATLAS_SIZE) {
+        return false;
+    }
+    outX = page.shelfX;
+    outY = page.shelfY;
+    page.shelfX += width;
+    page.shelfHeight = Math::Max(page.shelfHeight, height);
+    return true;
+}
+
+bool SimpleFont::PlaceInAtlas(Character& glyph) {
+    AtlasPage& page = glyph.colored ? colorPage : maskPage;
+    if (glyph.atlasGeneration == page.generation) {
+        return true;
+    }
+    if (glyph.colored && !page.texture && !CreateColorAtlas()) {
+        return false;
+    }
+
+    // Colour cells sit on the smallest mip's texel grid with one of its
+    // texels of padding, so each level downsamples only this glyph
+    int padding = glyph.colored ? COLOR_CELL_ALIGNMENT : ATLAS_PADDING;
+    int width = glyph.bitmapWidth + 2 * padding;
+    int height = glyph.bitmapRows + 2 * padding;
+    if (glyph.colored) {
+        width = (width + COLOR_CELL_ALIGNMENT - 1) & ~(COLOR_CELL_ALIGNMENT - 1);
+        height = (height + COLOR_CELL_ALIGNMENT - 1) & ~(COLOR_CELL_ALIGNMENT - 1);
+    }
+    int x, y;
+    if (!AllocateCell(page, width, height, x, y)) {
+        return false;
+    }
+
+    if (glyph.colored) {
+        UploadColor(glyph, x, y, width, height);
+    } else {
+        UploadMask(glyph, x, y, width, height);
+    }
+
+    float texel = 1.0f / ATLAS_SIZE;
+    glyph.u0 = (x + padding) * texel;
+    glyph.v0 = (y + padding) * texel;
+    glyph.u1 = glyph.u0 + glyph.bitmapWidth * texel;
+    glyph.v1 = glyph.v0 + glyph.bitmapRows * texel;
+    glyph.atlasGeneration = page.generation;
+    return true;
+}
+
+void SimpleFont::UploadMask(const Character& glyph, int x, int y, int width, int height) {
+    // Upload with the padding so the border is blank even over old glyphs
+    uploadBuffer.assign(size_t(width) * height, 0);
+    for (int row = 0; row < glyph.bitmapRows; row++) {
+        memcpy(&uploadBuffer[size_t(row + ATLAS_PADDING) * width + ATLAS_PADDING],
+               &glyph.bitmap[size_t(row) * glyph.bitmapWidth], glyph.bitmapWidth);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glActiveTexture(GL_TEXTURE0);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RED, GL_UNSIGNED_BYTE, uploadBuffer.data());
+}
+
+void SimpleFont::UploadColor(const Character& glyph, int x, int y, int width, int height) {
+    uploadBuffer.assign(size_t(width) * height * 4, 0);
+    for (int row = 0; row < glyph.bitmapRows; row++) {
+        memcpy(&uploadBuffer[(size_t(row + COLOR_CELL_ALIGNMENT) * width + COLOR_CELL_ALIGNMENT) * 4],
+               &glyph.bitmap[size_t(row) * glyph.bitmapWidth * 4], size_t(glyph.bitmapWidth) * 4);
+    }
+
+    // Build the cell's mip chain here rather than regenerating the page
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glActiveTexture(GL_TEXTURE1);
+    for (int level = 0;; level++) {
+        glTexSubImage2D(GL_TEXTURE_2D, level, x >> level, y >> level, width, height, GL_RGBA, GL_UNSIGNED_BYTE,
+                        uploadBuffer.data());
+        if (level == COLOR_MIP_LEVELS) {
+            break;
+        }
+        // 2x2 box filter, in place (premultiplied, so plain averages)
+        int halfWidth = width / 2, halfHeight = height / 2;
+        for (int row = 0; row < halfHeight; row++) {
+            for (int column = 0; column < halfWidth; column++) {
+                const unsigned char* a = &uploadBuffer[(size_t(row * 2) * width + column * 2) * 4];
+                const unsigned char* b = a + size_t(width) * 4;
+                for (int c = 0; c < 4; c++) {
+                    uploadBuffer[(size_t(row) * halfWidth + column) * 4 + c] =
+                        (unsigned char)((a[c] + a[c + 4] + b[c] + b[c + 4] + 2) / 4);
+                }
+            }
+        }
+        width = halfWidth;
+        height = halfHeight;
+    }
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void SimpleFont::ClearAtlas(AtlasPage& page) {
+    // Every placement goes stale; glyphs are re-uploaded as they are drawn
+    page.generation++;
+    page.shelfX = 0;
+    page.shelfY = 0;
+    page.shelfHeight = 0;
+}
+
+void SimpleFont::DrawBatch() {
+    if (vertices.empty()) {
+        return;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size() / FLOATS_PER_VERTEX));
+    vertices.clear();
+}
+
+void SimpleFont::RenderText(std::string_view text, float x, float y, float scale, const Vector3& color) {
+    if (!shaderProgram) {
+        return;
+    }
+
     // Activate corresponding render state
     glUseProgram(shaderProgram);
-    
-    // Set text color (white)
-    glUniform3f(glGetUniformLocation(shaderProgram, "textColor"), 1.0f, 1.0f, 1.0f);
-    
-    // Set projection matrix (orthographic projection for 800x600 window, corrected orientation)
-    float projection[16] = {
-        2.0f/800.0f, 0.0f, 0.0f, 0.0f,
-        0.0f, 2.0f/600.0f, 0.0f, 0.0f,
-        0.0f, 0.0f, -1.0f, 0.0f,
-        -1.0f, -1.0f, 0.0f, 1.0f
-    };
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, projection);
-    
+
+    // Set text color
+    glUniform3f(colorLocation, color.x, color.y, color.z);
+
+    // Set projection matrix (supplied by the camera, widened to mat4 for the shader)
+    Matrix4 uploadProjection = projection.ToMatrix4();
+    glUniformMatrix4fv(projectionLocation, 1, GL_FALSE, uploadProjection.GetAsFloatPtr());
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, colorPage.texture);
     glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, maskPage.texture);
     glBindVertexArray(VAO);
 
-    // Enable blending
+    // Enable blending; the shader outputs premultiplied colour and alpha
+    // accumulates too, so text drawn into a transparent offscreen layer
+    // comes out premultiplied
     glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    // Iterate through all characters
-    std::string::const_iterator c;
-    for (c = text.begin(); c != text.end(); c++) {
-        auto it = characters.find(*c);
-        if (it == characters.end()) {
-            continue; // Skip characters not found
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    // One quad per glyph, whatever face or page it comes from, in one draw
+    for (size_t i = 0; i < text.size();) {
+        Character* glyph = GetCharacter(NextCodepoint(text, i));
+        if (!glyph) {
+            continue; // Skip characters no font has
         }
-        
-        Character ch = it->second;
-
-        float xpos = x + ch.bearingX * scale;
-        float ypos = y - (ch.height - ch.bearingY) * scale;
-
-        float w = ch.width * scale;
-        float h = ch.height * scale;
-        
-        // Update VBO for each character
-        float vertices[6][4] = {
-            { xpos,     ypos + h,   0.0f, 0.0f },            
-            { xpos,     ypos,       0.0f, 1.0f },
-            { xpos + w, ypos,       1.0f, 1.0f },
-
-            { xpos,     ypos + h,   0.0f, 0.0f },
-            { xpos + w, ypos,       1.0f, 1.0f },
-            { xpos + w, ypos + h,   1.0f, 0.0f }           
-        };
-        
-        // Render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.textureID);
-        
-        // Update content of VBO memory
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        
-        // Render quad
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        
-        // Now advance cursors for next glyph (note that advance is number of 1/64 pixels)
-        x += (ch.advance >> 6) * scale; // Bitshift by 6 to get value in pixels (2^6 = 64)
-    }
-    
+        const Character& ch = *glyph;
+
+        if (ch.bitmapWidth > 0 && !PlaceInAtlas(*glyph)) {
+            // Page full: draw what uses the old contents, then start over
+            DrawBatch();
+            ClearAtlas(ch.colored ? colorPage : maskPage);
+            if (!PlaceInAtlas(*glyph)) {
+                x += ch.advance * scale;
+                continue;
+            }
+        }
+
+        if (ch.bitmapWidth > 0) {
+            float xpos = x + ch.bearingX * scale;
+            float ypos = y - (ch.height - ch.bearingY) * scale;
+
+            float w = ch.width * scale;
+            float h = ch.height * scale;
+            float page = ch.colored ? 1.0f : 0.0f;
+
+            const float quad[6][FLOATS_PER_VERTEX] = {
+                { xpos,     ypos + h,   ch.u0, ch.v0, page },
+                { xpos,     ypos,       ch.u0, ch.v1, page },
+                { xpos + w, ypos,       ch.u1, ch.v1, page },
+
+                { xpos,     ypos + h,   ch.u0, ch.v0, page },
+                { xpos + w, ypos,       ch.u1, ch.v1, page },
+                { xpos + w, ypos + h,   ch.u1, ch.v0, page }
+            };
+            vertices.insert(vertices.end(), &quad[0][0], &quad[0][0] + 6 * FLOATS_PER_VERTEX);
+        }
+
+        // Now advance cursors for next glyph
+        x += ch.advance * scale;
+    }
+    DrawBatch();
+
     glBindVertexArray(0);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, 0);
     glDisable(GL_BLEND);
-}
\ No newline at end of file
+}
+
+Rect SimpleFont::MeasureText(std::string_view text, float scale) const {
+    Rect bounds(Vector2::Zero, Vector2::Zero);
+    float x = 0.0f;
+    for (size_t i = 0; i < text.size();) {
+        const Character* glyph = GetCharacter(NextCodepoint(text, i));
+        if (!glyph) {
+            continue;
+        }
+
+        const Character& ch = *glyph;
+        bounds.min.y = Math::Min(bounds.min.y, -(ch.height - ch.bearingY) * scale);
+        bounds.max.y = Math::Max(bounds.max.y, ch.bearingY * scale);
+        x += ch.advance * scale;
+    }
+    bounds.max.x = x;
+    return bounds;
+}
+
+size_t SimpleFont::FitText(std::string_view text, float maxWidth, float scale) const {
+    float x = 0.0f;
+    for (size_t i = 0; i < text.size();) {
+        size_t start = i;
+        const Character* glyph = GetCharacter(NextCodepoint(text, i));
+        if (!glyph) {
+            continue;
+        }
+
+        x += glyph->advance * scale;
+        if (x > maxWidth) {
+            return start;
+        }
+    }
+    return text.size();
+}
+
+size_t SimpleFont::FitTextTail(std::string_view text, float maxWidth, float scale) const {
+    float x = 0.0f;
+    size_t end = text.size();
+    while (end > 0) {
+        // Step back to the lead byte of the last codepoint
+        size_t start = end - 1;
+        while (start > 0 && end - start < 4 && (static_cast<unsigned char>(text[start]) & 0xC0) == 0x80) {
+            start--;
+        }
+        size_t i = start;
+        uint32_t codepoint = NextCodepoint(text, i);
+        if (i != end) {
+            // Malformed: the last byte stands alone, as when decoding forward
+            start = end - 1;
+            codepoint = 0xFFFD;
+        }
+
+        const Character* glyph = GetCharacter(codepoint);
+        if (glyph) {
+            x += glyph->advance * scale;
+            if (x > maxWidth) {
+                break;
+            }
+        }
+        end = start;
+    }
+    return text.size() - end;
+}
@@ -1,35 +1,127 @@
 #pragma once
 #include <GL/glew.h>
+#include "../Math.h"
+#include "FontCoverage.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 
 struct Character {
-    GLuint textureID;   // ID handle of the glyph texture
-    int width, height;  // Size of glyph
-    int bearingX, bearingY; // Offset from baseline to left/top of glyph
-    int advance;        // Offset to advance to next glyph
+    // Metrics in pixels at the font size
+    float width, height;        // Size of glyph
+    float bearingX, bearingY;   // Offset from baseline to left/top of glyph
+    float advance;              // Offset to advance to next glyph
+    // Rasterized glyph, kept so the atlas can be rebuilt: coverage, or
+    // premultiplied RGBA for colour glyphs (emoji)
+    int bitmapWidth, bitmapRows;
+    std::vector<unsigned char> bitmap;
+    bool colored;
+    // Atlas cell (render thread only); valid while atlasGeneration matches
+    float u0, v0, u1, v1;
+    uint32_t atlasGeneration;
 };
 
+// A fallback chain of fonts sharing one glyph atlas. Each codepoint is
+// drawn with the first font whose cmap covers it (emoji prefer colour
+// fonts), so one string can mix faces and still goes out in a single
+// draw. Colour glyphs live on their own mipmapped RGBA page, sampled by
+// the same shader as the coverage page.
 class SimpleFont {
 public:
     SimpleFont();
     ~SimpleFont();
-    
-    bool LoadFont(const std::string& fontPath, int fontSize);
-    void RenderText(const std::string& text, float x, float y, float scale = 1.0f);
-    
+
+    // Append a font to the fallback chain. Call before the font is shared
+    // between threads.
+    bool AddFont(const std::string& fontPath, int fontSize);
+    size_t GetFaceCount() const { return faces.size(); }
+    void RenderText(std::string_view text, float x, float y, float scale = 1.0f,
+                    const Vector3& color = Vector3(1.0f, 1.0f, 1.0f));
+
+    // Projection used by subsequent RenderText calls (world or screen space)
+    void SetProjection(const Matrix3x2& projection) { this->projection = projection; }
+    // Bounds of the rendered text relative to the pen origin (baseline at y = 0)
+    Rect MeasureText(std::string_view text, float scale = 1.0f) const;
+    // Number of leading bytes of text whose advance fits in maxWidth
+    size_t FitText(std::string_view text, float maxWidth, float scale = 1.0f) const;
+    // Number of trailing bytes whose advance fits, cut on a codepoint boundary
+    size_t FitTextTail(std::string_view text, float maxWidth, float scale = 1.0f) const;
+
+    static constexpr int ATLAS_SIZE = 2048;
+    // Empty texels around each glyph so filtering doesn't pick up neighbours
+    static constexpr int ATLAS_PADDING = 1;
+    // Mip levels below the colour page's base; its cells are aligned to
+    // and padded by one texel of the smallest level
+    static constexpr int COLOR_MIP_LEVELS = 3;
+    static constexpr int COLOR_CELL_ALIGNMENT = 1 << COLOR_MIP_LEVELS;
+    // Colour strikes are stored at this multiple of the font size, so
+    // zoomed-in labels stay sharp and zoomed-out ones use the mips
+    static constexpr float COLOR_OVERSAMPLE = 2.0f;
+    // Codepoints no face covers
+    static constexpr uint8_t NO_FACE = 0xFF;
+
 private:
-    std::unordered_map<char, Character> characters;
-    std::unordered_map<uint32_t, Character> unicodeCharacters; // For emoji and Unicode
+    struct Face;
+    // Shelf-packed atlas texture; cleared wholesale when full
+    struct AtlasPage {
+        GLuint texture;
+        int shelfX, shelfY, shelfHeight;
+        uint32_t generation;
+    };
+    struct GlyphBlock {
+        std::atomic<Character*> glyphs[FontCoverage::BLOCK_SIZE];
+    };
+
+    // Face that draws codepoint: O(1), lock-free
+    uint8_t ResolveFace(uint32_t codepoint) const {
+        if (codepoint > FontCoverage::MAX_CODEPOINT) {
+            return NO_FACE;
+        }
+        int32_t block = resolveBlocks[codepoint >> FontCoverage::BLOCK_SHIFT];
+        return block < 0 ? NO_FACE : resolved[block * FontCoverage::BLOCK_SIZE + (codepoint & (FontCoverage::BLOCK_SIZE - 1))];
+    }
+    void BuildResolveTable();
+    // Glyph for codepoint, loaded on first use (any thread); null if no face has it
+    Character* GetCharacter(uint32_t codepoint) const;
+    Character* LoadCharacter(uint32_t codepoint) const;
+    // Make sure glyph is in its atlas page (render thread); false if it can't fit
+    bool PlaceInAtlas(Character& glyph);
+    // Reserve a width x height cell; false once the page is full
+    static bool AllocateCell(AtlasPage& page, int width, int height, int& outX, int& outY);
+    void UploadMask(const Character& glyph, int x, int y, int width, int height);
+    void UploadColor(const Character& glyph, int x, int y, int width, int height);
+    static void ClearAtlas(AtlasPage& page);
+    void DrawBatch();
+
+    bool CreateShaders();
+    bool CreateAtlas();
+    bool CreateColorAtlas();
+
+    void* library; // FT_Library but as void* to avoid including freetype in header
+    std::vector<std::unique_ptr<Face>> faces;
+    // Codepoint -> index into faces (first face covering it), in the
+    // same two-level layout as FontCoverage
+    std::vector<int32_t> resolveBlocks;
+    std::vector<uint8_t> resolved;
+
+    // Loaded glyphs, published lock-free per codepoint; loading (FreeType
+    // calls) is serialized by glyphMutex
+    mutable std::mutex glyphMutex;
+    std::unique_ptr<std::atomic<GlyphBlock*>[]> glyphBlocks;
+    mutable std::vector<std::unique_ptr<GlyphBlock>> glyphBlockStore;
+    mutable std::vector<std::unique_ptr<Character>> glyphStore;
+
+    // Coverage for every face, and colour glyphs (created on first use)
+    AtlasPage maskPage;
+    AtlasPage colorPage;
+    std::vector<unsigned char> uploadBuffer;
+
     GLuint VAO, VBO;
     GLuint shaderProgram;
-    
-    bool CreateShaders();
-    void LoadCharacters();
-    void LoadUnicodeCharacter(uint32_t codepoint);
-    std::vector<uint32_t> UTF8ToCodepoints(const std::string& utf8);
-    
-    // FreeType face for loading additional characters
-    void* face; // FT_Face but as void* to avoid including freetype in header
-};
\ No newline at end of file
+    GLint projectionLocation, colorLocation;
+    Matrix3x2 projection;
+    std::vector<float> vertices;
+};
@@ -5,23 +5,142 @@
 #include "Game.hpp"
 #include "../Actor/Actor.hpp"
 #include "../Actor/TextActor.hpp"
-#include "../Core/Renderer/Renderer.hpp"
 #include "../Core/TextRenderer/TextRenderer.hpp"
+#include "../Component/DragComponent/DragComponent.hpp"
 #include <iostream>
 #include <algorithm>
+#include <cstdlib>
+#include <functional>
 
 Game::Game()
-    : mWindow(nullptr)
+    : mTweens(&mEventBus)
+    , mOverlapSolver(&mSpatialGrid)
+    , mGameTime(0.0f)
+    , mWindow(nullptr)
     , mGLContext(nullptr)
-    , mRenderer(nullptr)
     , mTextRenderer(nullptr)
+    , mBoardDirty(false)
+    , mAutosaveTimer(0.0f)
     , mTicksCount(0)
     , mIsRunning(true)
     , mUpdatingActors(false)
+    , mIsPanning(false)
+    , mHeadless(false)
+    , mFrameNumber(0)
+    , mMouseScreenPosition(Vector2::Zero)
+    , mMouseButtons(0)
+    , mLastMouseWorldPosition(Vector2::Zero)
+    , mHoveredTile(nullptr)
+    , mStackTop(0)
 {
 }
 
 bool Game::Initialize()
+{
+    // Headless runs (scenarios on machines without a display) skip the
+    // window, GL and text rendering; everything else runs as usual
+    if (mHeadless)
+    {
+        if (SDL_Init(SDL_INIT_EVENTS) != 0)
+        {
+            SDL_Log("Unable to initialize SDL: %s", SDL_GetError());
+            return false;
+        }
+    }
+    else if (!InitializeVideo())
+    {
+        return false;
+    }
+
+    SubscribeEvents();
+
+    // Discovered elements list, docked to the right edge
+    mSidebar = std::make_unique<Sidebar>(this);
+    mSidebar->SetViewportSize(WINDOW_WIDTH, WINDOW_HEIGHT);
+    // Search results arriving on a timing-dependent frame would change
+    // what a replayed click lands on
+    mSidebar->SetSynchronousSearch(mInput.GetMode() != InputSystem::Mode::Live);
+
+    // Center the camera so world coordinates initially match window pixels
+    mCamera.SetViewportSize(WINDOW_WIDTH, WINDOW_HEIGHT);
+    mCamera.SetPosition(Vector2(WINDOW_WIDTH * 0.5f, WINDOW_HEIGHT * 0.5f));
+
+    if (mRecipeBook.LoadFromFile("assets/recipes.txt"))
+    {
+        RecipeBook::Stats stats = mRecipeBook.GetStats();
+        SDL_Log("Loaded %zu recipes (load factor %.2f, avg probe %.2f, max probe %zu)",
+                stats.recipeCount, stats.loadFactor, stats.averageProbeLength, stats.maxProbeLength);
+    }
+
+    // Large pre-computed corpora ship as a memory-mapped binary database
+    if (mRecipeDatabase.Open("assets/recipes.rcdb"))
+    {
+        SDL_Log("Mapped recipe database with %u recipes", mRecipeDatabase.GetRecipeCount());
+    }
+
+    // Unknown pairs go to the generator: an external command when configured
+    // (e.g. a client for the generator service or a local stub), else a
+    // deterministic hash-based generator
+    std::unique_ptr<Generator> generator;
+    const char* generatorCommand = std::getenv("INFINITE_CRAFT_GENERATOR");
+    if (generatorCommand && *generatorCommand)
+    {
+        generator = std::make_unique<ProcessGenerator>(generatorCommand);
+    }
+    else
+    {
+        generator = std::make_unique<HashGenerator>();
+    }
+    // Recorded and replayed sessions start from a clean state (no cache, no
+    // save) so a replay sees exactly what the recording saw
+    bool isSession = mInput.GetMode() != InputSystem::Mode::Live || !mScenarioPath.empty();
+    mResolver = std::make_unique<CombinationResolver>(mRecipeBook, std::move(generator));
+    if (!isSession)
+    {
+        mResolver->OpenCache("recipe_cache.txt");
+    }
+    mPrefetcher = std::make_unique<Prefetcher>(this, mResolver.get());
+
+    // Resume the previous session if there is one; it streams in over the
+    // first frames. Otherwise start with the four elements.
+    if (!isSession)
+    {
+        mSaveGame = std::make_unique<SaveGame>("save");
+    }
+    if (mSaveGame && mSaveGame->BeginLoad())
+    {
+        SDL_Log("Loading saved game");
+    }
+    else
+    {
+        const char* startingElements[] = { "Water", "Fire", "Wind", "Earth" };
+        float y = 450.0f;
+        for (const char* name : startingElements)
+        {
+            SpawnElement(RecipeBook::Intern(name), Vector2(100.0f, y));
+            y -= 60.0f;
+        }
+    }
+
+    if (!mScenarioPath.empty())
+    {
+        mScenario = std::make_unique<Scenario>(this);
+        if (!mScenario->LoadScript(mScenarioPath))
+        {
+            return false;
+        }
+        if (!mMetricsPath.empty() && !mScenario->OpenMetrics(mMetricsPath))
+        {
+            return false;
+        }
+    }
+
+    mTicksCount = SDL_GetTicks();
+
+    return true;
+}
+
+bool Game::InitializeVideo()
 {
     if (SDL_Init(SDL_INIT_VIDEO) != 0)
     {
@@ -34,7 +153,8 @@ bool Game::Initialize()
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
 
-    mWindow = SDL_CreateWindow("Infinite Craft Clone", 0, 0, WINDOW_WIDTH, WINDOW_HEIGHT, SDL_WINDOW_OPENGL);
+    mWindow = SDL_CreateWindow("Infinite Craft Clone", 0, 0, WINDOW_WIDTH, WINDOW_HEIGHT,
+                               SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE);
     if (!mWindow)
     {
         SDL_Log("Failed to create window: %s", SDL_GetError());
@@ -49,10 +169,15 @@ bool Game::Initialize()
         return false;
     }
 
-    mRenderer = std::make_unique<Renderer>();
-    if (!mRenderer->Initialize(WINDOW_WIDTH, WINDOW_HEIGHT))
+    // Replays and scenarios measure frame cost, so don't let vsync pace them
+    if (RunsUnthrottled())
+    {
+        SDL_GL_SetSwapInterval(0);
+    }
+
+    // Needs GLEW, which the renderer loads
+    if (!mRenderThread.Initialize(mWindow, mGLContext, WINDOW_WIDTH, WINDOW_HEIGHT))
     {
-        SDL_Log("Failed to initialize renderer");
         return false;
     }
 
@@ -63,17 +188,11 @@ bool Game::Initialize()
         SDL_Log("Warning: Failed to initialize text renderer");
     }
 
-    // Create text actors with simple ASCII text first
-    auto helloActor = std::make_unique<TextActor>(this, "Hello World!");
-    helloActor->SetPosition(Vector2(100.0f, 200.0f));
-    AddActor(std::move(helloActor));
-    
-    auto secondActor = std::make_unique<TextActor>(this, "Test 123");
-    secondActor->SetPosition(Vector2(100.0f, 250.0f));
-    AddActor(std::move(secondActor));
-
-    mTicksCount = SDL_GetTicks();
+    // From here on only the render thread touches GL
+    mRenderThread.Start(mTextRenderer.get());
 
+    // Typed text filters the sidebar
+    SDL_StartTextInput();
     return true;
 }
 
@@ -81,62 +200,337 @@ void Game::RunLoop()
 {
     while (mIsRunning)
     {
+        if (CanWaitForEvents())
+        {
+            WaitForEvents();
+        }
+
+        Uint64 frameStart = SDL_GetPerformanceCounter();
+
         ProcessInput();
         UpdateGame();
+        Uint64 updateEnd = SDL_GetPerformanceCounter();
         GenerateOutput();
+        Uint64 frameEnd = SDL_GetPerformanceCounter();
+
+        double ticksToMs = 1000.0 / SDL_GetPerformanceFrequency();
+        if (mInput.IsReplaying())
+        {
+            mFrameTimes.push_back(static_cast<float>((frameEnd - frameStart) * ticksToMs));
+        }
+        if (mScenario)
+        {
+            mScenario->RecordFrame(mFrameNumber, (updateEnd - frameStart) * ticksToMs, (frameEnd - updateEnd) * ticksToMs);
+        }
+        mFrameNumber++;
+    }
+}
+
+bool Game::CanWaitForEvents() const
+{
+    // Recorded and scripted sessions count frames, so they never skip any
+    if (UsesFixedTimestep())
+    {
+        return false;
+    }
+    if (mDamage.IsDamaged() || !mAwakeActors.empty() || mTweens.GetActiveCount() > 0 ||
+        mOverlapSolver.GetRestlessCount() > 0)
+    {
+        return false;
+    }
+    // Results arriving from worker threads are only picked up by polling
+    if (!mPendingMerges.empty() || (mSaveGame && mSaveGame->IsLoading()))
+    {
+        return false;
+    }
+    return !mSidebar || mSidebar->IsIdle();
+}
+
+void Game::WaitForEvents()
+{
+    // Wake up in time for the next actor timer and the next autosave
+    float timeout = IDLE_WAIT_LIMIT_MS / 1000.0f;
+    if (!mWakeTimers.empty())
+    {
+        timeout = Math::Min(timeout, mWakeTimers.front().time - mGameTime);
+    }
+    if (mSaveGame && (mBoardDirty || mSaveGame->HasUnsavedProgress()))
+    {
+        timeout = Math::Min(timeout, AUTOSAVE_INTERVAL - mAutosaveTimer);
     }
+    if (timeout <= 0.0f)
+    {
+        return;
+    }
+
+    Uint32 waitStart = SDL_GetTicks();
+    // Leaves the event queued for ProcessInput
+    SDL_WaitEventTimeout(nullptr, static_cast<int>(timeout * 1000.0f));
+    Uint32 now = SDL_GetTicks();
+
+    // Nothing was awake, so only the clocks need to catch up. The frame
+    // after the wait then runs right away with a regular time step.
+    float waited = (now - waitStart) / 1000.0f;
+    mGameTime += waited;
+    mAutosaveTimer += waited;
+    mTicksCount = now - FRAME_TIME_MS;
 }
 
 void Game::ProcessInput()
 {
-    SDL_Event event;
-    while (SDL_PollEvent(&event))
+    mInput.BeginFrame();
+    if (mInput.IsFinished())
+    {
+        Quit();
+        return;
+    }
+
+    // Mouse motion is coalesced into one move event per frame
+    Vector2 motion = Vector2::Zero;
+    for (const SDL_Event& event : mInput.GetEvents())
     {
         switch (event.type)
         {
             case SDL_QUIT:
                 Quit();
                 break;
+            case SDL_WINDOWEVENT:
+                if (event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+                {
+                    OnWindowResized(event.window.data1, event.window.data2);
+                }
+                else if (event.window.event == SDL_WINDOWEVENT_EXPOSED)
+                {
+                    // The window system lost what was shown
+                    mDamage.InvalidateAll();
+                }
+                break;
+            case SDL_TEXTINPUT:
+                if (mSidebar)
+                {
+                    mSidebar->AppendFilter(event.text.text);
+                }
+                break;
+            case SDL_KEYDOWN:
+                if (event.key.keysym.sym == SDLK_BACKSPACE && mSidebar)
+                {
+                    mSidebar->EraseFilterChar();
+                }
+                break;
+            case SDL_MOUSEWHEEL:
+            {
+                Vector2 screenPoint(static_cast<float>(mInput.GetMouseX()), static_cast<float>(mInput.GetMouseY()));
+                if (mSidebar && mSidebar->Contains(screenPoint))
+                {
+                    mSidebar->Scroll(static_cast<float>(-event.wheel.y) * 3.0f);
+                    break;
+                }
+                float factor = event.wheel.y > 0 ? 1.1f : 1.0f / 1.1f;
+                mCamera.ZoomAt(screenPoint, factor);
+                break;
+            }
+            case SDL_MOUSEBUTTONDOWN:
+            case SDL_MOUSEBUTTONUP:
+            {
+                Vector2 screenPoint(static_cast<float>(event.button.x), static_cast<float>(event.button.y));
+                MouseButtonEvent button{ screenPoint, mCamera.ScreenToWorld(screenPoint), event.button.button };
+                if (event.type == SDL_MOUSEBUTTONDOWN)
+                {
+                    mEventBus.Publish(MouseDownEvent{ button });
+                }
+                else
+                {
+                    mEventBus.Publish(MouseUpEvent{ button });
+                }
+                break;
+            }
+            case SDL_MOUSEMOTION:
+                motion += Vector2(static_cast<float>(event.motion.xrel), static_cast<float>(event.motion.yrel));
+                break;
         }
     }
 
-    const Uint8* state = SDL_GetKeyboardState(nullptr);
+    mMouseButtons = mInput.GetMouseButtons();
+    mMouseScreenPosition = Vector2(static_cast<float>(mInput.GetMouseX()), static_cast<float>(mInput.GetMouseY()));
+
+    // One move per frame, also when a pan or zoom slid the board under a still pointer
+    Vector2 mouseWorldPosition = GetMouseWorldPosition();
+    if (motion.x != 0.0f || motion.y != 0.0f || mouseWorldPosition.x != mLastMouseWorldPosition.x ||
+        mouseWorldPosition.y != mLastMouseWorldPosition.y)
+    {
+        mEventBus.Publish(MouseMoveEvent{ mMouseScreenPosition, mouseWorldPosition, motion });
+        mLastMouseWorldPosition = mouseWorldPosition;
+    }
+
+    const uint8_t* state = mInput.GetKeyState();
     if (state[SDL_SCANCODE_ESCAPE])
     {
         Quit();
     }
 
-    // Process input for all Actors
-    mUpdatingActors = true;
-    for (auto& actor : mActors)
+    mEventBus.Dispatch();
+}
+
+void Game::SubscribeEvents()
+{
+    mEventBus.Subscribe<MouseDownEvent>([this](const MouseDownEvent& event) { OnMouseDown(event); });
+    mEventBus.Subscribe<MouseUpEvent>([this](const MouseUpEvent& event)
     {
-        actor->ProcessInput(state);
+        if (event.button == SDL_BUTTON_RIGHT || event.button == SDL_BUTTON_MIDDLE)
+        {
+            mIsPanning = false;
+        }
+    });
+    mEventBus.Subscribe<MouseMoveEvent>([this](const MouseMoveEvent& event)
+    {
+        if (mIsPanning)
+        {
+            mCamera.Pan(event.screenDelta);
+        }
+        else
+        {
+            UpdateHover(event.worldPosition);
+        }
+    });
+    mEventBus.Subscribe<TweenFinishedEvent>([this](const TweenFinishedEvent& event)
+    {
+        TextActor* tile = dynamic_cast<TextActor*>(event.target);
+        if (tile && tile->IsRetiring() && event.property == TweenProperty::Scale)
+        {
+            tile->SetState(ActorState::Destroy);
+        }
+    });
+    mEventBus.Subscribe<DropEvent>([this](const DropEvent& event) { OnActorDropped(event.dropped); });
+
+    // Progress is saved as it happens
+    mEventBus.Subscribe<CombinationResolvedEvent>([this](const CombinationResolvedEvent& event)
+    {
+        if (event.result != INVALID_ELEMENT && mSaveGame)
+        {
+            mSaveGame->AddRecipe(event.a, event.b, event.result);
+        }
+    });
+    mEventBus.Subscribe<ElementDiscoveredEvent>([this](const ElementDiscoveredEvent& event)
+    {
+        if (mSaveGame)
+        {
+            mSaveGame->AddDiscovery(event.name);
+        }
+    });
+}
+
+void Game::OnMouseDown(const MouseDownEvent& event)
+{
+    if (event.button == SDL_BUTTON_RIGHT || event.button == SDL_BUTTON_MIDDLE)
+    {
+        mIsPanning = true;
+        return;
+    }
+    if (event.button != SDL_BUTTON_LEFT)
+    {
+        return;
+    }
+
+    if (mSidebar && mSidebar->Contains(event.screenPosition))
+    {
+        // Pull a new tile out of the sidebar and start dragging it
+        NameId name = mSidebar->EntryAt(event.screenPosition);
+        if (name != INVALID_NAME)
+        {
+            TextActor* spawned = SpawnElement(name, event.worldPosition);
+            spawned->GetComponent<DragComponent>()->BeginDrag(event.worldPosition);
+        }
+        return;
+    }
+
+    Actor* picked = PickActor(event.worldPosition);
+    TextActor* tile = dynamic_cast<TextActor*>(picked);
+    DragComponent* drag = picked ? picked->GetComponent<DragComponent>() : nullptr;
+    if (drag && !(tile && tile->IsPending()))
+    {
+        drag->BeginDrag(event.worldPosition);
     }
-    mUpdatingActors = false;
 }
 
 void Game::UpdateGame()
 {
-    while (!SDL_TICKS_PASSED(SDL_GetTicks(), mTicksCount + 16));
+    if (!RunsUnthrottled())
+    {
+        // Sleep off the rest of the frame instead of spinning
+        Uint32 now = SDL_GetTicks();
+        if (!SDL_TICKS_PASSED(now, mTicksCount + FRAME_TIME_MS))
+        {
+            SDL_Delay(mTicksCount + FRAME_TIME_MS - now);
+        }
+    }
 
-    float deltaTime = (SDL_GetTicks() - mTicksCount) / 1000.0f;
-    if (deltaTime > 0.05f)
+    float deltaTime = InputSystem::FIXED_TIMESTEP;
+    if (!UsesFixedTimestep())
     {
-        deltaTime = 0.05f;
+        deltaTime = (SDL_GetTicks() - mTicksCount) / 1000.0f;
+        if (deltaTime > 0.05f)
+        {
+            deltaTime = 0.05f;
+        }
     }
 
     mTicksCount = SDL_GetTicks();
 
-    // Update all actors
+    // Never waits on the generator: only picks up results that are done
+    ApplyResolvedCombinations();
+    StreamSaveChunk();
+    Autosave(deltaTime);
+
+    if (mScenario)
+    {
+        mScenario->Update(mFrameNumber);
+    }
+
+    if (mSidebar)
+    {
+        mSidebar->Update(deltaTime);
+    }
+
+    // Update the awake actors only. Actors woken meanwhile start next frame.
+    mGameTime += deltaTime;
+    WakeDueActors();
     mUpdatingActors = true;
 
-    for (auto& actor : mActors)
+    for (size_t i = 0, count = mAwakeActors.size(); i < count; i++)
     {
-        actor->Update(deltaTime);
+        mAwakeActors[i]->Update(deltaTime);
     }
 
     mUpdatingActors = false;
 
+    // Animations are driven here, so animated tiles can stay dormant
+    mTweens.Update(deltaTime);
+
+    bool separated = UsesFixedTimestep() ? mOverlapSolver.Step(0.0, OVERLAP_CHECKS_PER_FRAME)
+                                         : mOverlapSolver.Step(OVERLAP_BUDGET_MS, 0);
+    if (separated)
+    {
+        mBoardDirty = true;
+    }
+
+    // Idle actors drop out of the update list until woken
+    for (size_t i = 0; i < mAwakeActors.size();)
+    {
+        if (mAwakeActors[i]->IsIdle())
+        {
+            // Swaps the last awake actor into slot i
+            SleepActor(mAwakeActors[i]);
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    // Deliver what this frame's updates published while every actor they
+    // point at is still alive
+    mEventBus.Dispatch();
+
     // Move pending actors to mActors
     for (auto& pending : mPendingActors)
     {
@@ -145,6 +539,10 @@ void Game::UpdateGame()
     mPendingActors.clear();
 
     // Remove dead actors
+    if (mHoveredTile && mHoveredTile->GetState() == ActorState::Destroy)
+    {
+        mHoveredTile = nullptr;
+    }
     mActors.erase(
         std::remove_if(mActors.begin(), mActors.end(),
             [](const std::unique_ptr<Actor>& actor) {
@@ -156,28 +554,479 @@ void Game::UpdateGame()
 
 void Game::GenerateOutput()
 {
-    mRenderer->BeginFrame();
-    
-    // Clear screen with dark background
-    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
-    
-    // Render all actors
-    for (auto& actor : mActors)
+    // A pan, zoom or resize damages the whole frame
+    mDamage.SetView(mCamera.GetVisibleRect());
+
+    if (mHeadless)
+    {
+        // Nothing to draw, but keep the visibility query so headless
+        // scenarios still measure culling cost
+        mSpatialGrid.QueryRect(mCamera.GetVisibleRect(), mQueryResults);
+        mDamage.Clear();
+        return;
+    }
+
+    // Nothing visible changed: the last frame is still on screen
+    if (!mDamage.IsDamaged())
+    {
+        return;
+    }
+
+    FrameMailbox* mailbox = mRenderThread.GetMailbox();
+    FrameSnapshot& frame = mailbox->GetWriteSlot();
+    frame.Reset();
+    frame.camera = mCamera;
+
+    const Rect& visible = mCamera.GetVisibleRect();
+    if (mRenderThread.HasStaticLayer())
     {
-        if (actor->GetState() == ActorState::Active)
+        // Settle which actors in the chunks the render thread will show are
+        // drawn live. One switching sides makes the cached chunks under it
+        // stale. Live actors in view are drawn on top of the cache.
+        Rect covered = mStaticLayer.BeginFrame(mCamera, mailbox->GetDrawnSequence());
+        mSpatialGrid.QueryRect(covered, mQueryResults);
+        mLiveActors.clear();
+        for (Actor* actor : mQueryResults)
         {
-            actor->OnDraw(mTextRenderer.get());
+            bool live = IsDrawnLive(actor);
+            if (live != actor->mDrawnLive)
+            {
+                actor->mDrawnLive = live;
+                mStaticLayer.Invalidate(actor->GetBounds());
+            }
+            if (live && actor->GetState() == ActorState::Active && actor->GetBounds().Intersects(visible))
+            {
+                mLiveActors.push_back(actor);
+            }
         }
+        SortByStackOrder(mLiveActors);
+        for (Actor* actor : mLiveActors)
+        {
+            actor->OnDraw(&frame.live);
+        }
+
+        // Resting tiles are only sent for the chunks that need baking
+        mStaticLayer.FillPlan(frame, [this, &frame](const Rect& area)
+        {
+            mSpatialGrid.QueryRect(area, mQueryResults);
+            SortByStackOrder(mQueryResults);
+            for (Actor* actor : mQueryResults)
+            {
+                if (!actor->mDrawnLive && actor->GetState() == ActorState::Active)
+                {
+                    actor->OnDraw(&frame.board);
+                }
+            }
+        });
     }
-    
-    mRenderer->EndFrame();
-    
-    SDL_GL_SwapWindow(mWindow);
+    else
+    {
+        // No cache: every tile in view is drawn every frame
+        mSpatialGrid.QueryRect(visible, mQueryResults);
+        SortByStackOrder(mQueryResults);
+        for (Actor* actor : mQueryResults)
+        {
+            if (actor->GetState() == ActorState::Active)
+            {
+                actor->OnDraw(&frame.live);
+            }
+        }
+    }
+
+    // UI is drawn in screen space on top of the board
+    if (mSidebar && mTextRenderer)
+    {
+        mSidebar->Draw(&frame.overlay, mTextRenderer.get());
+    }
+
+    mStaticLayer.OnPublished(mailbox->Publish());
+    // Sessions measure what a frame costs, drawing included
+    if (RunsUnthrottled() && mRenderThread.IsRunning())
+    {
+        mailbox->WaitUntilDrawn();
+    }
+    mDamage.Clear();
+}
+
+bool Game::IsDrawnLive(const Actor* actor) const
+{
+    return actor->IsAwake() || actor->mTweenSlot >= 0 || actor->mSolverIndex >= 0;
+}
+
+void Game::SortByStackOrder(std::vector<Actor*>& actors)
+{
+    std::sort(actors.begin(), actors.end(),
+        [](const Actor* a, const Actor* b) { return a->mStackOrder < b->mStackOrder; });
+}
+
+void Game::InvalidateArea(const Actor* actor, const Rect& bounds)
+{
+    mDamage.AddWorld(bounds);
+    if (!actor->mDrawnLive && !mHeadless)
+    {
+        mStaticLayer.Invalidate(bounds);
+    }
+}
+
+void Game::OnWindowResized(int width, int height)
+{
+    mDamage.InvalidateAll();
+    mCamera.SetViewportSize(width, height);
+    if (mSidebar)
+    {
+        mSidebar->SetViewportSize(width, height);
+    }
+}
+
+Actor* Game::PickActor(const Vector2& worldPoint)
+{
+    mSpatialGrid.QueryPoint(worldPoint, mQueryResults);
+
+    // Several tiles may overlap the point; take the one drawn on top
+    Actor* picked = nullptr;
+    for (Actor* actor : mQueryResults)
+    {
+        if (actor->GetState() == ActorState::Active && (!picked || actor->mStackOrder > picked->mStackOrder))
+        {
+            picked = actor;
+        }
+    }
+    return picked;
+}
+
+Actor* Game::FindDropTarget(Actor* dropped)
+{
+    mSpatialGrid.QueryRect(dropped->GetBounds(), mQueryResults);
+
+    Vector2 center = dropped->GetBounds().GetCenter();
+    Actor* target = nullptr;
+    float bestDistSq = Math::Infinity;
+    for (Actor* actor : mQueryResults)
+    {
+        if (actor == dropped || actor->GetState() != ActorState::Active)
+        {
+            continue;
+        }
+        float distSq = (actor->GetBounds().GetCenter() - center).LengthSq();
+        if (distSq < bestDistSq)
+        {
+            bestDistSq = distSq;
+            target = actor;
+        }
+    }
+    return target;
+}
+
+void Game::OnActorDragged(Actor* dragged)
+{
+    TextActor* tile = dynamic_cast<TextActor*>(dragged);
+    if (mPrefetcher && tile)
+    {
+        mPrefetcher->OnDrag(tile);
+    }
+}
+
+void Game::OnActorDropped(Actor* dropped)
+{
+    mBoardDirty = true;
+    TryCombine(dropped);
+    // Unless it merged, make room for it
+    mOverlapSolver.Enqueue(dropped);
+
+    // Speculative work for the other candidates is no longer useful
+    if (mPrefetcher)
+    {
+        mPrefetcher->OnDragEnd();
+    }
+}
+
+void Game::TryCombine(Actor* dropped)
+{
+    TextActor* first = dynamic_cast<TextActor*>(dropped);
+    TextActor* second = dynamic_cast<TextActor*>(FindDropTarget(dropped));
+    if (!first || !second || first->IsPending() || second->IsPending())
+    {
+        return;
+    }
+
+    ElementId a = first->GetName();
+    ElementId b = second->GetName();
+    ElementId result = CombineElements(a, b);
+    if (mPrefetcher)
+    {
+        mPrefetcher->OnDrop(a, b, result != INVALID_ELEMENT);
+    }
+
+    if (result != INVALID_ELEMENT)
+    {
+        // The result replaces both tiles at the drop target's position
+        SpawnElement(result, second->GetPosition());
+        RetireTile(first);
+        RetireTile(second);
+        return;
+    }
+
+    if (!mResolver)
+    {
+        return;
+    }
+
+    // Unknown pair: generate it in the background and show both tiles as pending
+    mResolver->Resolve(a, b);
+    first->SetPending(true);
+    second->SetPending(true);
+    mPendingMerges.push_back(PendingMerge{ a, b, first, second });
+}
+
+void Game::ApplyResolvedCombinations()
+{
+    if (!mResolver)
+    {
+        return;
+    }
+
+    // A recording and its replay must merge on the same frame, so they take
+    // every result on the frame after it was requested, however long the
+    // generator took
+    if (mInput.GetMode() != InputSystem::Mode::Live)
+    {
+        mResolver->WaitForIdle();
+    }
+    mResolver->Poll(mCompletions);
+    for (const CombinationResolver::Completion& completion : mCompletions)
+    {
+        mEventBus.Publish(CombinationResolvedEvent{ completion.a, completion.b, completion.result });
+
+        ElementId lo = std::min(completion.a, completion.b);
+        ElementId hi = std::max(completion.a, completion.b);
+
+        auto it = mPendingMerges.begin();
+        while (it != mPendingMerges.end())
+        {
+            if (std::min(it->a, it->b) != lo || std::max(it->a, it->b) != hi)
+            {
+                ++it;
+                continue;
+            }
+
+            if (completion.result != INVALID_ELEMENT)
+            {
+                SpawnElement(completion.result, it->second->GetPosition());
+                RetireTile(it->first);
+                RetireTile(it->second);
+            }
+            else
+            {
+                // Generation failed: give the tiles back to the player
+                it->first->SetPending(false);
+                it->second->SetPending(false);
+                mOverlapSolver.Enqueue(it->first);
+                mOverlapSolver.Enqueue(it->second);
+            }
+            it = mPendingMerges.erase(it);
+        }
+    }
+}
+
+ElementId Game::CombineElements(ElementId first, ElementId second) const
+{
+    // Recipes known in-process take precedence over the shipped database
+    ElementId result = mRecipeBook.Combine(first, second);
+    if (result != INVALID_ELEMENT || !mRecipeDatabase.IsOpen())
+    {
+        return result;
+    }
+
+    ElementId a = mRecipeDatabase.FindElement(RecipeBook::GetName(first));
+    ElementId b = mRecipeDatabase.FindElement(RecipeBook::GetName(second));
+    if (a == INVALID_ELEMENT || b == INVALID_ELEMENT)
+    {
+        return INVALID_ELEMENT;
+    }
+
+    result = mRecipeDatabase.Combine(a, b);
+    std::string_view name = mRecipeDatabase.GetName(result);
+    if (name.empty())
+    {
+        return INVALID_ELEMENT;
+    }
+
+    // Copied: the mapped string pool is unmapped with the database, but
+    // the table lives for the whole process
+    return StringTable::Get().Intern(name);
+}
+
+TextActor* Game::SpawnElement(ElementId name, const Vector2& position)
+{
+    // Every element that appears on the board counts as discovered
+    if (mSidebar && mSidebar->AddEntry(name))
+    {
+        mEventBus.Publish(ElementDiscoveredEvent{ name });
+    }
+    mBoardDirty = true;
+
+    auto actor = std::make_unique<TextActor>(this, name);
+    actor->SetPosition(position);
+    TextActor* ptr = actor.get();
+    AddActor(std::move(actor));
+    PopIn(ptr, Vector2(1.0f, 1.0f));
+    mOverlapSolver.Enqueue(ptr);
+    return ptr;
+}
+
+void Game::PopIn(TextActor* tile, const Vector2& scale)
+{
+    mTweens.Start(tile, TweenProperty::Scale, scale * POP_IN_START_SCALE, scale, POP_IN_DURATION, Easing::OutBack);
+}
+
+void Game::RetireTile(TextActor* tile)
+{
+    tile->SetPending(true);
+    tile->SetRetiring(true);
+    mTweens.Start(tile, TweenProperty::Scale, Vector2::Zero, RETIRE_DURATION, Easing::InBack);
+}
+
+void Game::UpdateHover(const Vector2& worldPoint)
+{
+    TextActor* tile = dynamic_cast<TextActor*>(PickActor(worldPoint));
+    if (tile && tile->IsPending())
+    {
+        tile = nullptr;
+    }
+    if (tile == mHoveredTile)
+    {
+        return;
+    }
+
+    if (mHoveredTile && !mHoveredTile->IsRetiring())
+    {
+        mTweens.Start(mHoveredTile, TweenProperty::Scale, Vector2(1.0f, 1.0f), HOVER_DURATION, Easing::OutQuad);
+    }
+    mHoveredTile = tile;
+    if (tile)
+    {
+        mTweens.Start(tile, TweenProperty::Scale, Vector2(HOVER_SCALE, HOVER_SCALE), HOVER_DURATION, Easing::OutQuad);
+    }
+}
+
+void Game::StreamSaveChunk()
+{
+    if (!mSaveGame || !mSaveGame->IsLoading())
+    {
+        return;
+    }
+    if (!mSaveGame->LoadNextChunk(mLoadChunk))
+    {
+        SDL_Log("Saved game loaded");
+        return;
+    }
+
+    // Loaded progress is already saved, so it bypasses AddRecipe/AddDiscovery
+    switch (mLoadChunk.kind)
+    {
+        case SaveGame::ChunkKind::Recipes:
+            for (const SaveGame::RecipeRecord& recipe : mLoadChunk.recipes)
+            {
+                mRecipeBook.AddRecipe(recipe.a, recipe.b, recipe.result);
+            }
+            break;
+        case SaveGame::ChunkKind::Discovered:
+            for (NameId name : mLoadChunk.discovered)
+            {
+                mSidebar->AddEntry(name);
+            }
+            break;
+        case SaveGame::ChunkKind::Board:
+            for (const SaveGame::TileRecord& tile : mLoadChunk.tiles)
+            {
+                TextActor* actor = SpawnElement(tile.name, tile.position);
+                PopIn(actor, tile.scale);
+                actor->SetRotation(tile.rotation);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void Game::Autosave(float deltaTime)
+{
+    mAutosaveTimer += deltaTime;
+    if (!mSaveGame || mAutosaveTimer < AUTOSAVE_INTERVAL)
+    {
+        return;
+    }
+    if (!mBoardDirty && !mSaveGame->HasUnsavedProgress())
+    {
+        mAutosaveTimer = 0.0f;
+        return;
+    }
+
+    // Only the board snapshot happens here; encoding and I/O are on the save
+    // thread. If it is still busy, try again next frame.
+    CollectBoard(mSaveBoard);
+    if (mSaveGame->Autosave(mSaveBoard))
+    {
+        mBoardDirty = false;
+        mAutosaveTimer = 0.0f;
+    }
+}
+
+void Game::CollectBoard(std::vector<SaveGame::TileRecord>& outTiles) const
+{
+    outTiles.clear();
+    auto collect = [this, &outTiles](const std::vector<std::unique_ptr<Actor>>& actors)
+    {
+        for (const auto& actor : actors)
+        {
+            const TextActor* tile = dynamic_cast<const TextActor*>(actor.get());
+            if (!tile || tile->GetState() == ActorState::Destroy || tile->IsRetiring())
+            {
+                continue;
+            }
+
+            // Save resting scales, not a frame of an animation or the hover highlight
+            Vector2 scale = tile->GetScale();
+            mTweens.GetEndValue(tile, TweenProperty::Scale, scale);
+            if (tile == mHoveredTile)
+            {
+                scale = Vector2(1.0f, 1.0f);
+            }
+            outTiles.push_back(SaveGame::TileRecord{ tile->GetName(), tile->GetPosition(), scale,
+                                                     tile->GetRotation() });
+        }
+    };
+    collect(mActors);
+    collect(mPendingActors);
+}
+
+void Game::LogFrameTimes() const
+{
+    std::vector<float> sorted(mFrameTimes);
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](float p)
+    {
+        size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5f);
+        return sorted[index];
+    };
+
+    double total = 0.0;
+    for (float time : sorted)
+    {
+        total += time;
+    }
+    SDL_Log("Frame times over %zu frames (ms): mean %.3f, p50 %.3f, p90 %.3f, p99 %.3f, max %.3f",
+            sorted.size(), total / sorted.size(), percentile(0.5f), percentile(0.9f), percentile(0.99f),
+            sorted.back());
 }
 
 void Game::AddActor(std::unique_ptr<Actor> actor)
 {
+    actor->mStackOrder = ++mStackTop;
+    mSpatialGrid.Insert(actor.get(), actor->GetBounds());
+    mDamage.AddWorld(actor->GetBounds());
+    WakeActor(actor.get());
+
     if (mUpdatingActors)
     {
         mPendingActors.emplace_back(std::move(actor));
@@ -190,6 +1039,11 @@ void Game::AddActor(std::unique_ptr<Actor> actor)
 
 void Game::RemoveActor(Actor* actor)
 {
+    if (actor == mHoveredTile)
+    {
+        mHoveredTile = nullptr;
+    }
+
     auto it = std::find_if(mActors.begin(), mActors.end(),
         [actor](const std::unique_ptr<Actor>& a) {
             return a.get() == actor;
@@ -211,24 +1065,127 @@ void Game::RemoveActor(Actor* actor)
     }
 }
 
+void Game::WakeActor(Actor* actor)
+{
+    if (actor->mAwakeIndex < 0)
+    {
+        actor->mAwakeIndex = static_cast<int>(mAwakeActors.size());
+        mAwakeActors.push_back(actor);
+    }
+}
+
+void Game::SleepActor(Actor* actor)
+{
+    int index = actor->mAwakeIndex;
+    if (index < 0)
+    {
+        return;
+    }
+    Actor* last = mAwakeActors.back();
+    mAwakeActors[index] = last;
+    last->mAwakeIndex = index;
+    mAwakeActors.pop_back();
+    actor->mAwakeIndex = -1;
+}
+
+void Game::WakeActorAfter(Actor* actor, float seconds)
+{
+    float time = mGameTime + std::max(seconds, 0.0f);
+    if (actor->mWakeTime >= 0.0f)
+    {
+        if (actor->mWakeTime <= time)
+        {
+            return;
+        }
+        CancelWakeTimer(actor);
+    }
+    actor->mWakeTime = time;
+    mWakeTimers.push_back(WakeTimer{ time, actor });
+    std::push_heap(mWakeTimers.begin(), mWakeTimers.end(), std::greater<WakeTimer>());
+}
+
+void Game::CancelWakeTimer(Actor* actor)
+{
+    // Few actors sleep on a timer, so a scan is cheaper than an index
+    auto it = std::find_if(mWakeTimers.begin(), mWakeTimers.end(),
+        [actor](const WakeTimer& timer) { return timer.actor == actor; });
+    if (it != mWakeTimers.end())
+    {
+        mWakeTimers.erase(it);
+        std::make_heap(mWakeTimers.begin(), mWakeTimers.end(), std::greater<WakeTimer>());
+    }
+    actor->mWakeTime = -1.0f;
+}
+
+void Game::RaiseActor(Actor* actor)
+{
+    if (actor->mStackOrder == mStackTop)
+    {
+        return;
+    }
+    actor->mStackOrder = ++mStackTop;
+    InvalidateArea(actor, actor->GetBounds());
+}
+
+void Game::WakeDueActors()
+{
+    while (!mWakeTimers.empty() && mWakeTimers.front().time <= mGameTime)
+    {
+        std::pop_heap(mWakeTimers.begin(), mWakeTimers.end(), std::greater<WakeTimer>());
+        Actor* actor = mWakeTimers.back().actor;
+        mWakeTimers.pop_back();
+        actor->mWakeTime = -1.0f;
+        WakeActor(actor);
+    }
+}
+
 void Game::Shutdown()
 {
     // Clear actors (smart pointers will automatically clean up)
     mIsRunning = false;
+    if (mPrefetcher)
+    {
+        const Prefetcher::Stats& stats = mPrefetcher->GetStats();
+        SDL_Log("Prefetch: %zu requested, %zu cancelled, %zu hits, %zu in-flight hits, %zu misses (hit rate %.0f%%)",
+                stats.requested, stats.cancelled, stats.hits, stats.inFlightHits, stats.misses,
+                stats.GetHitRate() * 100.0f);
+    }
+
+    mInput.Stop();
+    if (!mFrameTimes.empty())
+    {
+        LogFrameTimes();
+    }
+
+    // Final save; skipped if the previous session never finished loading
+    mEventBus.Dispatch();
+    if (mSaveGame)
+    {
+        mSaveGame->Wait();
+        CollectBoard(mSaveBoard);
+        if (mSaveGame->Autosave(mSaveBoard))
+        {
+            mSaveGame->Wait();
+        }
+        mSaveGame.reset();
+    }
+
+    mPendingMerges.clear();
+    mHoveredTile = nullptr;
     mActors.clear();
     mPendingActors.clear();
+    mScenario.reset();
+    mPrefetcher.reset();
+    mResolver.reset();
+    mSidebar.reset();
 
+    // Takes the GL context back, so the text renderer can release its objects
+    mRenderThread.Stop();
     if (mTextRenderer)
     {
         mTextRenderer.reset();
     }
 
-    if (mRenderer)
-    {
-        mRenderer->Shutdown();
-        mRenderer.reset();
-    }
-
     // Cleanup OpenGL context
     if (mGLContext)
     {
@@ -236,6 +1193,10 @@ void Game::Shutdown()
         mGLContext = nullptr;
     }
 
-    SDL_DestroyWindow(mWindow);
+    if (mWindow)
+    {
+        SDL_DestroyWindow(mWindow);
+        mWindow = nullptr;
+    }
     SDL_Quit();
 }
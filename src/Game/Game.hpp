@@ -6,10 +6,26 @@
 #include <SDL.h>
 #include <vector>
 #include <memory>
+#include <string>
 #include "../Math.h"
 #include "../Actor/Actor.hpp"
-#include "../Core/Renderer/Renderer.hpp"
 #include "../Core/TextRenderer/TextRenderer.hpp"
+#include "../Core/Camera/Camera.hpp"
+#include "../Core/SpatialGrid/SpatialGrid.hpp"
+#include "../Core/SaveGame/SaveGame.hpp"
+#include "../Core/InputSystem/InputSystem.hpp"
+#include "../Core/EventBus/EventBus.hpp"
+#include "../Core/EventBus/Events.hpp"
+#include "../Core/OverlapSolver/OverlapSolver.hpp"
+#include "../Core/DamageTracker/DamageTracker.hpp"
+#include "../Core/RenderThread/RenderThread.hpp"
+#include "../Core/StaticLayer/StaticLayerPlanner.hpp"
+#include "../Recipe/RecipeBook.hpp"
+#include "../Recipe/RecipeDatabase.hpp"
+#include "../Recipe/CombinationResolver.hpp"
+#include "../Recipe/Prefetcher.hpp"
+#include "../UI/Sidebar/Sidebar.hpp"
+#include "../Scenario/Scenario.hpp"
 
 class Game
 {
@@ -25,13 +41,157 @@ public:
     void AddActor(std::unique_ptr<Actor> actor);
     void RemoveActor(Actor* actor);
 
+    // Sleep tiers (see Actor::Wake): move actors in and out of the update list
+    void WakeActor(Actor* actor);
+    void SleepActor(Actor* actor);
+    void WakeActorAfter(Actor* actor, float seconds);
+    void CancelWakeTimer(Actor* actor);
+    // Put an actor on top of every other (new actors start there)
+    void RaiseActor(Actor* actor);
+    size_t GetAwakeActorCount() const { return mAwakeActors.size(); }
+
+    // Subsystem getters
+    Camera* GetCamera() { return &mCamera; }
+    TextRenderer* GetTextRenderer() { return mTextRenderer.get(); }
+    SpatialGrid* GetSpatialGrid() { return &mSpatialGrid; }
+    RecipeBook* GetRecipeBook() { return &mRecipeBook; }
+    // Input source; select recording/replay before Initialize
+    InputSystem* GetInput() { return &mInput; }
+    // Mouse, drop and progress events, dispatched once per frame
+    EventBus* GetEventBus() { return &mEventBus; }
+    TweenSystem* GetTweens() { return &mTweens; }
+    OverlapSolver* GetOverlapSolver() { return &mOverlapSolver; }
+    // Whether anything visible changed; undamaged frames aren't drawn
+    DamageTracker* GetDamage() { return &mDamage; }
+    // An actor's drawn area changed: redraw it, and have the render thread
+    // rebake the cached board chunks under it unless the actor is drawn live
+    void InvalidateArea(const Actor* actor, const Rect& bounds);
+    const std::vector<std::unique_ptr<Actor>>& GetActors() const { return mActors; }
+
+    // Run without a window or GL context (call before Initialize)
+    void SetHeadless(bool headless) { mHeadless = headless; }
+    bool IsHeadless() const { return mHeadless; }
+    // Drive the session from a scenario script, optionally logging per-frame
+    // metrics as CSV (call before Initialize)
+    void SetScenario(const std::string& scriptPath, const std::string& metricsPath)
+    {
+        mScenarioPath = scriptPath;
+        mMetricsPath = metricsPath;
+    }
+
+    // Mouse state sampled once per frame
+    Vector2 GetMouseWorldPosition() const { return mCamera.ScreenToWorld(mMouseScreenPosition); }
+    bool IsMouseButtonDown(int button) const { return (mMouseButtons & SDL_BUTTON(button)) != 0; }
+
+    // Topmost active actor under a world point, or null
+    Actor* PickActor(const Vector2& worldPoint);
+    // Active actor overlapping the dropped actor closest to its center, or null
+    Actor* FindDropTarget(Actor* dropped);
+
+    // Called every frame while a tile follows the mouse
+    void OnActorDragged(Actor* dragged);
+    // Called when a dragged tile is released (via DropEvent); combines it with the tile underneath
+    void OnActorDropped(Actor* dropped);
+    // Result of combining two elements, or INVALID_ELEMENT if no recipe is known
+    ElementId CombineElements(ElementId first, ElementId second) const;
+    // Spawn a new element tile at a world position
+    class TextActor* SpawnElement(ElementId name, const Vector2& position);
+
+    // Seconds between autosave attempts (only when something changed)
+    static constexpr float AUTOSAVE_INTERVAL = 5.0f;
+
+    // Tile animations (seconds / scale factors)
+    static constexpr float POP_IN_DURATION = 0.18f;
+    static constexpr float POP_IN_START_SCALE = 0.3f;
+    static constexpr float RETIRE_DURATION = 0.15f;
+    static constexpr float HOVER_DURATION = 0.1f;
+    static constexpr float HOVER_SCALE = 1.12f;
+
+    // Per-frame work for separating overlapping tiles: a time budget in live
+    // play, a fixed count in replays and scenarios so they stay deterministic
+    static constexpr double OVERLAP_BUDGET_MS = 1.0;
+    static constexpr size_t OVERLAP_CHECKS_PER_FRAME = 2048;
+
+    // Frame pacing while something is going on
+    static const Uint32 FRAME_TIME_MS = 16;
+    // Longest an idle game blocks waiting for input before checking again
+    static const Uint32 IDLE_WAIT_LIMIT_MS = 500;
+
+    // Initial window size (the window is resizable)
     static const int WINDOW_WIDTH = 800;
     static const int WINDOW_HEIGHT = 600;
 
 private:
+    bool InitializeVideo();
+    // Recorded, replayed and scripted sessions advance by a fixed step with
+    // a fixed amount of overlap solving, so a replay repeats its recording
+    bool UsesFixedTimestep() const { return mInput.GetMode() != InputSystem::Mode::Live || !mScenarioPath.empty(); }
+    // Replays and scenarios also run unthrottled (a recording is played live)
+    bool RunsUnthrottled() const { return mInput.IsReplaying() || !mScenarioPath.empty(); }
+    // True when the next frame would neither change nor draw anything
+    bool CanWaitForEvents() const;
+    // Block until input arrives or the next timer is due
+    void WaitForEvents();
     void ProcessInput();
+    void SubscribeEvents();
+    // Start a drag from the board or the sidebar, or a camera pan
+    void OnMouseDown(const MouseDownEvent& event);
+    // Grow the tile under the pointer, shrink the one it left
+    void UpdateHover(const Vector2& worldPoint);
+    // Scale a new tile up from small to its resting scale
+    void PopIn(class TextActor* tile, const Vector2& scale);
+    // Shrink a merged-away tile out; it is destroyed when the animation ends
+    void RetireTile(class TextActor* tile);
     void UpdateGame();
+    // Wake the actors whose timers have expired
+    void WakeDueActors();
+    // Snapshot what changed on screen and hand it to the render thread
     void GenerateOutput();
+    // Moving, animating and dragged actors skip the static layer
+    bool IsDrawnLive(const Actor* actor) const;
+    // Order actors bottom to top, as they are drawn
+    static void SortByStackOrder(std::vector<Actor*>& actors);
+    void OnWindowResized(int width, int height);
+    // Apply combination results that finished generating since the last frame
+    void ApplyResolvedCombinations();
+    // Combine a dropped tile with its drop target (immediately or via the resolver)
+    void TryCombine(Actor* dropped);
+    // Apply one chunk of the save being loaded (one file per frame)
+    void StreamSaveChunk();
+    // Snapshot the board and hand it to the save thread if anything changed
+    void Autosave(float deltaTime);
+    void CollectBoard(std::vector<SaveGame::TileRecord>& outTiles) const;
+    // Frame-time distribution of a replayed session
+    void LogFrameTimes() const;
+
+    // Spatial index over actor bounds (declared before the actors so it outlives them)
+    SpatialGrid mSpatialGrid;
+    // Declared before the actors too: their components unsubscribe on destruction
+    EventBus mEventBus;
+    // Also before the actors, which cancel their tweens on destruction
+    TweenSystem mTweens;
+    // Likewise: destroyed actors leave its restless list
+    OverlapSolver mOverlapSolver;
+    // And damage the area they were drawn in
+    DamageTracker mDamage;
+    // Which board chunks the render thread caches, and which are stale
+    // (invalidated by actors too, so also declared before them)
+    StaticLayerPlanner mStaticLayer;
+
+    // Actors updated every frame; everything else is dormant (also
+    // declared before the actors, which leave it on destruction)
+    std::vector<Actor*> mAwakeActors;
+    struct WakeTimer
+    {
+        float time;
+        Actor* actor;
+
+        bool operator>(const WakeTimer& other) const { return time > other.time; }
+    };
+    // Min-heap on time, at most one entry per actor
+    std::vector<WakeTimer> mWakeTimers;
+    // Seconds of simulated time, drives the wake timers
+    float mGameTime;
 
     // All the actors in the game
     std::vector<std::unique_ptr<Actor>> mActors;
@@ -40,8 +200,44 @@ private:
     // SDL stuff
     SDL_Window* mWindow;
     SDL_GLContext mGLContext;
-    std::unique_ptr<Renderer> mRenderer;
+    // Shared with the render thread, which draws with it; the
+    // simulation only measures text
     std::unique_ptr<TextRenderer> mTextRenderer;
+    // Owns the GL context once started
+    RenderThread mRenderThread;
+
+    // Known element combinations
+    RecipeBook mRecipeBook;
+    RecipeDatabase mRecipeDatabase;
+    // Generates results for unknown pairs off the main thread
+    std::unique_ptr<CombinationResolver> mResolver;
+    // Resolves likely drop targets while dragging
+    std::unique_ptr<Prefetcher> mPrefetcher;
+
+    // Tiles dropped on each other that wait for a generated result
+    struct PendingMerge
+    {
+        ElementId a;
+        ElementId b;
+        class TextActor* first;
+        class TextActor* second;
+    };
+    std::vector<PendingMerge> mPendingMerges;
+    std::vector<CombinationResolver::Completion> mCompletions;
+
+    // Discovered elements list
+    std::unique_ptr<Sidebar> mSidebar;
+
+    // Persistence: streamed in at startup, written back in the background
+    std::unique_ptr<SaveGame> mSaveGame;
+    SaveGame::Chunk mLoadChunk;
+    std::vector<SaveGame::TileRecord> mSaveBoard;
+    // Tiles were added, removed or moved since the last autosave
+    bool mBoardDirty;
+    float mAutosaveTimer;
+
+    // View over the board, drives every renderer's projection
+    Camera mCamera;
 
     // Track elapsed time since game start
     Uint32 mTicksCount;
@@ -49,4 +245,34 @@ private:
     // Track if we're updating actors right now
     bool mIsRunning;
     bool mUpdatingActors;
+
+    // Camera panning with the right mouse button
+    bool mIsPanning;
+
+    // Scripted stress session
+    bool mHeadless;
+    std::string mScenarioPath;
+    std::string mMetricsPath;
+    std::unique_ptr<Scenario> mScenario;
+    uint32_t mFrameNumber;
+
+    // Live, recorded or replayed input
+    InputSystem mInput;
+    // Per-frame cost in milliseconds while replaying
+    std::vector<float> mFrameTimes;
+
+    // Mouse state for this frame
+    Vector2 mMouseScreenPosition;
+    Uint32 mMouseButtons;
+    // Pointer position of the last MouseMoveEvent
+    Vector2 mLastMouseWorldPosition;
+    // Tile scaled up under the pointer (cleared before it is destroyed)
+    class TextActor* mHoveredTile;
+
+    // Last stacking position handed out (see RaiseActor)
+    uint64_t mStackTop;
+
+    // Reused query buffers (avoid per-frame allocation)
+    std::vector<Actor*> mQueryResults;
+    std::vector<Actor*> mLiveActors;
 };
\ No newline at end of file
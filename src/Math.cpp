@@ -27,6 +27,9 @@ const Vector3 Vector3::NegInfinity(Math::NegInfinity, Math::NegInfinity, Math::N
 // Matrix4 static variables
 const Matrix4 Matrix4::Identity = Matrix4();
 
+// Matrix3x2 static variables
+const Matrix3x2 Matrix3x2::Identity = Matrix3x2();
+
 // Transform Vector2 by Matrix4
 Vector2 Vector2::Transform(const Vector2& vec, const Matrix4& mat, float w)
 {
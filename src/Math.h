@@ -1,17 +1,20 @@
 // ----------------------------------------------------------------
 // Math library following the asteroids game architecture
-// Provides Vector2, Vector3, Matrix4 classes and utility functions
+// Provides Vector2, Vector3, Matrix4, Matrix3x2 classes and utility functions
 // ----------------------------------------------------------------
 
 #pragma once
 #include <cmath>
+#include <cstddef>
 #include <cstring>
 #include <limits>
 
 // Forward declarations
 class Vector2;
 class Vector3;
+class Rect;
 class Matrix4;
+class Matrix3x2;
 
 // Mathematical constants
 namespace Math
@@ -132,8 +135,8 @@ public:
     float x;
     float y;
 
-    Vector2() : x(0.0f), y(0.0f) {}
-    explicit Vector2(float inX, float inY) : x(inX), y(inY) {}
+    constexpr Vector2() : x(0.0f), y(0.0f) {}
+    constexpr explicit Vector2(float inX, float inY) : x(inX), y(inY) {}
 
     // Set both components in one line
     void Set(float inX, float inY)
@@ -252,6 +255,60 @@ public:
     static const Vector2 NegUnitY;
 };
 
+// Axis-aligned rectangle described by its min (bottom-left) and max (top-right) corners
+class Rect
+{
+public:
+    Vector2 min;
+    Vector2 max;
+
+    Rect() {}
+    explicit Rect(const Vector2& inMin, const Vector2& inMax) : min(inMin), max(inMax) {}
+
+    // Build a rect from a center point and a full size
+    static Rect FromCenter(const Vector2& center, const Vector2& size)
+    {
+        Vector2 half = size * 0.5f;
+        return Rect(center - half, center + half);
+    }
+
+    float GetWidth() const { return max.x - min.x; }
+    float GetHeight() const { return max.y - min.y; }
+    Vector2 GetSize() const { return max - min; }
+    Vector2 GetCenter() const { return (min + max) * 0.5f; }
+
+    // Point containment (edges inclusive)
+    bool Contains(const Vector2& point) const
+    {
+        return point.x >= min.x && point.x <= max.x &&
+               point.y >= min.y && point.y <= max.y;
+    }
+
+    // Overlap test (touching edges count as overlapping)
+    bool Intersects(const Rect& other) const
+    {
+        return !(other.max.x < min.x || other.min.x > max.x ||
+                 other.max.y < min.y || other.min.y > max.y);
+    }
+
+    // Grow this rect so it also covers other
+    void Merge(const Rect& other)
+    {
+        min.x = Math::Min(min.x, other.min.x);
+        min.y = Math::Min(min.y, other.min.y);
+        max.x = Math::Max(max.x, other.max.x);
+        max.y = Math::Max(max.y, other.max.y);
+    }
+
+    // Squared distance from point to the closest point of the rect (0 if inside)
+    float DistanceSq(const Vector2& point) const
+    {
+        float dx = Math::Max(0.0f, Math::Max(min.x - point.x, point.x - max.x));
+        float dy = Math::Max(0.0f, Math::Max(min.y - point.y, point.y - max.y));
+        return dx * dx + dy * dy;
+    }
+};
+
 class Vector3
 {
 public:
@@ -628,6 +685,155 @@ public:
     static const Matrix4 Identity;
 };
 
+// 2D affine transform: the 2x2 linear part plus a translation row, in the
+// same row-vector convention as Matrix4 (p' = p * M, so a * b applies a
+// first). Six floats instead of sixteen; convert with ToMatrix4() only when
+// uploading to a shader.
+class Matrix3x2
+{
+public:
+    // Rows: image of the x axis, image of the y axis, translation
+    float mat[3][2];
+
+    constexpr Matrix3x2()
+        : mat{ { 1.0f, 0.0f }, { 0.0f, 1.0f }, { 0.0f, 0.0f } }
+    {
+    }
+
+    constexpr Matrix3x2(float m00, float m01, float m10, float m11, float tx, float ty)
+        : mat{ { m00, m01 }, { m10, m11 }, { tx, ty } }
+    {
+    }
+
+    // Composition (a * b: a then b), 12 multiplies instead of Matrix4's 64
+    friend constexpr Matrix3x2 operator*(const Matrix3x2& a, const Matrix3x2& b)
+    {
+        return Matrix3x2(
+            a.mat[0][0] * b.mat[0][0] + a.mat[0][1] * b.mat[1][0],
+            a.mat[0][0] * b.mat[0][1] + a.mat[0][1] * b.mat[1][1],
+            a.mat[1][0] * b.mat[0][0] + a.mat[1][1] * b.mat[1][0],
+            a.mat[1][0] * b.mat[0][1] + a.mat[1][1] * b.mat[1][1],
+            a.mat[2][0] * b.mat[0][0] + a.mat[2][1] * b.mat[1][0] + b.mat[2][0],
+            a.mat[2][0] * b.mat[0][1] + a.mat[2][1] * b.mat[1][1] + b.mat[2][1]);
+    }
+
+    Matrix3x2& operator*=(const Matrix3x2& right)
+    {
+        *this = *this * right;
+        return *this;
+    }
+
+    constexpr float GetDeterminant() const
+    {
+        return mat[0][0] * mat[1][1] - mat[0][1] * mat[1][0];
+    }
+
+    // Invert in place; returns false (leaving the matrix unchanged) if singular
+    bool Invert()
+    {
+        float det = GetDeterminant();
+        if (Math::NearZero(det, 1e-12f))
+        {
+            return false;
+        }
+        float invDet = 1.0f / det;
+        float m00 = mat[1][1] * invDet;
+        float m01 = -mat[0][1] * invDet;
+        float m10 = -mat[1][0] * invDet;
+        float m11 = mat[0][0] * invDet;
+        float tx = -(mat[2][0] * m00 + mat[2][1] * m10);
+        float ty = -(mat[2][0] * m01 + mat[2][1] * m11);
+        *this = Matrix3x2(m00, m01, m10, m11, tx, ty);
+        return true;
+    }
+
+    constexpr Vector2 GetTranslation() const
+    {
+        return Vector2(mat[2][0], mat[2][1]);
+    }
+
+    // Transform a point (applies translation)
+    constexpr Vector2 TransformPoint(const Vector2& point) const
+    {
+        return Vector2(point.x * mat[0][0] + point.y * mat[1][0] + mat[2][0],
+                       point.x * mat[0][1] + point.y * mat[1][1] + mat[2][1]);
+    }
+
+    // Transform a direction (ignores translation)
+    constexpr Vector2 TransformVector(const Vector2& vec) const
+    {
+        return Vector2(vec.x * mat[0][0] + vec.y * mat[1][0],
+                       vec.x * mat[0][1] + vec.y * mat[1][1]);
+    }
+
+    // Transform count points from in to out (in == out is allowed)
+    void TransformPoints(const Vector2* in, Vector2* out, size_t count) const
+    {
+        const float m00 = mat[0][0], m01 = mat[0][1];
+        const float m10 = mat[1][0], m11 = mat[1][1];
+        const float tx = mat[2][0], ty = mat[2][1];
+        for (size_t i = 0; i < count; i++)
+        {
+            float x = in[i].x;
+            float y = in[i].y;
+            out[i].x = x * m00 + y * m10 + tx;
+            out[i].y = x * m01 + y * m11 + ty;
+        }
+    }
+
+    // Widen to a 4x4 matrix (z passes through unchanged) for shader upload
+    Matrix4 ToMatrix4() const
+    {
+        float temp[4][4] =
+        {
+            { mat[0][0], mat[0][1], 0.0f, 0.0f },
+            { mat[1][0], mat[1][1], 0.0f, 0.0f },
+            { 0.0f, 0.0f, 1.0f, 0.0f },
+            { mat[2][0], mat[2][1], 0.0f, 1.0f }
+        };
+        return Matrix4(temp);
+    }
+
+    static constexpr Matrix3x2 CreateScale(float xScale, float yScale)
+    {
+        return Matrix3x2(xScale, 0.0f, 0.0f, yScale, 0.0f, 0.0f);
+    }
+
+    static constexpr Matrix3x2 CreateScale(float scale)
+    {
+        return CreateScale(scale, scale);
+    }
+
+    // Counter-clockwise rotation by theta radians (matches Matrix4::CreateRotationZ)
+    static Matrix3x2 CreateRotation(float theta)
+    {
+        float c = Math::Cos(theta);
+        float s = Math::Sin(theta);
+        return Matrix3x2(c, s, -s, c, 0.0f, 0.0f);
+    }
+
+    static constexpr Matrix3x2 CreateTranslation(const Vector2& trans)
+    {
+        return Matrix3x2(1.0f, 0.0f, 0.0f, 1.0f, trans.x, trans.y);
+    }
+
+    // Scale, then rotate, then translate, built directly (one sin/cos, no multiplies)
+    static Matrix3x2 CreateTransform(const Vector2& scale, float rotation, const Vector2& trans)
+    {
+        float c = Math::Cos(rotation);
+        float s = Math::Sin(rotation);
+        return Matrix3x2(scale.x * c, scale.x * s, -scale.y * s, scale.y * c, trans.x, trans.y);
+    }
+
+    // Maps a width x height area centered on the origin to clip space [-1, 1]
+    static constexpr Matrix3x2 CreateOrtho(float width, float height)
+    {
+        return CreateScale(2.0f / width, 2.0f / height);
+    }
+
+    static const Matrix3x2 Identity;
+};
+
 // Inline implementations for Math namespace functions
 namespace Math
 {
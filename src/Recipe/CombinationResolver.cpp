@@ -0,0 +1,226 @@
+// ----------------------------------------------------------------
+// CombinationResolver implementation
+// ----------------------------------------------------------------
+
+#include "CombinationResolver.hpp"
+#include <iostream>
+
+namespace
+{
+    // Names must round-trip through the "A + B = C" cache format
+    bool IsStorableName(const std::string& name)
+    {
+        return !name.empty() && name.find_first_of("+=#\r\n") == std::string::npos;
+    }
+}
+
+CombinationResolver::CombinationResolver(RecipeBook& recipeBook, std::unique_ptr<Generator> generator,
+                                         size_t workerCount)
+    : mRecipeBook(recipeBook)
+    , mGenerator(std::move(generator))
+    , mRunning(0)
+    , mStopping(false)
+{
+    for (size_t i = 0; i < workerCount; i++)
+    {
+        mWorkers.emplace_back(&CombinationResolver::WorkerLoop, this);
+    }
+}
+
+CombinationResolver::~CombinationResolver()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+        mQueue.clear();
+        mLowQueue.clear();
+    }
+    // Don't wait out generations still running
+    mGenerator->Abort();
+    mWorkAvailable.notify_all();
+    for (std::thread& worker : mWorkers)
+    {
+        worker.join();
+    }
+}
+
+bool CombinationResolver::OpenCache(const std::string& path)
+{
+    // A missing cache is fine; it is created on the first generated recipe
+    std::ifstream existing(path);
+    if (existing)
+    {
+        existing.close();
+        mRecipeBook.LoadFromFile(path);
+    }
+
+    mCacheFile.open(path, std::ios::app);
+    if (!mCacheFile)
+    {
+        std::cout << "ERROR::RESOLVER: Could not open recipe cache " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+ElementId CombinationResolver::Resolve(ElementId a, ElementId b, Priority priority)
+{
+    ElementId known = mRecipeBook.Combine(a, b);
+    if (known != INVALID_ELEMENT)
+    {
+        return known;
+    }
+
+    // Coalesce with a generation that is already queued or running
+    uint64_t key = MakePairKey(a, b);
+    auto it = mInFlight.find(key);
+    if (it != mInFlight.end())
+    {
+        if (it->second == Priority::Low && priority == Priority::High)
+        {
+            it->second = Priority::High;
+
+            // Still queued: move it ahead of the speculative work
+            std::lock_guard<std::mutex> lock(mMutex);
+            Job job;
+            if (TakeJob(mLowQueue, key, &job))
+            {
+                mQueue.push_back(std::move(job));
+            }
+        }
+        return INVALID_ELEMENT;
+    }
+
+    mInFlight.emplace(key, priority);
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        std::deque<Job>& queue = priority == Priority::High ? mQueue : mLowQueue;
+        queue.push_back(Job{ a, b, std::string(RecipeBook::GetName(a)), std::string(RecipeBook::GetName(b)) });
+    }
+    mWorkAvailable.notify_one();
+    return INVALID_ELEMENT;
+}
+
+bool CombinationResolver::Cancel(ElementId a, ElementId b)
+{
+    uint64_t key = MakePairKey(a, b);
+    auto it = mInFlight.find(key);
+    if (it == mInFlight.end() || it->second != Priority::Low)
+    {
+        return false;
+    }
+
+    bool removed;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        removed = TakeJob(mLowQueue, key, nullptr);
+    }
+    if (removed)
+    {
+        mInFlight.erase(it);
+    }
+    return removed;
+}
+
+bool CombinationResolver::TakeJob(std::deque<Job>& queue, uint64_t key, Job* outJob)
+{
+    for (auto it = queue.begin(); it != queue.end(); ++it)
+    {
+        if (MakePairKey(it->a, it->b) == key)
+        {
+            if (outJob)
+            {
+                *outJob = std::move(*it);
+            }
+            queue.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CombinationResolver::IsPending(ElementId a, ElementId b) const
+{
+    return mInFlight.count(MakePairKey(a, b)) != 0;
+}
+
+size_t CombinationResolver::GetPendingCount() const
+{
+    return mInFlight.size();
+}
+
+void CombinationResolver::Poll(std::vector<Completion>& outCompleted)
+{
+    outCompleted.clear();
+    if (mInFlight.empty())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mPollBuffer.swap(mFinished);
+    }
+
+    for (Finished& finished : mPollBuffer)
+    {
+        mInFlight.erase(MakePairKey(finished.a, finished.b));
+
+        ElementId result = INVALID_ELEMENT;
+        if (IsStorableName(finished.result))
+        {
+            result = RecipeBook::Intern(finished.result);
+            mRecipeBook.AddRecipe(finished.a, finished.b, result);
+
+            // Memoize so the pair never has to be generated again
+            if (mCacheFile)
+            {
+                mCacheFile << RecipeBook::GetName(finished.a) << " + " << RecipeBook::GetName(finished.b)
+                           << " = " << finished.result << '\n';
+                mCacheFile.flush();
+            }
+        }
+
+        outCompleted.push_back(Completion{ finished.a, finished.b, result });
+    }
+    mPollBuffer.clear();
+}
+
+void CombinationResolver::WaitForIdle()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mIdle.wait(lock, [this] { return mQueue.empty() && mLowQueue.empty() && mRunning == 0; });
+}
+
+void CombinationResolver::WorkerLoop()
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWorkAvailable.wait(lock, [this] { return mStopping || !mQueue.empty() || !mLowQueue.empty(); });
+            if (mStopping)
+            {
+                return;
+            }
+
+            // Speculative work only runs when nothing else is waiting
+            std::deque<Job>& queue = !mQueue.empty() ? mQueue : mLowQueue;
+            job = std::move(queue.front());
+            queue.pop_front();
+            mRunning++;
+        }
+
+        // The slow part runs without holding the lock
+        std::string result = mGenerator->Generate(job.first, job.second);
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mFinished.push_back(Finished{ job.a, job.b, std::move(result) });
+        mRunning--;
+        if (mRunning == 0 && mQueue.empty() && mLowQueue.empty())
+        {
+            mIdle.notify_all();
+        }
+    }
+}
@@ -0,0 +1,110 @@
+// ----------------------------------------------------------------
+// CombinationResolver: asynchronous generation of unknown recipes
+//
+// Pairs missing from the recipe book are handed to a worker pool that
+// calls the Generator. Requests for a pair already in flight are
+// coalesced. Low-priority (speculative) requests only run when no
+// regular request is waiting and can be cancelled until they start.
+// Poll() runs on the main thread, never blocks, and folds
+// finished results into the recipe book and the on-disk cache.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "Generator.hpp"
+#include "RecipeBook.hpp"
+
+class CombinationResolver
+{
+public:
+    enum class Priority
+    {
+        High,
+        Low
+    };
+
+    struct Completion
+    {
+        ElementId a;
+        ElementId b;
+        // INVALID_ELEMENT if the generator failed
+        ElementId result;
+    };
+
+    CombinationResolver(RecipeBook& recipeBook, std::unique_ptr<Generator> generator, size_t workerCount = 2);
+    ~CombinationResolver();
+
+    // Load previously generated recipes into the book and append new ones to the file
+    bool OpenCache(const std::string& path);
+
+    // Result if the recipe book already knows the pair; otherwise queues a
+    // generation (unless one is in flight) and returns INVALID_ELEMENT.
+    // A high-priority request promotes a queued low-priority one.
+    ElementId Resolve(ElementId a, ElementId b, Priority priority = Priority::High);
+    // Drop a low-priority request that hasn't started; false if it can't be cancelled
+    bool Cancel(ElementId a, ElementId b);
+    bool IsPending(ElementId a, ElementId b) const;
+    size_t GetPendingCount() const;
+
+    // Main thread, non-blocking: apply finished generations and report them
+    void Poll(std::vector<Completion>& outCompleted);
+    // Block until every queued and running generation has finished, so the
+    // next Poll reports them all (for sessions that must be reproducible)
+    void WaitForIdle();
+
+private:
+    struct Job
+    {
+        ElementId a;
+        ElementId b;
+        std::string first;
+        std::string second;
+    };
+
+    struct Finished
+    {
+        ElementId a;
+        ElementId b;
+        std::string result;
+    };
+
+    static uint64_t MakePairKey(ElementId a, ElementId b)
+    {
+        ElementId lo = a < b ? a : b;
+        ElementId hi = a < b ? b : a;
+        return (static_cast<uint64_t>(lo) << 32) | hi;
+    }
+
+    void WorkerLoop();
+    // Removes the job for key from queue (caller holds mMutex)
+    static bool TakeJob(std::deque<Job>& queue, uint64_t key, Job* outJob);
+
+    RecipeBook& mRecipeBook;
+    std::unique_ptr<Generator> mGenerator;
+    std::ofstream mCacheFile;
+
+    mutable std::mutex mMutex;
+    std::condition_variable mWorkAvailable;
+    std::condition_variable mIdle;
+    std::deque<Job> mQueue;
+    std::deque<Job> mLowQueue;
+    std::vector<Finished> mFinished;
+    // Jobs taken by workers and not finished yet
+    size_t mRunning;
+    // Pairs queued or being generated, with their priority (main thread only, no lock needed)
+    std::unordered_map<uint64_t, Priority> mInFlight;
+    bool mStopping;
+
+    std::vector<std::thread> mWorkers;
+    // Swapped with mFinished in Poll so the lock is held only briefly
+    std::vector<Finished> mPollBuffer;
+};
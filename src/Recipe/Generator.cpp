@@ -0,0 +1,234 @@
+// ----------------------------------------------------------------
+// Generator implementations
+// ----------------------------------------------------------------
+
+#include "Generator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cctype>
+#include <cerrno>
+#include <csignal>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+    uint64_t HashName(const std::string& name)
+    {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (unsigned char c : name)
+        {
+            hash ^= c;
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    // Close every descriptor above stderr in a freshly forked child, so the
+    // generator inherits none of the game's files, sockets or other
+    // workers' pipes. Only async-signal-safe calls are allowed here.
+    void CloseInheritedDescriptors()
+    {
+#ifdef SYS_close_range
+        if (syscall(SYS_close_range, 3u, ~0u, 0u) == 0)
+        {
+            return;
+        }
+#endif
+        long maxDescriptor = sysconf(_SC_OPEN_MAX);
+        for (long fd = 3; fd < maxDescriptor; fd++)
+        {
+            close(static_cast<int>(fd));
+        }
+    }
+}
+
+std::string HashGenerator::Generate(const std::string& first, const std::string& second)
+{
+    if (first.empty() || second.empty())
+    {
+        return std::string();
+    }
+
+    // Order-independent: combine the two name hashes symmetrically
+    uint64_t ha = HashName(first);
+    uint64_t hb = HashName(second);
+    uint64_t hash = (ha ^ hb) * 0x9e3779b97f4a7c15ULL + (ha + hb);
+
+    const std::string& head = (hash & 1) ? first : second;
+    const std::string& tail = (hash & 1) ? second : first;
+
+    // Take a hash-chosen prefix of one name and suffix of the other
+    size_t headLength = 1 + (hash >> 8) % head.size();
+    size_t tailLength = 1 + (hash >> 24) % tail.size();
+    std::string result = head.substr(0, headLength) + tail.substr(tail.size() - tailLength);
+
+    result[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(result[0])));
+    for (size_t i = 1; i < result.size(); i++)
+    {
+        if (result[i - 1] != ' ')
+        {
+            result[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(result[i])));
+        }
+    }
+    return result;
+}
+
+ProcessGenerator::ProcessGenerator(const std::string& command, int timeoutMs)
+    : mCommand(command)
+    , mTimeoutMs(timeoutMs)
+    , mAborting(false)
+{
+}
+
+void ProcessGenerator::Abort()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mAborting = true;
+    for (pid_t child : mChildren)
+    {
+        kill(-child, SIGKILL);
+    }
+}
+
+bool ProcessGenerator::ReadOutput(int fd, Clock::time_point deadline, std::string& output)
+{
+    char buffer[256];
+    while (true)
+    {
+        long remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+        if (remaining <= 0)
+        {
+            return false;
+        }
+
+        pollfd wait{ fd, POLLIN, 0 };
+        int ready = poll(&wait, 1, static_cast<int>(remaining));
+        if (ready < 0 && errno != EINTR)
+        {
+            return false;
+        }
+        if (ready <= 0)
+        {
+            continue;
+        }
+
+        ssize_t count = read(fd, buffer, sizeof(buffer));
+        if (count == 0)
+        {
+            return true;
+        }
+        if (count < 0)
+        {
+            if (errno == EINTR || errno == EAGAIN)
+            {
+                continue;
+            }
+            return false;
+        }
+        output.append(buffer, static_cast<size_t>(count));
+    }
+}
+
+bool ProcessGenerator::WaitForExit(pid_t pid, Clock::time_point deadline, int& outStatus)
+{
+    // Output is done, so the child is normally exiting already
+    while (true)
+    {
+        pid_t done = waitpid(pid, &outStatus, WNOHANG);
+        if (done == pid || (done < 0 && errno != EINTR))
+        {
+            return done == pid;
+        }
+        if (done == 0)
+        {
+            if (Clock::now() >= deadline)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+std::string ProcessGenerator::Generate(const std::string& first, const std::string& second)
+{
+    // Close-on-exec, so a child forked concurrently by another worker
+    // doesn't hold this pipe's write end open
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) != 0)
+    {
+        return std::string();
+    }
+
+    // Arguments are passed directly to exec, never through a shell
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        close(fds[0]);
+        close(fds[1]);
+        return std::string();
+    }
+    if (pid == 0)
+    {
+        // Own process group, so a kill also takes down anything the
+        // command started that could hold the pipe open
+        setpgid(0, 0);
+        // dup2 clears close-on-exec on the copy
+        dup2(fds[1], STDOUT_FILENO);
+        CloseInheritedDescriptors();
+        execlp(mCommand.c_str(), mCommand.c_str(), first.c_str(), second.c_str(), static_cast<char*>(nullptr));
+        _exit(127);
+    }
+
+    close(fds[1]);
+    // Also set here, so the group exists before either side runs on
+    setpgid(pid, pid);
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mChildren.push_back(pid);
+        if (mAborting)
+        {
+            kill(-pid, SIGKILL);
+        }
+    }
+
+    const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(mTimeoutMs);
+    std::string output;
+    int status = 0;
+    bool finished = ReadOutput(fds[0], deadline, output) && WaitForExit(pid, deadline, status);
+    close(fds[0]);
+
+    // Unregistered before reaping, so Abort never signals a reused pid
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mChildren.erase(std::find(mChildren.begin(), mChildren.end(), pid));
+    }
+    if (!finished)
+    {
+        // Too slow: kill it and reap it here
+        kill(-pid, SIGKILL);
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+        {
+        }
+        return std::string();
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+        return std::string();
+    }
+
+    size_t newline = output.find_first_of("\r\n");
+    if (newline != std::string::npos)
+    {
+        output.resize(newline);
+    }
+    return output;
+}
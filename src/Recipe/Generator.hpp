@@ -0,0 +1,66 @@
+// ----------------------------------------------------------------
+// Generators invent results for element pairs no recipe covers.
+// Generate() runs on resolver worker threads and may be slow, so
+// implementations must be thread-safe.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+class Generator
+{
+public:
+    virtual ~Generator() {}
+
+    // Name of the element produced by combining first and second,
+    // or an empty string if generation failed
+    virtual std::string Generate(const std::string& first, const std::string& second) = 0;
+    // Make running and later Generate calls fail promptly (called from
+    // another thread when shutting down)
+    virtual void Abort() {}
+};
+
+// Deterministic local generator: splices the two names together based
+// on a hash of the (unordered) pair. Needs no service and always
+// produces the same answer for the same pair.
+class HashGenerator : public Generator
+{
+public:
+    std::string Generate(const std::string& first, const std::string& second) override;
+};
+
+// Runs an external command as "<command> <first> <second>" and uses the
+// first line it prints. Lets a local stub process stand in for the
+// generator service. A command that hasn't finished within the timeout
+// is killed and counts as a failure.
+class ProcessGenerator : public Generator
+{
+public:
+    explicit ProcessGenerator(const std::string& command, int timeoutMs = DEFAULT_TIMEOUT_MS);
+
+    std::string Generate(const std::string& first, const std::string& second) override;
+    // Kills the running commands
+    void Abort() override;
+
+    static const int DEFAULT_TIMEOUT_MS = 10000;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Read the child's output until it closes stdout; false at the deadline
+    static bool ReadOutput(int fd, Clock::time_point deadline, std::string& output);
+    // Reap the child; false if it is still running at the deadline
+    static bool WaitForExit(pid_t pid, Clock::time_point deadline, int& outStatus);
+
+    std::string mCommand;
+    int mTimeoutMs;
+
+    // Children still running, so Abort can kill them
+    std::mutex mMutex;
+    std::vector<pid_t> mChildren;
+    bool mAborting;
+};
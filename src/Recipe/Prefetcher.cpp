@@ -0,0 +1,112 @@
+// ----------------------------------------------------------------
+// Prefetcher implementation
+// ----------------------------------------------------------------
+
+#include "Prefetcher.hpp"
+#include "../Actor/TextActor.hpp"
+#include "../Game/Game.hpp"
+#include <algorithm>
+
+Prefetcher::Prefetcher(Game* game, CombinationResolver* resolver, size_t neighborCount)
+    : mGame(game)
+    , mResolver(resolver)
+    , mNeighborCount(neighborCount)
+    , mLastQueryPosition(Vector2::Zero)
+    , mHasQueried(false)
+    , mStats{ 0, 0, 0, 0, 0 }
+{
+}
+
+void Prefetcher::OnDrag(TextActor* dragged)
+{
+    Vector2 center = dragged->GetBounds().GetCenter();
+    if (mHasQueried && (center - mLastQueryPosition).LengthSq() < REQUERY_DISTANCE * REQUERY_DISTANCE)
+    {
+        return;
+    }
+    mHasQueried = true;
+    mLastQueryPosition = center;
+
+    // One extra result, since the dragged tile itself is the nearest
+    mGame->GetSpatialGrid()->QueryNearest(center, mNeighborCount + 1, mNeighbors);
+
+    mNextCandidates.clear();
+    ElementId draggedId = dragged->GetName();
+    for (Actor* actor : mNeighbors)
+    {
+        TextActor* neighbor = dynamic_cast<TextActor*>(actor);
+        if (!neighbor || neighbor == dragged || neighbor->IsPending() ||
+            neighbor->GetState() != ActorState::Active)
+        {
+            continue;
+        }
+
+        // Pairs with a recipe don't need generating
+        ElementId neighborId = neighbor->GetName();
+        if (mGame->CombineElements(draggedId, neighborId) != INVALID_ELEMENT)
+        {
+            continue;
+        }
+
+        mNextCandidates.push_back(Candidate{ draggedId, neighborId, MakePairKey(draggedId, neighborId) });
+    }
+
+    // Cancel candidates that are no longer near
+    for (const Candidate& candidate : mCandidates)
+    {
+        bool stillNear = std::any_of(mNextCandidates.begin(), mNextCandidates.end(),
+            [&candidate](const Candidate& next) { return next.key == candidate.key; });
+        if (!stillNear && mResolver->Cancel(candidate.a, candidate.b))
+        {
+            mPrefetched.erase(candidate.key);
+            mStats.cancelled++;
+        }
+    }
+
+    // Queue the new ones behind any real request
+    for (const Candidate& candidate : mNextCandidates)
+    {
+        if (mPrefetched.insert(candidate.key).second)
+        {
+            mResolver->Resolve(candidate.a, candidate.b, CombinationResolver::Priority::Low);
+            mStats.requested++;
+        }
+    }
+
+    mCandidates.swap(mNextCandidates);
+}
+
+void Prefetcher::OnDrop(ElementId a, ElementId b, bool knownResult)
+{
+    uint64_t key = MakePairKey(a, b);
+    bool prefetched = mPrefetched.erase(key) != 0;
+    if (prefetched && knownResult)
+    {
+        mStats.hits++;
+    }
+    else if (prefetched && mResolver->IsPending(a, b))
+    {
+        mStats.inFlightHits++;
+    }
+    else if (!knownResult)
+    {
+        mStats.misses++;
+    }
+    // Not prefetched but known: a shipped recipe, not counted
+}
+
+void Prefetcher::OnDragEnd()
+{
+    for (const Candidate& candidate : mCandidates)
+    {
+        if (mResolver->Cancel(candidate.a, candidate.b))
+        {
+            mStats.cancelled++;
+        }
+    }
+    mCandidates.clear();
+    // The drop (if any) has been classified; prefetches that already ran
+    // or are running finish on their own and belong to no later drop
+    mPrefetched.clear();
+    mHasQueried = false;
+}
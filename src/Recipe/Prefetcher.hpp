@@ -0,0 +1,85 @@
+// ----------------------------------------------------------------
+// Prefetcher: speculatively resolves combinations while a tile is
+// being dragged, so the result is usually ready when it is dropped
+//
+// Each drag frame the k tiles nearest to the dragged one are the
+// likely drop targets. Their unknown pairs are queued at low priority
+// on the CombinationResolver and cancelled again when they stop being
+// candidates or the drag ends.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+#include "../Math.h"
+#include "CombinationResolver.hpp"
+
+class Prefetcher
+{
+public:
+    struct Stats
+    {
+        // Speculative generations queued / cancelled before they ran
+        size_t requested;
+        size_t cancelled;
+        // Drops that needed a generated result, split by how prefetch did
+        size_t hits;          // result was already in the recipe book
+        size_t inFlightHits;  // generation had already started
+        size_t misses;        // pair was never prefetched
+
+        float GetHitRate() const
+        {
+            size_t drops = hits + inFlightHits + misses;
+            return drops > 0 ? static_cast<float>(hits) / static_cast<float>(drops) : 0.0f;
+        }
+    };
+
+    Prefetcher(class Game* game, CombinationResolver* resolver, size_t neighborCount = 4);
+
+    // Called every frame while dragged is following the mouse
+    void OnDrag(class TextActor* dragged);
+    // Classify a drop of (a, b) before it is resolved; knownResult tells
+    // whether a recipe for the pair was already available
+    void OnDrop(ElementId a, ElementId b, bool knownResult);
+    // Cancel speculative work that didn't turn into a drop (call after OnDrop)
+    void OnDragEnd();
+
+    const Stats& GetStats() const { return mStats; }
+
+private:
+    struct Candidate
+    {
+        ElementId a;
+        ElementId b;
+        uint64_t key;
+    };
+
+    static uint64_t MakePairKey(ElementId a, ElementId b)
+    {
+        ElementId lo = a < b ? a : b;
+        ElementId hi = a < b ? b : a;
+        return (static_cast<uint64_t>(lo) << 32) | hi;
+    }
+
+    // Only re-query neighbors after the dragged tile moved this far (world units)
+    static constexpr float REQUERY_DISTANCE = 8.0f;
+
+    class Game* mGame;
+    CombinationResolver* mResolver;
+    size_t mNeighborCount;
+
+    // Prefetches issued for the current drag
+    std::vector<Candidate> mCandidates;
+    std::vector<Candidate> mNextCandidates;
+    std::vector<class Actor*> mNeighbors;
+    // Pairs prefetched during the current drag (for hit classification;
+    // cleared when it ends, so it never outgrows one drag)
+    std::unordered_set<uint64_t> mPrefetched;
+
+    Vector2 mLastQueryPosition;
+    bool mHasQueried;
+
+    Stats mStats;
+};
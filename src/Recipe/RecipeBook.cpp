@@ -0,0 +1,190 @@
+// ----------------------------------------------------------------
+// RecipeBook implementation
+// ----------------------------------------------------------------
+
+#include "RecipeBook.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace
+{
+    std::string_view Trim(std::string_view text)
+    {
+        size_t begin = text.find_first_not_of(" \t\r");
+        if (begin == std::string_view::npos)
+        {
+            return std::string_view();
+        }
+        size_t end = text.find_last_not_of(" \t\r");
+        return text.substr(begin, end - begin + 1);
+    }
+}
+
+RecipeBook::RecipeBook()
+    : mMask(0)
+    , mRecipeCount(0)
+{
+    Rehash(64);
+}
+
+void RecipeBook::AddRecipe(ElementId a, ElementId b, ElementId result)
+{
+    if ((mRecipeCount + 1) * MAX_LOAD_DEN > mSlots.size() * MAX_LOAD_NUM)
+    {
+        Rehash(mSlots.size() * 2);
+    }
+    InsertKey(MakePairKey(a, b), result);
+}
+
+ElementId RecipeBook::Combine(ElementId a, ElementId b) const
+{
+    uint64_t key = MakePairKey(a, b);
+    size_t index = HashKey(key) & mMask;
+    while (true)
+    {
+        const Slot& slot = mSlots[index];
+        if (slot.key == key)
+        {
+            return slot.result;
+        }
+        if (slot.key == EMPTY_KEY)
+        {
+            return INVALID_ELEMENT;
+        }
+        index = (index + 1) & mMask;
+    }
+}
+
+bool RecipeBook::LoadFromFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        std::cout << "ERROR::RECIPES: Could not open " << path << std::endl;
+        return false;
+    }
+
+    // Read the whole file at once and parse it in place
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    Reserve(mRecipeCount + static_cast<size_t>(std::count(contents.begin(), contents.end(), '\n')) + 1);
+
+    std::string_view text(contents);
+    size_t lineNumber = 0;
+    size_t skipped = 0;
+    while (!text.empty())
+    {
+        size_t newline = text.find('\n');
+        std::string_view line = text.substr(0, newline);
+        text = newline == std::string_view::npos ? std::string_view() : text.substr(newline + 1);
+        lineNumber++;
+
+        size_t comment = line.find('#');
+        if (comment != std::string_view::npos)
+        {
+            line = line.substr(0, comment);
+        }
+        line = Trim(line);
+        if (line.empty())
+        {
+            continue;
+        }
+
+        size_t plus = line.find('+');
+        size_t equals = line.find('=', plus == std::string_view::npos ? 0 : plus);
+        if (plus == std::string_view::npos || equals == std::string_view::npos)
+        {
+            skipped++;
+            continue;
+        }
+
+        std::string_view first = Trim(line.substr(0, plus));
+        std::string_view second = Trim(line.substr(plus + 1, equals - plus - 1));
+        std::string_view result = Trim(line.substr(equals + 1));
+        if (first.empty() || second.empty() || result.empty())
+        {
+            skipped++;
+            continue;
+        }
+
+        AddRecipe(Intern(first), Intern(second), Intern(result));
+    }
+
+    if (skipped > 0)
+    {
+        std::cout << "WARNING::RECIPES: Skipped " << skipped << " malformed lines in " << path << std::endl;
+    }
+    return true;
+}
+
+void RecipeBook::Reserve(size_t recipeCount)
+{
+    size_t needed = mSlots.size();
+    while (recipeCount * MAX_LOAD_DEN > needed * MAX_LOAD_NUM)
+    {
+        needed *= 2;
+    }
+    if (needed != mSlots.size())
+    {
+        Rehash(needed);
+    }
+}
+
+RecipeBook::Stats RecipeBook::GetStats() const
+{
+    Stats stats;
+    stats.recipeCount = mRecipeCount;
+    stats.capacity = mSlots.size();
+    stats.loadFactor = static_cast<float>(mRecipeCount) / static_cast<float>(mSlots.size());
+    stats.maxProbeLength = 0;
+
+    size_t totalProbes = 0;
+    for (size_t i = 0; i < mSlots.size(); i++)
+    {
+        if (mSlots[i].key == EMPTY_KEY)
+        {
+            continue;
+        }
+        size_t home = HashKey(mSlots[i].key) & mMask;
+        size_t probes = ((i - home) & mMask) + 1;
+        totalProbes += probes;
+        stats.maxProbeLength = std::max(stats.maxProbeLength, probes);
+    }
+    stats.averageProbeLength = mRecipeCount > 0
+        ? static_cast<float>(totalProbes) / static_cast<float>(mRecipeCount)
+        : 0.0f;
+    return stats;
+}
+
+void RecipeBook::Rehash(size_t newCapacity)
+{
+    std::vector<Slot> oldSlots(newCapacity, Slot{ EMPTY_KEY, INVALID_ELEMENT });
+    oldSlots.swap(mSlots);
+    mMask = newCapacity - 1;
+    mRecipeCount = 0;
+
+    for (const Slot& slot : oldSlots)
+    {
+        if (slot.key != EMPTY_KEY)
+        {
+            InsertKey(slot.key, slot.result);
+        }
+    }
+}
+
+void RecipeBook::InsertKey(uint64_t key, ElementId result)
+{
+    // Linear probing; an existing pair is overwritten
+    size_t index = HashKey(key) & mMask;
+    while (mSlots[index].key != EMPTY_KEY && mSlots[index].key != key)
+    {
+        index = (index + 1) & mMask;
+    }
+    if (mSlots[index].key == EMPTY_KEY)
+    {
+        mRecipeCount++;
+    }
+    mSlots[index].key = key;
+    mSlots[index].result = result;
+}
@@ -0,0 +1,103 @@
+// ----------------------------------------------------------------
+// RecipeBook: O(1) element combination lookup
+// Elements are identified by their interned name ID (see StringTable);
+// recipes live in an open-addressing table keyed by the unordered pair
+// of IDs
+// ----------------------------------------------------------------
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../Core/StringTable/StringTable.hpp"
+
+using ElementId = NameId;
+constexpr ElementId INVALID_ELEMENT = INVALID_NAME;
+
+class RecipeBook
+{
+public:
+    struct Stats
+    {
+        size_t recipeCount;
+        size_t capacity;
+        float loadFactor;
+        // Average and worst number of slots inspected by a successful lookup
+        float averageProbeLength;
+        size_t maxProbeLength;
+    };
+
+    RecipeBook();
+
+    // Element names <-> IDs (shared with every other interned string)
+    static ElementId Intern(std::string_view name) { return StringTable::Get().Intern(name); }
+    static ElementId FindElement(std::string_view name) { return StringTable::Get().Find(name); }
+    static std::string_view GetName(ElementId id) { return StringTable::Get().GetString(id); }
+
+    // Register "a + b = result" (order of a and b does not matter)
+    void AddRecipe(ElementId a, ElementId b, ElementId result);
+    // Result of combining a and b, or INVALID_ELEMENT if unknown
+    ElementId Combine(ElementId a, ElementId b) const;
+
+    // Bulk load "A + B = C" lines ('#' starts a comment)
+    bool LoadFromFile(const std::string& path);
+
+    // Make room for recipeCount recipes without rehashing
+    void Reserve(size_t recipeCount);
+    size_t GetRecipeCount() const { return mRecipeCount; }
+    Stats GetStats() const;
+
+    // Calls func(a, b, result) for every recipe, with a <= b
+    template <typename Func>
+    void ForEachRecipe(Func&& func) const
+    {
+        for (const Slot& slot : mSlots)
+        {
+            if (slot.key != EMPTY_KEY)
+            {
+                func(static_cast<ElementId>(slot.key >> 32),
+                     static_cast<ElementId>(slot.key & 0xffffffffu), slot.result);
+            }
+        }
+    }
+
+private:
+    struct Slot
+    {
+        uint64_t key;
+        ElementId result;
+    };
+
+    // Both halves set to INVALID_ELEMENT, which is never a valid pair
+    static constexpr uint64_t EMPTY_KEY = 0xffffffffffffffffULL;
+    // Grow once the table is more than 70% full
+    static constexpr size_t MAX_LOAD_NUM = 7;
+    static constexpr size_t MAX_LOAD_DEN = 10;
+
+    static uint64_t MakePairKey(ElementId a, ElementId b)
+    {
+        ElementId lo = a < b ? a : b;
+        ElementId hi = a < b ? b : a;
+        return (static_cast<uint64_t>(lo) << 32) | hi;
+    }
+
+    static uint64_t HashKey(uint64_t key)
+    {
+        // splitmix64 finalizer: spreads both IDs over all bits
+        key ^= key >> 30;
+        key *= 0xbf58476d1ce4e5b9ULL;
+        key ^= key >> 27;
+        key *= 0x94d049bb133111ebULL;
+        key ^= key >> 31;
+        return key;
+    }
+
+    void Rehash(size_t newCapacity);
+    void InsertKey(uint64_t key, ElementId result);
+
+    std::vector<Slot> mSlots;
+    size_t mMask;
+    size_t mRecipeCount;
+};
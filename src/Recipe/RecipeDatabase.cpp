@@ -0,0 +1,353 @@
+// ----------------------------------------------------------------
+// RecipeDatabase implementation
+// ----------------------------------------------------------------
+
+#include "RecipeDatabase.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    uint64_t AlignUp(uint64_t value)
+    {
+        return (value + 7) & ~static_cast<uint64_t>(7);
+    }
+
+    uint64_t Fnv1a(const uint8_t* data, size_t size)
+    {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= data[i];
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    bool RecipeLess(const RecipeDatabase::Recipe& left, const RecipeDatabase::Recipe& right)
+    {
+        return left.a != right.a ? left.a < right.a : left.b < right.b;
+    }
+
+    // count elements of type T at offset lie inside size bytes and are
+    // aligned for T (written so no sum can overflow)
+    template <typename T>
+    bool SectionFits(uint64_t offset, uint64_t count, uint64_t size)
+    {
+        return offset <= size && offset % alignof(T) == 0 && count <= (size - offset) / sizeof(T);
+    }
+}
+
+RecipeDatabase::RecipeDatabase()
+    : mData(nullptr)
+    , mSize(0)
+    , mHeader(nullptr)
+    , mNameOffsets(nullptr)
+    , mNameIndex(nullptr)
+    , mRecipes(nullptr)
+    , mStringPool(nullptr)
+{
+}
+
+RecipeDatabase::~RecipeDatabase()
+{
+    Close();
+}
+
+bool RecipeDatabase::Open(const std::string& path)
+{
+    Close();
+
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header))
+    {
+        close(fd);
+        std::cout << "ERROR::RECIPEDB: " << path << " is too small" << std::endl;
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        std::cout << "ERROR::RECIPEDB: Could not map " << path << std::endl;
+        return false;
+    }
+    // Lookups are binary searches: don't let the kernel read ahead
+    madvise(data, size, MADV_RANDOM);
+
+    mData = static_cast<const uint8_t*>(data);
+    mSize = size;
+
+    // Only the header is checked here; lookups bounds-check what they read
+    // and Validate() does the full pass
+    const Header* header = reinterpret_cast<const Header*>(mData);
+    uint64_t elements = header->elementCount;
+    bool valid = header->magic == MAGIC && header->version == VERSION &&
+                 header->fileSize == size &&
+                 SectionFits<uint32_t>(header->nameOffsetsOffset, elements + 1, size) &&
+                 SectionFits<uint32_t>(header->nameIndexOffset, elements, size) &&
+                 SectionFits<Recipe>(header->recipesOffset, header->recipeCount, size) &&
+                 SectionFits<char>(header->stringPoolOffset, header->stringPoolSize, size);
+    if (!valid)
+    {
+        std::cout << "ERROR::RECIPEDB: " << path << " has an invalid header" << std::endl;
+        Close();
+        return false;
+    }
+
+    mHeader = header;
+    mNameOffsets = reinterpret_cast<const uint32_t*>(mData + header->nameOffsetsOffset);
+    mNameIndex = reinterpret_cast<const uint32_t*>(mData + header->nameIndexOffset);
+    mRecipes = reinterpret_cast<const Recipe*>(mData + header->recipesOffset);
+    mStringPool = reinterpret_cast<const char*>(mData + header->stringPoolOffset);
+    return true;
+}
+
+void RecipeDatabase::Close()
+{
+    if (mData)
+    {
+        munmap(const_cast<uint8_t*>(mData), mSize);
+    }
+    mData = nullptr;
+    mSize = 0;
+    mHeader = nullptr;
+    mNameOffsets = nullptr;
+    mNameIndex = nullptr;
+    mRecipes = nullptr;
+    mStringPool = nullptr;
+}
+
+bool RecipeDatabase::Validate(std::string& error) const
+{
+    if (!IsOpen())
+    {
+        error = "database is not open";
+        return false;
+    }
+
+    if (Fnv1a(mData + sizeof(Header), mSize - sizeof(Header)) != mHeader->checksum)
+    {
+        error = "checksum mismatch";
+        return false;
+    }
+
+    uint32_t elements = mHeader->elementCount;
+    if (mNameOffsets[elements] != mHeader->stringPoolSize)
+    {
+        error = "string pool size does not match the offsets index";
+        return false;
+    }
+    for (uint32_t i = 0; i < elements; i++)
+    {
+        uint32_t begin = mNameOffsets[i];
+        uint32_t end = mNameOffsets[i + 1];
+        if (begin >= end || end > mHeader->stringPoolSize || mStringPool[end - 1] != '\0')
+        {
+            error = "bad name offsets for element " + std::to_string(i);
+            return false;
+        }
+    }
+
+    std::vector<bool> seen(elements, false);
+    for (uint32_t i = 0; i < elements; i++)
+    {
+        uint32_t id = mNameIndex[i];
+        if (id >= elements || seen[id])
+        {
+            error = "name index is not a permutation of the element IDs";
+            return false;
+        }
+        seen[id] = true;
+        if (i > 0 && !(GetName(mNameIndex[i - 1]) < GetName(id)))
+        {
+            error = "name index is not strictly sorted at " + std::to_string(i);
+            return false;
+        }
+    }
+
+    for (uint32_t i = 0; i < mHeader->recipeCount; i++)
+    {
+        const Recipe& recipe = mRecipes[i];
+        if (recipe.a > recipe.b || recipe.b >= elements || recipe.result >= elements)
+        {
+            error = "recipe " + std::to_string(i) + " references invalid elements";
+            return false;
+        }
+        if (i > 0 && !RecipeLess(mRecipes[i - 1], recipe))
+        {
+            error = "recipes are not strictly sorted at " + std::to_string(i);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+ElementId RecipeDatabase::FindElement(std::string_view name) const
+{
+    if (!IsOpen())
+    {
+        return INVALID_ELEMENT;
+    }
+
+    const uint32_t* begin = mNameIndex;
+    const uint32_t* end = mNameIndex + mHeader->elementCount;
+    const uint32_t* it = std::lower_bound(begin, end, name,
+        [this](uint32_t id, std::string_view value) { return GetName(id) < value; });
+    if (it != end && *it < mHeader->elementCount && GetName(*it) == name)
+    {
+        return *it;
+    }
+    return INVALID_ELEMENT;
+}
+
+std::string_view RecipeDatabase::GetName(ElementId id) const
+{
+    if (!IsOpen() || id >= mHeader->elementCount)
+    {
+        return std::string_view();
+    }
+
+    // Offsets include the terminating NUL; a corrupt file reads as no name
+    uint32_t begin = mNameOffsets[id];
+    uint32_t end = mNameOffsets[id + 1];
+    if (begin >= end || end > mHeader->stringPoolSize)
+    {
+        return std::string_view();
+    }
+    return std::string_view(mStringPool + begin, end - begin - 1);
+}
+
+ElementId RecipeDatabase::Combine(ElementId a, ElementId b) const
+{
+    if (!IsOpen())
+    {
+        return INVALID_ELEMENT;
+    }
+
+    Recipe key{ std::min(a, b), std::max(a, b), 0 };
+    const Recipe* begin = mRecipes;
+    const Recipe* end = mRecipes + mHeader->recipeCount;
+    const Recipe* it = std::lower_bound(begin, end, key, RecipeLess);
+    if (it != end && it->a == key.a && it->b == key.b && it->result < mHeader->elementCount)
+    {
+        return it->result;
+    }
+    return INVALID_ELEMENT;
+}
+
+bool RecipeDatabase::Write(const RecipeBook& book, const std::string& path)
+{
+    // Interned IDs are global and sparse: give the elements used by the
+    // recipes dense database IDs
+    std::vector<ElementId> elementNames;
+    book.ForEachRecipe([&elementNames](ElementId a, ElementId b, ElementId result) {
+        elementNames.push_back(a);
+        elementNames.push_back(b);
+        elementNames.push_back(result);
+    });
+    std::sort(elementNames.begin(), elementNames.end());
+    elementNames.erase(std::unique(elementNames.begin(), elementNames.end()), elementNames.end());
+    uint32_t elements = static_cast<uint32_t>(elementNames.size());
+
+    auto toDatabaseId = [&elementNames](ElementId name) {
+        return static_cast<ElementId>(
+            std::lower_bound(elementNames.begin(), elementNames.end(), name) - elementNames.begin());
+    };
+
+    // String pool and offsets, in database ID order
+    std::vector<uint32_t> nameOffsets;
+    nameOffsets.reserve(elements + 1);
+    std::string pool;
+    for (ElementId name : elementNames)
+    {
+        nameOffsets.push_back(static_cast<uint32_t>(pool.size()));
+        pool += RecipeBook::GetName(name);
+        pool += '\0';
+    }
+    nameOffsets.push_back(static_cast<uint32_t>(pool.size()));
+
+    std::vector<uint32_t> nameIndex(elements);
+    for (uint32_t id = 0; id < elements; id++)
+    {
+        nameIndex[id] = id;
+    }
+    std::sort(nameIndex.begin(), nameIndex.end(), [&elementNames](uint32_t left, uint32_t right) {
+        return RecipeBook::GetName(elementNames[left]) < RecipeBook::GetName(elementNames[right]);
+    });
+
+    std::vector<Recipe> recipes;
+    recipes.reserve(book.GetRecipeCount());
+    book.ForEachRecipe([&recipes, &toDatabaseId](ElementId a, ElementId b, ElementId result) {
+        ElementId first = toDatabaseId(a);
+        ElementId second = toDatabaseId(b);
+        recipes.push_back(Recipe{ std::min(first, second), std::max(first, second), toDatabaseId(result) });
+    });
+    std::sort(recipes.begin(), recipes.end(), RecipeLess);
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.elementCount = elements;
+    header.recipeCount = static_cast<uint32_t>(recipes.size());
+    header.nameOffsetsOffset = AlignUp(sizeof(Header));
+    header.nameIndexOffset = AlignUp(header.nameOffsetsOffset + nameOffsets.size() * sizeof(uint32_t));
+    header.recipesOffset = AlignUp(header.nameIndexOffset + nameIndex.size() * sizeof(uint32_t));
+    header.stringPoolOffset = AlignUp(header.recipesOffset + recipes.size() * sizeof(Recipe));
+    header.stringPoolSize = pool.size();
+    header.fileSize = header.stringPoolOffset + pool.size();
+
+    // An empty book has empty sections, whose data() may be null
+    std::vector<uint8_t> bytes(header.fileSize, 0);
+    std::memcpy(bytes.data() + header.nameOffsetsOffset, nameOffsets.data(), nameOffsets.size() * sizeof(uint32_t));
+    if (!nameIndex.empty())
+    {
+        std::memcpy(bytes.data() + header.nameIndexOffset, nameIndex.data(), nameIndex.size() * sizeof(uint32_t));
+    }
+    if (!recipes.empty())
+    {
+        std::memcpy(bytes.data() + header.recipesOffset, recipes.data(), recipes.size() * sizeof(Recipe));
+    }
+    if (!pool.empty())
+    {
+        std::memcpy(bytes.data() + header.stringPoolOffset, pool.data(), pool.size());
+    }
+    header.checksum = Fnv1a(bytes.data() + sizeof(Header), bytes.size() - sizeof(Header));
+    std::memcpy(bytes.data(), &header, sizeof(Header));
+
+    // Write next to the target and rename, so readers never map a partial file
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size()))
+        {
+            std::cout << "ERROR::RECIPEDB: Could not write " << tempPath << std::endl;
+            return false;
+        }
+    }
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+        std::cout << "ERROR::RECIPEDB: Could not rename " << tempPath << " to " << path << std::endl;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
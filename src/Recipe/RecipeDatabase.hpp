@@ -0,0 +1,96 @@
+// ----------------------------------------------------------------
+// RecipeDatabase: read-only, memory-mapped binary recipe corpus
+//
+// File layout (little-endian, every section 8-byte aligned):
+//   Header
+//   uint32_t nameOffsets[elementCount + 1]  start of each name in the pool
+//   uint32_t nameIndex[elementCount]        element IDs sorted by name
+//   Recipe   recipes[recipeCount]           sorted by (a, b), a <= b
+//   char     stringPool[stringPoolSize]     NUL-terminated names
+//
+// The file is used in place: opening it only maps it and checks the
+// header, lookups binary-search the mapped arrays, and names are
+// returned as views into the mapped string pool. Processes opening the
+// same file share its pages through the page cache.
+//
+// Lookups bounds-check every ID and offset they read, so a corrupt file
+// yields wrong or missing answers rather than stray reads; Validate()
+// is the full structural check, left to the tool since it touches every
+// page.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include "RecipeBook.hpp"
+
+class RecipeDatabase
+{
+public:
+    static constexpr uint32_t MAGIC = 0x42445052; // "RPDB"
+    static constexpr uint32_t VERSION = 1;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t elementCount;
+        uint32_t recipeCount;
+        uint64_t nameOffsetsOffset;
+        uint64_t nameIndexOffset;
+        uint64_t recipesOffset;
+        uint64_t stringPoolOffset;
+        uint64_t stringPoolSize;
+        uint64_t fileSize;
+        // FNV-1a over everything after the header
+        uint64_t checksum;
+    };
+
+    struct Recipe
+    {
+        ElementId a;
+        ElementId b;
+        ElementId result;
+    };
+
+    RecipeDatabase();
+    ~RecipeDatabase();
+    RecipeDatabase(const RecipeDatabase&) = delete;
+    RecipeDatabase& operator=(const RecipeDatabase&) = delete;
+
+    // Map a database file read-only; returns false if it is missing or malformed
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return mData != nullptr; }
+
+    // Full structural check of the mapped file (touches every page)
+    bool Validate(std::string& error) const;
+
+    uint32_t GetElementCount() const { return mHeader ? mHeader->elementCount : 0; }
+    uint32_t GetRecipeCount() const { return mHeader ? mHeader->recipeCount : 0; }
+
+    // Element ID for a name, or INVALID_ELEMENT (O(log n) over the name index).
+    // These IDs are local to the file, not interned name IDs.
+    ElementId FindElement(std::string_view name) const;
+    // View into the mapped string pool; valid while the database is open.
+    // Empty for an unknown ID or a corrupt entry.
+    std::string_view GetName(ElementId id) const;
+    // Result of combining a and b, or INVALID_ELEMENT (O(log n) over the recipes;
+    // a result outside the element range counts as no recipe)
+    ElementId Combine(ElementId a, ElementId b) const;
+
+    // Serialize a recipe book into the binary format (written atomically)
+    static bool Write(const RecipeBook& book, const std::string& path);
+
+private:
+    const uint8_t* mData;
+    size_t mSize;
+
+    const Header* mHeader;
+    const uint32_t* mNameOffsets;
+    const uint32_t* mNameIndex;
+    const Recipe* mRecipes;
+    const char* mStringPool;
+};
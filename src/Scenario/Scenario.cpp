@@ -0,0 +1,252 @@
+// ----------------------------------------------------------------
+// Scenario implementation
+// ----------------------------------------------------------------
+
+#include "Scenario.hpp"
+#include "../Actor/TextActor.hpp"
+#include "../Component/MotionComponent/MotionComponent.hpp"
+#include "../Game/Game.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+
+Scenario::Scenario(Game* game, uint32_t seed)
+    : mGame(game)
+    , mRandom(seed)
+    , mNextCommand(0)
+    , mArena(Vector2(-2000.0f, -2000.0f), Vector2(2000.0f, 2000.0f))
+    , mMaxSpeed(0.0f)
+{
+}
+
+bool Scenario::LoadScript(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        std::cout << "ERROR::SCENARIO: Could not open " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos)
+        {
+            line.resize(comment);
+        }
+
+        std::istringstream stream(line);
+        Command command{ 0, CommandType::End, 0.0, 0.0 };
+        std::string name;
+        if (!(stream >> command.frame >> name))
+        {
+            continue;
+        }
+
+        bool valid = true;
+        if (name == "arena")
+        {
+            command.type = CommandType::Arena;
+            valid = static_cast<bool>(stream >> command.first >> command.second);
+        }
+        else if (name == "motion")
+        {
+            command.type = CommandType::Motion;
+            valid = static_cast<bool>(stream >> command.first);
+        }
+        else if (name == "spawn")
+        {
+            command.type = CommandType::Spawn;
+            valid = static_cast<bool>(stream >> command.first);
+            if (!(stream >> command.second))
+            {
+                command.second = std::max(1.0, command.first / 4.0);
+            }
+        }
+        else if (name == "merge")
+        {
+            command.type = CommandType::Merge;
+            valid = static_cast<bool>(stream >> command.first);
+        }
+        else if (name == "delete")
+        {
+            command.type = CommandType::Delete;
+            valid = static_cast<bool>(stream >> command.first);
+        }
+        else if (name != "end")
+        {
+            valid = false;
+        }
+
+        if (!valid)
+        {
+            std::cout << "ERROR::SCENARIO: " << path << ":" << lineNumber << ": invalid command" << std::endl;
+            return false;
+        }
+        mCommands.push_back(command);
+    }
+
+    std::stable_sort(mCommands.begin(), mCommands.end(),
+        [](const Command& a, const Command& b) { return a.frame < b.frame; });
+    mNextCommand = 0;
+    return true;
+}
+
+bool Scenario::OpenMetrics(const std::string& path)
+{
+    mMetrics.open(path, std::ios::trunc);
+    if (!mMetrics)
+    {
+        std::cout << "ERROR::SCENARIO: Could not create " << path << std::endl;
+        return false;
+    }
+    mMetrics << "frame,actors,awake,update_ms,draw_ms,rss_kib\n";
+    return true;
+}
+
+void Scenario::Update(uint32_t frame)
+{
+    while (mNextCommand < mCommands.size() && mCommands[mNextCommand].frame <= frame)
+    {
+        const Command& command = mCommands[mNextCommand++];
+        switch (command.type)
+        {
+            case CommandType::Arena:
+            {
+                Vector2 half(static_cast<float>(command.first) * 0.5f, static_cast<float>(command.second) * 0.5f);
+                mArena = Rect(Vector2::Zero - half, half);
+                break;
+            }
+            case CommandType::Motion:
+                mMaxSpeed = static_cast<float>(command.first);
+                break;
+            case CommandType::Spawn:
+                Spawn(static_cast<size_t>(command.first), static_cast<size_t>(command.second));
+                break;
+            case CommandType::Merge:
+                MergeStorm(static_cast<size_t>(command.first));
+                break;
+            case CommandType::Delete:
+                BulkDelete(command.first);
+                break;
+            case CommandType::End:
+                mGame->Quit();
+                break;
+        }
+    }
+}
+
+void Scenario::RecordFrame(uint32_t frame, double updateMs, double drawMs)
+{
+    if (!mMetrics.is_open())
+    {
+        return;
+    }
+
+    char row[128];
+    std::snprintf(row, sizeof(row), "%u,%zu,%zu,%.3f,%.3f,%zu\n", frame, mGame->GetActors().size(),
+                  mGame->GetAwakeActorCount(), updateMs, drawMs, GetResidentKiB());
+    mMetrics << row;
+}
+
+void Scenario::Spawn(size_t count, size_t nameCount)
+{
+    nameCount = std::max<size_t>(nameCount, 1);
+    while (mNames.size() < nameCount)
+    {
+        mNames.push_back(StringTable::Get().Intern(MakeName()));
+    }
+
+    std::uniform_real_distribution<float> x(mArena.min.x, mArena.max.x);
+    std::uniform_real_distribution<float> y(mArena.min.y, mArena.max.y);
+    std::uniform_real_distribution<float> speed(-mMaxSpeed, mMaxSpeed);
+    std::uniform_int_distribution<size_t> name(0, nameCount - 1);
+    for (size_t i = 0; i < count; i++)
+    {
+        TextActor* tile = mGame->SpawnElement(mNames[name(mRandom)], Vector2(x(mRandom), y(mRandom)));
+        if (mMaxSpeed > 0.0f)
+        {
+            tile->AddComponent<MotionComponent>(Vector2(speed(mRandom), speed(mRandom)), mArena);
+        }
+    }
+}
+
+void Scenario::MergeStorm(size_t pairs)
+{
+    const std::vector<std::unique_ptr<Actor>>& actors = mGame->GetActors();
+    if (actors.size() < 2)
+    {
+        return;
+    }
+
+    // Go through the same drop path as the mouse, so known recipes merge at
+    // once and unknown pairs queue on the resolver
+    std::uniform_int_distribution<size_t> pick(0, actors.size() - 1);
+    for (size_t i = 0; i < pairs; i++)
+    {
+        TextActor* first = dynamic_cast<TextActor*>(actors[pick(mRandom)].get());
+        TextActor* second = dynamic_cast<TextActor*>(actors[pick(mRandom)].get());
+        if (!first || !second || first == second || first->GetState() != ActorState::Active ||
+            second->GetState() != ActorState::Active || first->IsPending() || second->IsPending())
+        {
+            continue;
+        }
+        first->SetPosition(second->GetPosition());
+        mGame->OnActorDropped(first);
+    }
+}
+
+void Scenario::BulkDelete(double fraction)
+{
+    std::bernoulli_distribution chosen(Math::Clamp(fraction, 0.0, 1.0));
+    for (const std::unique_ptr<Actor>& actor : mGame->GetActors())
+    {
+        TextActor* tile = dynamic_cast<TextActor*>(actor.get());
+        // Pending tiles are still referenced by their merge
+        if (tile && !tile->IsPending() && chosen(mRandom))
+        {
+            tile->SetState(ActorState::Destroy);
+        }
+    }
+}
+
+std::string Scenario::MakeName()
+{
+    const char* onsets[] = { "T", "V", "Gr", "M", "S", "Fl", "K", "Br", "L", "N", "Qu", "Z" };
+    const char* vowels[] = { "a", "e", "i", "o", "u", "ae", "ou" };
+    const char* codas[] = { "", "n", "r", "l", "st", "th", "m" };
+
+    std::uniform_int_distribution<int> syllables(2, 4);
+    std::string name;
+    int count = syllables(mRandom);
+    for (int i = 0; i < count; i++)
+    {
+        std::string onset = onsets[mRandom() % 12];
+        if (i > 0)
+        {
+            onset[0] = static_cast<char>(onset[0] - 'A' + 'a');
+        }
+        name += onset;
+        name += vowels[mRandom() % 7];
+        name += codas[mRandom() % 7];
+    }
+    return name;
+}
+
+size_t Scenario::GetResidentKiB()
+{
+    std::ifstream statm("/proc/self/statm");
+    size_t totalPages = 0;
+    size_t residentPages = 0;
+    if (!(statm >> totalPages >> residentPages))
+    {
+        return 0;
+    }
+    return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE)) / 1024;
+}
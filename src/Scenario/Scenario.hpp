@@ -0,0 +1,81 @@
+// ----------------------------------------------------------------
+// Scenario: scripted stress sessions for scaling tests
+//
+// A script is a list of timed commands, one per line:
+//   <frame> <command> [arguments]       # comments allowed
+//
+//   arena <width> <height>   area used by later spawns (centered on 0,0)
+//   motion <maxSpeed>        later spawns drift at up to maxSpeed units/s (0 = still)
+//   spawn <count> [names]    spawn tiles with random names drawn from a
+//                            pool of `names` generated names (default count / 4)
+//   merge <pairs>            drop that many random tiles onto others
+//   delete <fraction>        destroy that fraction of the tiles
+//   end                      quit the game
+//
+// Every frame's update time, draw time, actor count (total and
+// awake) and resident memory are appended to a CSV file.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../Math.h"
+#include "../Core/StringTable/StringTable.hpp"
+
+class Scenario
+{
+public:
+    Scenario(class Game* game, uint32_t seed = 1);
+
+    bool LoadScript(const std::string& path);
+    // CSV with one row per frame; returns false if the file can't be created
+    bool OpenMetrics(const std::string& path);
+
+    // Run the commands scheduled for this frame
+    void Update(uint32_t frame);
+    // Append a metrics row for the frame that just finished
+    void RecordFrame(uint32_t frame, double updateMs, double drawMs);
+
+private:
+    enum class CommandType
+    {
+        Arena,
+        Motion,
+        Spawn,
+        Merge,
+        Delete,
+        End
+    };
+
+    struct Command
+    {
+        uint32_t frame;
+        CommandType type;
+        double first;
+        double second;
+    };
+
+    void Spawn(size_t count, size_t nameCount);
+    void MergeStorm(size_t pairs);
+    void BulkDelete(double fraction);
+    // Random pronounceable name, e.g. "Torvala"
+    std::string MakeName();
+    // Resident set size in KiB (0 where unavailable)
+    static size_t GetResidentKiB();
+
+    class Game* mGame;
+    std::mt19937 mRandom;
+
+    std::vector<Command> mCommands;
+    size_t mNextCommand;
+
+    Rect mArena;
+    float mMaxSpeed;
+    // Names used by spawns (grows to the largest requested pool)
+    std::vector<NameId> mNames;
+
+    std::ofstream mMetrics;
+};
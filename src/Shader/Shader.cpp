@@ -1,7 +1,7 @@
 #include "Shader.hpp"
 #include <fstream>
 #include <sstream>
-#include <iostream>
+#include "../Core/Logger/Logger.hpp"
 
 Shader::Shader(const std::string& filepath, GLenum type) {
     std::string code = loadShaderSource(filepath);
@@ -34,6 +34,6 @@ void Shader::compile(const std::string& source, GLenum type) {
     if (!success) {
         char infoLog[512];
         glGetShaderInfoLog(ID, 512, nullptr, infoLog);
-        std::cerr << "Shader compilation error: " << infoLog << std::endl;
+        LOG_ERROR("SHADER", "Shader compilation error: {}", infoLog);
     }
 }
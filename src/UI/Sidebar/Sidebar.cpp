@@ -0,0 +1,275 @@
+// ----------------------------------------------------------------
+// Sidebar implementation
+// ----------------------------------------------------------------
+
+#include "Sidebar.hpp"
+#include "../../Core/TextRenderer/TextRenderer.hpp"
+#include "../../Core/RenderThread/FrameSnapshot.hpp"
+#include "../../Game/Game.hpp"
+#include "../../Core/DamageTracker/DamageTracker.hpp"
+
+namespace
+{
+    const char* ELLIPSIS = "...";
+}
+
+Sidebar::Sidebar(Game* game)
+    : mGame(game)
+    , mFilterDirty(false)
+    , mSynchronousSearch(false)
+    , mViewportWidth(0.0f)
+    , mViewportHeight(0.0f)
+    , mScroll(0.0f)
+    , mTargetScroll(0.0f)
+{
+}
+
+bool Sidebar::AddEntry(NameId name)
+{
+    if (name >= mListed.size())
+    {
+        mListed.resize(static_cast<size_t>(name) + 1, false);
+    }
+    if (mListed[name])
+    {
+        return false;
+    }
+    mListed[name] = true;
+    mEntries.push_back(name);
+    mSearch.Add(name);
+
+    // The new name may match the active filter; requery once per frame
+    if (!mFilter.empty())
+    {
+        mFilterDirty = true;
+    }
+    else
+    {
+        Invalidate();
+    }
+    return true;
+}
+
+void Sidebar::AppendFilter(std::string_view text)
+{
+    mFilter.append(text);
+    OnFilterChanged();
+}
+
+void Sidebar::EraseFilterChar()
+{
+    if (mFilter.empty())
+    {
+        return;
+    }
+
+    // Drop UTF-8 continuation bytes along with their lead byte
+    size_t length = mFilter.size() - 1;
+    while (length > 0 && (static_cast<unsigned char>(mFilter[length]) & 0xC0) == 0x80)
+    {
+        length--;
+    }
+    mFilter.resize(length);
+    OnFilterChanged();
+}
+
+void Sidebar::ClearFilter()
+{
+    if (!mFilter.empty())
+    {
+        mFilter.clear();
+        OnFilterChanged();
+    }
+}
+
+void Sidebar::OnFilterChanged()
+{
+    mFilterDirty = !mFilter.empty();
+    if (mFilter.empty())
+    {
+        mFiltered.clear();
+    }
+    mScroll = 0.0f;
+    mTargetScroll = 0.0f;
+    Invalidate();
+}
+
+void Sidebar::Invalidate()
+{
+    if (mGame)
+    {
+        mGame->GetDamage()->InvalidateAll();
+    }
+}
+
+void Sidebar::SetViewportSize(int width, int height)
+{
+    mViewportWidth = static_cast<float>(width);
+    mViewportHeight = static_cast<float>(height);
+
+    // Enough layouts for every row that can be partially visible
+    size_t poolSize = static_cast<size_t>(mViewportHeight / ROW_HEIGHT) + 2;
+    mRows.assign(poolSize, RowLayout{ SIZE_MAX, INVALID_NAME, 0, false, 0.0f });
+    ClampScroll();
+}
+
+bool Sidebar::Contains(const Vector2& screenPoint) const
+{
+    return screenPoint.x >= mViewportWidth - WIDTH && screenPoint.x <= mViewportWidth &&
+           screenPoint.y >= 0.0f && screenPoint.y <= mViewportHeight;
+}
+
+NameId Sidebar::EntryAt(const Vector2& screenPoint) const
+{
+    if (!Contains(screenPoint))
+    {
+        return INVALID_NAME;
+    }
+
+    float offset = screenPoint.y - GetListTop() + mScroll;
+    if (offset < 0.0f)
+    {
+        return INVALID_NAME;
+    }
+    const std::vector<NameId>& entries = GetListedEntries();
+    size_t entry = static_cast<size_t>(offset / ROW_HEIGHT);
+    return entry < entries.size() ? entries[entry] : INVALID_NAME;
+}
+
+void Sidebar::Scroll(float rows)
+{
+    mTargetScroll += rows * ROW_HEIGHT;
+    ClampScroll();
+}
+
+void Sidebar::Update(float deltaTime)
+{
+    if (mFilterDirty && mSynchronousSearch)
+    {
+        mFilterDirty = false;
+        if (!mFilter.empty())
+        {
+            mSearch.Search(mFilter, MAX_FILTER_RESULTS, mMatches);
+            ShowMatches();
+        }
+    }
+    else if (mFilterDirty)
+    {
+        mSearch.Submit(mFilter, MAX_FILTER_RESULTS);
+        mFilterDirty = false;
+    }
+    // Large queries finish on the search thread; keep the old rows until then
+    if (!mSynchronousSearch && !mFilter.empty() && mSearch.Poll(mMatches))
+    {
+        ShowMatches();
+    }
+
+    if (mScroll == mTargetScroll)
+    {
+        return;
+    }
+    // Exponential ease towards the target, snapping when close
+    float blend = Math::Min(1.0f, deltaTime * 12.0f);
+    mScroll += (mTargetScroll - mScroll) * blend;
+    if (Math::NearlyEqual(mScroll, mTargetScroll, 0.5f))
+    {
+        mScroll = mTargetScroll;
+    }
+    Invalidate();
+}
+
+void Sidebar::ShowMatches()
+{
+    mFiltered.clear();
+    for (const SearchIndex::Match& match : mMatches)
+    {
+        mFiltered.push_back(match.name);
+    }
+    ClampScroll();
+    Invalidate();
+}
+
+bool Sidebar::IsIdle() const
+{
+    // Results of a cleared filter are never polled, so only an active one counts
+    return !mFilterDirty && mScroll == mTargetScroll && (mFilter.empty() || !mSearch.IsQueryPending());
+}
+
+void Sidebar::Draw(DrawList* drawList, const TextRenderer* textRenderer)
+{
+    if (!drawList || !textRenderer || mRows.empty())
+    {
+        return;
+    }
+
+    float left = mViewportWidth - WIDTH + PADDING;
+    float listTop = GetListTop();
+    if (!mFilter.empty())
+    {
+        std::string_view filter(mFilter);
+        size_t fit = textRenderer->FitTextTail(filter, WIDTH - 2.0f * PADDING);
+        // Keep the end of a long filter visible
+        drawList->AddText(filter.substr(filter.size() - fit), Vector2(left, mViewportHeight - ROW_HEIGHT * 0.7f),
+                          1.0f, Vector3(1.0f, 0.85f, 0.4f));
+    }
+
+    const std::vector<NameId>& entries = GetListedEntries();
+    float listHeight = mViewportHeight - listTop;
+    size_t first = static_cast<size_t>(mScroll / ROW_HEIGHT);
+    size_t last = Math::Min(entries.size(), static_cast<size_t>((mScroll + listHeight) / ROW_HEIGHT) + 1);
+
+    for (size_t entry = first; entry < last; entry++)
+    {
+        // Rows are laid out top-down; the screen projection has y up
+        float rowTop = listTop + entry * ROW_HEIGHT - mScroll;
+        if (rowTop < listTop - ROW_HEIGHT * 0.5f)
+        {
+            // Mostly scrolled under the filter line
+            continue;
+        }
+
+        const RowLayout& row = LayoutRow(entry, textRenderer);
+        std::string_view text = StringTable::Get().GetString(row.name);
+        float baseline = mViewportHeight - rowTop - ROW_HEIGHT * 0.7f;
+
+        drawList->AddText(text.substr(0, row.visibleLength), Vector2(left, baseline));
+        if (row.truncated)
+        {
+            drawList->AddText(ELLIPSIS, Vector2(left + row.ellipsisX, baseline));
+        }
+    }
+}
+
+void Sidebar::ClampScroll()
+{
+    float maxScroll = Math::Max(0.0f, GetListedEntries().size() * ROW_HEIGHT - (mViewportHeight - GetListTop()));
+    mTargetScroll = Math::Clamp(mTargetScroll, 0.0f, maxScroll);
+}
+
+const Sidebar::RowLayout& Sidebar::LayoutRow(size_t entry, const TextRenderer* textRenderer)
+{
+    RowLayout& row = mRows[entry % mRows.size()];
+    NameId name = GetListedEntries()[entry];
+    // Filtering reorders rows, so the name must match as well as the index
+    if (row.entry == entry && row.name == name)
+    {
+        return row;
+    }
+
+    // This slot held a row that scrolled away: recycle it
+    row.entry = entry;
+    row.name = name;
+
+    std::string_view text = StringTable::Get().GetString(row.name);
+    float maxWidth = WIDTH - 2.0f * PADDING;
+    size_t fit = textRenderer->FitText(text, maxWidth);
+    row.truncated = fit < text.size();
+    if (row.truncated)
+    {
+        float ellipsisWidth = textRenderer->MeasureText(ELLIPSIS).GetWidth();
+        fit = textRenderer->FitText(text, maxWidth - ellipsisWidth);
+        row.ellipsisX = textRenderer->MeasureText(text.substr(0, fit)).GetWidth();
+    }
+    row.visibleLength = static_cast<uint32_t>(fit);
+    return row;
+}
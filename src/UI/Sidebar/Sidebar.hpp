@@ -0,0 +1,111 @@
+// ----------------------------------------------------------------
+// Sidebar: scrollable list of discovered elements
+//
+// The list is virtualized: only rows inside the viewport are laid
+// out and drawn, and row layouts live in a fixed pool indexed by
+// entry modulo pool size, so a layout is recomputed only when its row
+// scrolls into view. Nothing is allocated per frame.
+//
+// Typing filters the list through a SearchIndex kept in step with
+// AddEntry; while a filter is active the rows show ranked matches.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../../Math.h"
+#include "../../Core/SearchIndex/SearchIndex.hpp"
+#include "../../Core/StringTable/StringTable.hpp"
+
+class Sidebar
+{
+public:
+    Sidebar(class Game* game);
+
+    // Append a discovered element; returns false for names already listed
+    bool AddEntry(NameId name);
+    size_t GetEntryCount() const { return mEntries.size(); }
+
+    // As-you-type filter (UTF-8); results refresh on the next Update
+    void AppendFilter(std::string_view text);
+    // Remove the last character of the filter
+    void EraseFilterChar();
+    void ClearFilter();
+    const std::string& GetFilter() const { return mFilter; }
+    // Run filter queries on the calling thread, so results always show on
+    // the frame after the filter changed (recorded and replayed sessions)
+    void SetSynchronousSearch(bool synchronous) { mSynchronousSearch = synchronous; }
+
+    // Window size in pixels; the sidebar is docked to the right edge
+    void SetViewportSize(int width, int height);
+
+    // Screen-space (SDL, y down) hit-testing
+    bool Contains(const Vector2& screenPoint) const;
+    NameId EntryAt(const Vector2& screenPoint) const;
+
+    // Scroll by a number of rows (positive = down); eased over a few frames
+    void Scroll(float rows);
+
+    void Update(float deltaTime);
+    // True when Update would change nothing (no search or scroll in flight)
+    bool IsIdle() const;
+    // Add the visible rows (screen space) to a frame's overlay; the text
+    // renderer is only used to measure
+    void Draw(class DrawList* drawList, const class TextRenderer* textRenderer);
+
+    static constexpr float WIDTH = 220.0f;
+    static constexpr float ROW_HEIGHT = 28.0f;
+    static constexpr float PADDING = 12.0f;
+    // Upper bound on rows listed for a filter
+    static constexpr size_t MAX_FILTER_RESULTS = 1000;
+
+private:
+    struct RowLayout
+    {
+        // Entry this layout was computed for (SIZE_MAX = none)
+        size_t entry;
+        NameId name;
+        // Bytes of the name drawn before the ellipsis (whole name if it fits)
+        uint32_t visibleLength;
+        bool truncated;
+        float ellipsisX;
+    };
+
+    // Rows currently listed: every entry, or the filter matches
+    const std::vector<NameId>& GetListedEntries() const { return mFilter.empty() ? mEntries : mFiltered; }
+    // Rows start below the filter line while one is shown
+    float GetListTop() const { return mFilter.empty() ? 0.0f : ROW_HEIGHT; }
+
+    void OnFilterChanged();
+    // List the results in mMatches
+    void ShowMatches();
+    // The sidebar changed: the next frame must be drawn
+    void Invalidate();
+    void ClampScroll();
+    const RowLayout& LayoutRow(size_t entry, const class TextRenderer* textRenderer);
+
+    class Game* mGame;
+
+    std::vector<NameId> mEntries;
+    // Indexed by NameId: whether the name is already listed
+    std::vector<bool> mListed;
+
+    SearchIndex mSearch;
+    std::string mFilter;
+    // Filter needs resubmitting (text changed or new entries arrived)
+    bool mFilterDirty;
+    bool mSynchronousSearch;
+    std::vector<NameId> mFiltered;
+    std::vector<SearchIndex::Match> mMatches;
+
+    // Recycled layouts for the rows currently on screen
+    std::vector<RowLayout> mRows;
+
+    float mViewportWidth;
+    float mViewportHeight;
+    float mScroll;
+    float mTargetScroll;
+};
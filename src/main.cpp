@@ -1,12 +1,73 @@
 // ----------------------------------------------------------------
 // Main entry point following the asteroids game architecture
+//
+// Options:
+//   --record <file>   record all input to <file>
+//   --replay <file>   replay input from <file> with a fixed timestep
+//   --frames <n>      quit after n frames
+//   --scenario <file> run a stress scenario script (see Scenario.hpp)
+//   --metrics <file>  write per-frame scenario metrics as CSV
+//   --headless        run without a window (scenarios only need the simulation)
 // ----------------------------------------------------------------
 
 #include "Game/Game.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
 
 int main(int argc, char** argv)
 {
     Game game;
+    InputSystem* input = game.GetInput();
+    std::string scenarioPath;
+    std::string metricsPath;
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--record") == 0 && hasValue)
+        {
+            if (!input->StartRecording(argv[++i]))
+            {
+                return 1;
+            }
+        }
+        else if (std::strcmp(argv[i], "--replay") == 0 && hasValue)
+        {
+            if (!input->StartReplay(argv[++i]))
+            {
+                return 1;
+            }
+        }
+        else if (std::strcmp(argv[i], "--frames") == 0 && hasValue)
+        {
+            input->SetFrameLimit(static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10)));
+        }
+        else if (std::strcmp(argv[i], "--scenario") == 0 && hasValue)
+        {
+            scenarioPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--metrics") == 0 && hasValue)
+        {
+            metricsPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--headless") == 0)
+        {
+            game.SetHeadless(true);
+        }
+        else
+        {
+            std::cout << "Usage: " << argv[0] << " [--record file | --replay file] [--frames n]"
+                      << " [--scenario file [--metrics file]] [--headless]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (!scenarioPath.empty())
+    {
+        game.SetScenario(scenarioPath, metricsPath);
+    }
+
     bool success = game.Initialize();
     if (success)
     {
@@ -0,0 +1,375 @@
+// ----------------------------------------------------------------
+// SaveGame round-trip tests
+//
+// Each case saves into a fresh temporary directory, then loads it back
+// through a new SaveGame the way the game does on startup. Damaged
+// saves are produced by editing the files on disk between the two.
+// ----------------------------------------------------------------
+
+#include "Test.hpp"
+#include "Core/SaveGame/SaveGame.hpp"
+#include "Core/StringTable/StringTable.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+    namespace fs = std::filesystem;
+
+    // Removed with everything in it when the case ends
+    struct TempDirectory
+    {
+        fs::path path;
+
+        TempDirectory()
+        {
+            std::string pattern = (fs::temp_directory_path() / "savegame-test-XXXXXX").string();
+            if (mkdtemp(pattern.data()))
+            {
+                path = pattern;
+            }
+        }
+
+        ~TempDirectory()
+        {
+            std::error_code error;
+            fs::remove_all(path, error);
+        }
+
+        std::string GetSavePath() const { return (path / "save").string(); }
+    };
+
+    // Everything a save holds, in record order
+    struct SaveState
+    {
+        std::vector<SaveGame::RecipeRecord> recipes;
+        std::vector<NameId> discovered;
+        std::vector<SaveGame::TileRecord> tiles;
+    };
+
+    NameId Name(const std::string& text)
+    {
+        return StringTable::Get().Intern(text);
+    }
+
+    SaveState MakeState(size_t recipeCount, size_t discoveryCount, size_t tileCount)
+    {
+        SaveState state;
+        for (size_t i = 0; i < recipeCount; i++)
+        {
+            state.recipes.push_back({ Name("First " + std::to_string(i)), Name("Second " + std::to_string(i)),
+                                      Name("Result " + std::to_string(i)) });
+        }
+        for (size_t i = 0; i < discoveryCount; i++)
+        {
+            state.discovered.push_back(Name("Discovery " + std::to_string(i)));
+        }
+        for (size_t i = 0; i < tileCount; i++)
+        {
+            float f = static_cast<float>(i);
+            state.tiles.push_back({ Name("Tile " + std::to_string(i % 97)), Vector2(f * 3.5f, -f),
+                                    Vector2(1.0f, 1.0f + f * 0.001f), f * 0.01f });
+        }
+        return state;
+    }
+
+    // Record state's progress in save and write it out
+    void Save(SaveGame& save, const SaveState& state)
+    {
+        for (const SaveGame::RecipeRecord& recipe : state.recipes)
+        {
+            save.AddRecipe(recipe.a, recipe.b, recipe.result);
+        }
+        for (NameId name : state.discovered)
+        {
+            save.AddDiscovery(name);
+        }
+        std::vector<SaveGame::TileRecord> board = state.tiles;
+        REQUIRE(save.Autosave(board));
+        save.Wait();
+    }
+
+    bool Load(SaveGame& save, SaveState& outState)
+    {
+        outState = SaveState();
+        if (!save.BeginLoad())
+        {
+            return false;
+        }
+        SaveGame::Chunk chunk;
+        while (save.LoadNextChunk(chunk))
+        {
+            outState.recipes.insert(outState.recipes.end(), chunk.recipes.begin(), chunk.recipes.end());
+            outState.discovered.insert(outState.discovered.end(), chunk.discovered.begin(), chunk.discovered.end());
+            outState.tiles.insert(outState.tiles.end(), chunk.tiles.begin(), chunk.tiles.end());
+        }
+        return true;
+    }
+
+    bool Load(const std::string& directory, SaveState& outState)
+    {
+        SaveGame save(directory);
+        return Load(save, outState);
+    }
+
+    bool SameTile(const SaveGame::TileRecord& a, const SaveGame::TileRecord& b)
+    {
+        return a.name == b.name && a.position.x == b.position.x && a.position.y == b.position.y &&
+               a.scale.x == b.scale.x && a.scale.y == b.scale.y && a.rotation == b.rotation;
+    }
+
+    void CheckSameState(const SaveState& actual, const SaveState& expected)
+    {
+        CHECK_EQUAL(actual.recipes.size(), expected.recipes.size());
+        for (size_t i = 0; i < actual.recipes.size() && i < expected.recipes.size(); i++)
+        {
+            CHECK(actual.recipes[i].a == expected.recipes[i].a && actual.recipes[i].b == expected.recipes[i].b &&
+                  actual.recipes[i].result == expected.recipes[i].result);
+        }
+        CHECK(actual.discovered == expected.discovered);
+        CHECK_EQUAL(actual.tiles.size(), expected.tiles.size());
+        for (size_t i = 0; i < actual.tiles.size() && i < expected.tiles.size(); i++)
+        {
+            if (!SameTile(actual.tiles[i], expected.tiles[i]))
+            {
+                ReportTestFailure(__FILE__, __LINE__, "tile " + std::to_string(i) + " differs");
+                break;
+            }
+        }
+    }
+
+    std::string ReadFile(const fs::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    void WriteFile(const fs::path& path, const std::string& bytes)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    template <typename T>
+    void Append(std::string& bytes, const T& value)
+    {
+        bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    uint64_t Fnv1a(const std::string& bytes)
+    {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (unsigned char c : bytes)
+        {
+            hash ^= c;
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+}
+
+static void SaveGameRoundTrips()
+{
+    TempDirectory directory;
+    REQUIRE(!directory.path.empty());
+
+    // More than one chunk of discoveries and tiles
+    SaveState state = MakeState(100, SaveGame::CHUNK_ITEMS + 10, 5001);
+    {
+        SaveGame save(directory.GetSavePath());
+        Save(save, state);
+    }
+
+    SaveState loaded;
+    REQUIRE(Load(directory.GetSavePath(), loaded));
+    CheckSameState(loaded, state);
+}
+REGISTER_TEST(SaveGameRoundTrips);
+
+static void SaveGameWithoutSaveLoadsNothing()
+{
+    TempDirectory directory;
+    REQUIRE(!directory.path.empty());
+
+    SaveState loaded;
+    CHECK(!Load(directory.GetSavePath(), loaded));
+}
+REGISTER_TEST(SaveGameWithoutSaveLoadsNothing);
+
+static void SaveGameRewritesOnlyChangedChunks()
+{
+    TempDirectory directory;
+    REQUIRE(!directory.path.empty());
+
+    SaveState state = MakeState(10, SaveGame::CHUNK_ITEMS + 10, 5001);
+    SaveGame save(directory.GetSavePath());
+    Save(save, state);
+
+    // One more discovery and one moved tile in the second board chunk
+    SaveState more;
+    more.discovered.push_back(Name("Late discovery"));
+    more.tiles = state.tiles;
+    more.tiles.back().position.x += 1.0f;
+    Save(save, more);
+
+    fs::path saveDirectory = directory.GetSavePath();
+    CHECK(fs::exists(saveDirectory / "discovered_0_1.chunk"));
+    CHECK(fs::exists(saveDirectory / "discovered_1_2.chunk"));
+    CHECK(!fs::exists(saveDirectory / "discovered_1_1.chunk"));
+    CHECK(fs::exists(saveDirectory / "board_0_1.chunk"));
+    CHECK(fs::exists(saveDirectory / "board_1_2.chunk"));
+    CHECK(!fs::exists(saveDirectory / "board_1_1.chunk"));
+    CHECK(fs::exists(saveDirectory / "recipes_0_1.chunk"));
+
+    SaveState expected = state;
+    expected.discovered.push_back(more.discovered.back());
+    expected.tiles = more.tiles;
+    SaveState loaded;
+    REQUIRE(Load(directory.GetSavePath(), loaded));
+    CheckSameState(loaded, expected);
+}
+REGISTER_TEST(SaveGameRewritesOnlyChangedChunks);
+
+static void SaveGameFallsBackWhenNewestGenerationIsTorn()
+{
+    TempDirectory directory;
+    REQUIRE(!directory.path.empty());
+
+    SaveState state = MakeState(10, 50, 5001);
+    {
+        SaveGame save(directory.GetSavePath());
+        Save(save, state);
+    }
+
+    // A crash part-way through writing generation 2: some of its chunk
+    // files exist (one cut short) and the new manifest never got renamed
+    fs::path saveDirectory = directory.GetSavePath();
+    std::string chunk = ReadFile(saveDirectory / "board_0_1.chunk");
+    WriteFile(saveDirectory / "board_0_2.chunk", chunk.substr(0, chunk.size() / 2));
+    WriteFile(saveDirectory / "board_1_2.chunk", "not a chunk");
+    std::string manifest = ReadFile(saveDirectory / "manifest.bin");
+    WriteFile(saveDirectory / "manifest.bin.tmp", manifest.substr(0, manifest.size() - 7));
+
+    SaveState loaded;
+    {
+        SaveGame save(directory.GetSavePath());
+        REQUIRE(Load(save, loaded));
+        CheckSameState(loaded, state);
+
+        // Saving over the torn generation's leftovers still works
+        state.tiles.resize(100);
+        state.tiles[0].position.y = 42.0f;
+        SaveState next;
+        next.tiles = state.tiles;
+        Save(save, next);
+    }
+
+    REQUIRE(Load(directory.GetSavePath(), loaded));
+    CheckSameState(loaded, state);
+}
+REGISTER_TEST(SaveGameFallsBackWhenNewestGenerationIsTorn);
+
+static void SaveGameSkipsCorruptChunk()
+{
+    TempDirectory directory;
+    REQUIRE(!directory.path.empty());
+
+    SaveState state = MakeState(10, 50, 5001);
+    {
+        SaveGame save(directory.GetSavePath());
+        Save(save, state);
+    }
+
+    // Flip a payload byte in the second board chunk
+    fs::path chunkPath = fs::path(directory.GetSavePath()) / "board_1_1.chunk";
+    std::string chunk = ReadFile(chunkPath);
+    REQUIRE(chunk.size() > sizeof(SaveGame::ChunkHeader));
+    chunk[sizeof(SaveGame::ChunkHeader) + 5] ^= 0x40;
+    WriteFile(chunkPath, chunk);
+
+    SaveState loaded;
+    REQUIRE(Load(directory.GetSavePath(), loaded));
+    SaveState expected = state;
+    expected.tiles.resize(SaveGame::CHUNK_ITEMS);
+    CheckSameState(loaded, expected);
+}
+REGISTER_TEST(SaveGameSkipsCorruptChunk);
+
+static void SaveGameStoresLongNames()
+{
+    TempDirectory directory;
+    REQUIRE(!directory.path.empty());
+
+    // Longer than a 16-bit length prefix can describe
+    NameId longName = Name(std::string(70000, 'x'));
+    SaveState state = MakeState(1, 10, 5001);
+    state.tiles[2].name = longName;
+    state.discovered.push_back(longName);
+    state.recipes.push_back({ longName, longName, longName });
+    {
+        SaveGame save(directory.GetSavePath());
+        Save(save, state);
+    }
+
+    SaveState loaded;
+    REQUIRE(Load(directory.GetSavePath(), loaded));
+    CheckSameState(loaded, state);
+    REQUIRE(loaded.tiles.size() > 2);
+    CHECK_EQUAL(StringTable::Get().GetString(loaded.tiles[2].name).size(), static_cast<size_t>(70000));
+}
+REGISTER_TEST(SaveGameStoresLongNames);
+
+static void SaveGameUpgradesVersion1Saves()
+{
+    TempDirectory directory;
+    REQUIRE(!directory.path.empty());
+    fs::path saveDirectory = directory.GetSavePath();
+    fs::create_directory(saveDirectory);
+
+    // Version 1 layout: 16-bit name lengths
+    std::string payload;
+    for (const char* text : { "Steam", "Mud" })
+    {
+        Append(payload, static_cast<uint16_t>(std::char_traits<char>::length(text)));
+        payload += text;
+    }
+    uint64_t checksum = Fnv1a(payload);
+    std::string chunk;
+    Append(chunk, SaveGame::ChunkHeader{ SaveGame::CHUNK_MAGIC, 1, 0, 2, payload.size(), checksum });
+    WriteFile(saveDirectory / "discovered_0_3.chunk", chunk + payload);
+
+    std::string entries;
+    Append(entries, SaveGame::ManifestEntry{ 1, 0, 2, 3, payload.size(), checksum });
+    std::string manifest;
+    Append(manifest, SaveGame::ManifestHeader{ SaveGame::MAGIC, 1, 3, 1, Fnv1a(entries) });
+    WriteFile(saveDirectory / "manifest.bin", manifest + entries);
+
+    SaveState expected;
+    expected.discovered = { Name("Steam"), Name("Mud") };
+    SaveState loaded;
+    {
+        SaveGame save(saveDirectory.string());
+        REQUIRE(Load(save, loaded));
+        CheckSameState(loaded, expected);
+
+        // The next save rewrites the old chunk in the current format
+        Save(save, SaveState());
+    }
+    CHECK(!fs::exists(saveDirectory / "discovered_0_3.chunk"));
+    CHECK(fs::exists(saveDirectory / "discovered_0_4.chunk"));
+
+    SaveGame::ManifestHeader header{};
+    std::string written = ReadFile(saveDirectory / "manifest.bin");
+    REQUIRE(written.size() >= sizeof(header));
+    std::memcpy(&header, written.data(), sizeof(header));
+    CHECK_EQUAL(header.version, SaveGame::VERSION);
+
+    REQUIRE(Load(saveDirectory.string(), loaded));
+    CheckSameState(loaded, expected);
+}
+REGISTER_TEST(SaveGameUpgradesVersion1Saves);
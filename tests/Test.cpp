@@ -0,0 +1,97 @@
+// ----------------------------------------------------------------
+// Test harness implementation and entry point
+// ----------------------------------------------------------------
+
+#include "Test.hpp"
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    struct Case
+    {
+        std::string name;
+        TestFunction function;
+    };
+
+    // Function-local so registrations from any translation unit are safe
+    std::vector<Case>& GetCases()
+    {
+        static std::vector<Case> cases;
+        return cases;
+    }
+
+    // Failures reported by the running case
+    size_t sFailures = 0;
+}
+
+TestRegistration::TestRegistration(const char* name, TestFunction function)
+{
+    GetCases().push_back(Case{ name, function });
+}
+
+void ReportTestFailure(const char* file, int line, const std::string& message)
+{
+    std::printf("  %s:%d: %s\n", file, line, message.c_str());
+    sFailures++;
+}
+
+int RunTests(int argc, char** argv)
+{
+    std::string filter;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else
+        {
+            std::cout << "Usage: " << argv[0] << " [--filter substring]" << std::endl;
+            return 1;
+        }
+    }
+
+    size_t run = 0;
+    size_t failed = 0;
+    for (const Case& test : GetCases())
+    {
+        if (!filter.empty() && test.name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        std::printf("%s\n", test.name.c_str());
+        std::fflush(stdout);
+        sFailures = 0;
+        try
+        {
+            test.function();
+        }
+        catch (const TestAbort&)
+        {
+        }
+        catch (const std::exception& exception)
+        {
+            ReportTestFailure(__FILE__, __LINE__, std::string("unexpected exception: ") + exception.what());
+        }
+
+        run++;
+        if (sFailures > 0)
+        {
+            std::printf("  FAILED\n");
+            failed++;
+        }
+    }
+
+    std::printf("%zu of %zu tests passed\n", run - failed, run);
+    return failed == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv)
+{
+    return RunTests(argc, argv);
+}
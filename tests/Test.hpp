@@ -0,0 +1,84 @@
+// ----------------------------------------------------------------
+// Test: minimal self-contained unit test harness
+//
+// Same shape as the benchmark harness: a case is a function
+// registered at static-initialization time, and the runner executes
+// every case matching the command line. CHECK records a failure and
+// carries on; REQUIRE also ends the case.
+//
+//   static void SomethingRoundTrips()
+//   {
+//       Thing thing = Load(Save(original));
+//       REQUIRE(thing.IsValid());
+//       CHECK_EQUAL(thing.GetCount(), original.GetCount());
+//   }
+//   REGISTER_TEST(SomethingRoundTrips);
+// ----------------------------------------------------------------
+
+#pragma once
+#include <sstream>
+#include <string>
+
+using TestFunction = void (*)();
+
+class TestRegistration
+{
+public:
+    TestRegistration(const char* name, TestFunction function);
+};
+
+// Run every registered case matching the command line; returns the
+// process exit code. Options: --filter <substring>
+int RunTests(int argc, char** argv);
+
+// Record a failed check against the running case
+void ReportTestFailure(const char* file, int line, const std::string& message);
+
+// Thrown by REQUIRE to abandon the running case
+struct TestAbort
+{
+};
+
+template <typename A, typename B>
+std::string DescribeMismatch(const char* expression, const A& actual, const B& expected)
+{
+    std::ostringstream stream;
+    stream << expression << ": got " << actual << ", expected " << expected;
+    return stream.str();
+}
+
+#define CHECK(condition)                                                        \
+    do                                                                          \
+    {                                                                           \
+        if (!(condition))                                                       \
+        {                                                                       \
+            ReportTestFailure(__FILE__, __LINE__, #condition);                  \
+        }                                                                       \
+    } while (0)
+
+#define CHECK_EQUAL(actual, expected)                                           \
+    do                                                                          \
+    {                                                                           \
+        auto&& actual_ = (actual);                                              \
+        auto&& expected_ = (expected);                                          \
+        if (!(actual_ == expected_))                                            \
+        {                                                                       \
+            ReportTestFailure(__FILE__, __LINE__,                               \
+                              DescribeMismatch(#actual, actual_, expected_));   \
+        }                                                                       \
+    } while (0)
+
+#define REQUIRE(condition)                                                      \
+    do                                                                          \
+    {                                                                           \
+        if (!(condition))                                                       \
+        {                                                                       \
+            ReportTestFailure(__FILE__, __LINE__, #condition);                  \
+            throw TestAbort();                                                  \
+        }                                                                       \
+    } while (0)
+
+#define TEST_CONCAT_INNER(a, b) a##b
+#define TEST_CONCAT(a, b) TEST_CONCAT_INNER(a, b)
+#define REGISTER_TEST(function) \
+    static TestRegistration TEST_CONCAT(sRegistration, __LINE__)(#function, function)
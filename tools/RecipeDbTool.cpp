@@ -0,0 +1,115 @@
+// ----------------------------------------------------------------
+// recipedb: converts text recipe files to the binary recipe
+// database format and checks existing database files
+//
+//   recipedb build <recipes.txt> [more.txt ...] <out.rcdb>
+//   recipedb validate <file.rcdb>
+//   recipedb lookup <file.rcdb> <element> <element>
+// ----------------------------------------------------------------
+
+#include "Recipe/RecipeBook.hpp"
+#include "Recipe/RecipeDatabase.hpp"
+#include <iostream>
+#include <string>
+
+namespace
+{
+    int PrintUsage()
+    {
+        std::cerr << "usage:\n"
+                  << "  recipedb build <recipes.txt> [more.txt ...] <out.rcdb>\n"
+                  << "  recipedb validate <file.rcdb>\n"
+                  << "  recipedb lookup <file.rcdb> <element> <element>\n";
+        return 2;
+    }
+
+    int Build(int argc, char** argv)
+    {
+        RecipeBook book;
+        for (int i = 2; i < argc - 1; i++)
+        {
+            if (!book.LoadFromFile(argv[i]))
+            {
+                return 1;
+            }
+        }
+
+        std::string output = argv[argc - 1];
+        if (!RecipeDatabase::Write(book, output))
+        {
+            return 1;
+        }
+
+        RecipeBook::Stats stats = book.GetStats();
+        std::cout << "Wrote " << output << ": " << stats.recipeCount << " recipes" << std::endl;
+        return 0;
+    }
+
+    int Validate(const std::string& path)
+    {
+        RecipeDatabase database;
+        if (!database.Open(path))
+        {
+            std::cerr << path << ": could not open" << std::endl;
+            return 1;
+        }
+
+        std::string error;
+        if (!database.Validate(error))
+        {
+            std::cerr << path << ": invalid: " << error << std::endl;
+            return 1;
+        }
+
+        std::cout << path << ": ok (" << database.GetElementCount() << " elements, "
+                  << database.GetRecipeCount() << " recipes)" << std::endl;
+        return 0;
+    }
+
+    int Lookup(const std::string& path, const std::string& first, const std::string& second)
+    {
+        RecipeDatabase database;
+        if (!database.Open(path))
+        {
+            std::cerr << path << ": could not open" << std::endl;
+            return 1;
+        }
+
+        ElementId a = database.FindElement(first);
+        ElementId b = database.FindElement(second);
+        ElementId result = (a != INVALID_ELEMENT && b != INVALID_ELEMENT)
+            ? database.Combine(a, b)
+            : INVALID_ELEMENT;
+        if (result == INVALID_ELEMENT)
+        {
+            std::cout << first << " + " << second << " = (unknown)" << std::endl;
+            return 1;
+        }
+
+        std::cout << first << " + " << second << " = " << database.GetName(result) << std::endl;
+        return 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        return PrintUsage();
+    }
+
+    std::string command = argv[1];
+    if (command == "build" && argc >= 4)
+    {
+        return Build(argc, argv);
+    }
+    if (command == "validate" && argc == 3)
+    {
+        return Validate(argv[2]);
+    }
+    if (command == "lookup" && argc == 5)
+    {
+        return Lookup(argv[2], argv[3], argv[4]);
+    }
+    return PrintUsage();
+}